@@ -14,6 +14,7 @@
  */
 
 #include "./TaskB.h"
+#include <algorithm>
 #include "JPetWriter/JPetWriter.h"
 
 //ClassImp(TaskB);
@@ -29,56 +30,93 @@ void TaskB::init(const JPetTaskInterface::Options& opts)
 					    "Single threshold multipicity within single time window",
 					    10, -0.5, 9.5)
 				   );
+  getStatistics().createCounter("No. SigChs with unknown DAQ channel");
+
+  // the DAQ channels are bounded by the TOMB channels of the param bank, as in TaskB1 of LargeBarrelAnalysis
+  unsigned int maxChannel = 0;
+  for (auto& tomb : getParamBank().getTOMBChannels()) {
+    maxChannel = std::max(maxChannel, tomb.second->getChannel());
+  }
+  auto nChannels = getParamBank().getTOMBChannels().empty() ? 0 : maxChannel + 1;
+  fChannelStamps.assign(nChannels, 0);
+  fChannelMultiplicities.assign(nChannels, 0);
 }
 
 
 void TaskB::exec()
 {
-  auto tslotRaw = (JPetTimeWindow&) (*getEvent());
+  // the window read from the input file is calibrated in place and written out,
+  // so neither the window nor its SigCh-s are copied
+  auto tslot = dynamic_cast<JPetTimeWindow*>(getEvent());
+  if (!tslot) {
+    return;
+  }
 
   // get number of SigCh-s in a tslot
-  auto nSigChs = tslotRaw.getNumberOfSigCh();
-  // create an object for the CALIBRATED tslot
-  JPetTimeWindow tslotCal;
-  tslotCal.setIndex(tslotRaw.getIndex());
+  auto nSigChs = tslot->getNumberOfSigCh();
 
   // we would like to check if a signal from one DAQ channel can occur more than once
-  // during one Time Slot, so we will create a map(channel, No. of occurences) to count multiplicities
-  std::map<int,int> channelMultiplicities;
+  // during one Time Slot, so we count the occurences of every channel
+  fGeneration++;
+  fFiredChannels.clear();
 
   // iterate over SigCh's in the tslot and calibrate their times
-  for (int i = 0; i < nSigChs; i++) {
-    JPetSigCh sigchRaw = tslotRaw[i];
-    JPetSigCh sigchCal = sigchRaw; // start the calibrated SigCh as a copy of the raw one
+  for (auto i = 0u; i < nSigChs; i++) {
+    // the SigCh-s are owned by the window, which is not const
+    JPetSigCh& sigch = const_cast<JPetSigCh&>((*tslot)[i]);
 
     // do our multiplicity counting
-    channelMultiplicities[sigchRaw.getDAQch()]++;
+    countChannel(sigch.getDAQch());
 
     // a dummy "calibration" example; real calibration should go here
-    float time = sigchRaw.getValue();
+    float time = sigch.getValue();
     time = time * 1.0 + 0.0;
-    // set time after calibration in the new SigCh object
-    sigchCal.setValue(time);
+    // set time after calibration in the same SigCh object
+    sigch.setValue(time);
+  }
+  saveTimeWindow(*tslot);
 
-    // insert the calibrated SigCh into calibrated TimeWindow
-    tslotCal.addCh(sigchCal);
+  fillMultiplicities();
+}
+
+void TaskB::countChannel(int daqChannel)
+{
+  if (daqChannel < 0 || static_cast<unsigned int>(daqChannel) >= fChannelStamps.size()) {
+    // e.g. a negative channel of a SigCh without TOMB channel
+    getStatistics().getCounter("No. SigChs with unknown DAQ channel")++;
+    return;
   }
-  saveTimeWindow(tslotCal);
-  
-  // write all non-zero multiplicities to a histogram
-  for (std::map<int,int>::iterator it=channelMultiplicities.begin(); it!=channelMultiplicities.end(); ++it){
-    if( it->second > 0 ){
-      getStatistics().getHisto1D("single threshold multiplicity").Fill(it->second);
-    }
+  if (fChannelStamps[daqChannel] != fGeneration) {
+    // first occurence of this channel in the current time window
+    fChannelStamps[daqChannel] = fGeneration;
+    fChannelMultiplicities[daqChannel] = 0;
+    fFiredChannels.push_back(daqChannel);
+  }
+  fChannelMultiplicities[daqChannel]++;
+}
+
+void TaskB::fillMultiplicities()
+{
+  // write all non-zero multiplicities to a histogram at once
+  fMultiplicityValues.clear();
+  for (auto channel : fFiredChannels) {
+    fMultiplicityValues.push_back(fChannelMultiplicities[channel]);
+  }
+  if (!fMultiplicityValues.empty()) {
+    getStatistics().getHisto1D("single threshold multiplicity").FillN(
+      fMultiplicityValues.size(), fMultiplicityValues.data(), nullptr);
   }
-  
 }
 
 void TaskB::terminate()
 {
+  if (getStatistics().getCounter("No. SigChs with unknown DAQ channel") > 0) {
+    WARNING(Form("%d SigChs with a DAQ channel unknown to the param bank were not counted in the multiplicities.",
+                 static_cast<int>(getStatistics().getCounter("No. SigChs with unknown DAQ channel"))));
+  }
 }
 
-void TaskB::saveTimeWindow( JPetTimeWindow slot)
+void TaskB::saveTimeWindow(const JPetTimeWindow& slot)
 {
   assert(fWriter);
   fWriter->write(slot);
@@ -45,11 +45,23 @@ public:
   }
 protected:
 
-  void saveTimeWindow( JPetTimeWindow slot);
+  void saveTimeWindow(const JPetTimeWindow& slot);
+  void countChannel(int daqChannel);
+  void fillMultiplicities();
 
   JPetWriter* fWriter;
   JPetParamManager* fParamManager;
 
+  // multiplicities of the DAQ channels in the current time window, indexed by DAQ channel
+  // up to the largest TOMB channel of the param bank;
+  // an entry is valid only if its stamp equals the generation of the current window,
+  // so the arrays never need to be cleared
+  std::vector<unsigned int> fChannelStamps;
+  std::vector<int> fChannelMultiplicities;
+  std::vector<unsigned int> fFiredChannels;
+  std::vector<double> fMultiplicityValues;
+  unsigned int fGeneration = 0;
+
   //ClassDef(TaskB, 1);
 };
 #endif /*  !TASKB_H */
@@ -16,8 +16,6 @@
 #include "./TaskC1.h"
 #include "JPetWriter/JPetWriter.h"
 
-#include <unordered_map>
-
 //ClassImp(TaskC1);
 
 TaskC1::TaskC1(const char * name, const char * description):
@@ -41,23 +39,31 @@ void TaskC1::init(const JPetTaskInterface::Options& opts)
 void TaskC1::exec()
 {
   // A dummy analysis example:
-  auto tslot = (JPetTimeWindow&) (*getEvent());
-  std::unordered_map<int,JPetRawSignal> signals; // map PMT number to RawSignal
+  auto tslot = dynamic_cast<const JPetTimeWindow*const>(getEvent());
+  if (!tslot) {
+    return;
+  }
+  // signals from the previous time window are cleared, but not deallocated
+  resetPooledSignals();
 
   // get number of SigCh's in a tslot
-  const auto nSigChs = tslot.getNumberOfSigCh();
+  const auto nSigChs = tslot->getNumberOfSigCh();
   // iterate over SigCh's in the Tslot and join them in signals
-  for (auto i = 0; i < nSigChs; i++) {
-    JPetSigCh sigch = tslot[i];
+  for (auto i = 0u; i < nSigChs; i++) {
+    const JPetSigCh& sigch = (*tslot)[i];
 
-    signals[sigch.getPM().getID()].addPoint(sigch);
+    if (auto signal = getPooledSignal(sigch.getPM().getID())) {
+      signal->addPoint(sigch);
+    } else {
+      getStatistics().getCounter("No. SigChs without PM")++;
+    }
   }
 
   int nPMs = 0;
 
 
-  for (auto & pmSignalPair : signals) {
-    JPetRawSignal sig = pmSignalPair.second;
+  for (auto pmID : fTouchedPMs) {
+    JPetRawSignal& sig = fSignalPool[pmID];
 
     if (sig.getNumberOfPoints(JPetSigCh::Leading) == 0
         && sig.getNumberOfPoints(JPetSigCh::Trailing) == 0) { //skip empty signals
@@ -65,8 +71,8 @@ void TaskC1::exec()
     }
     nPMs++; // count how many PM-s fired in one TimeWindow
 
-    sig.setTimeWindowIndex(tslot.getIndex());
-    sig.setPM(getParamBank().getPM(pmSignalPair.first));
+    sig.setTimeWindowIndex(tslot->getIndex());
+    sig.setPM(getParamBank().getPM(pmID));
 
     // keep some statistics
     getStatistics().getHisto1D("No. leading points").Fill(sig.getNumberOfPoints(JPetSigCh::Leading));
@@ -94,8 +100,33 @@ void TaskC1::terminate()
 {
 }
 
+JPetRawSignal* TaskC1::getPooledSignal(int pmID)
+{
+  if (pmID < 0) {
+    return nullptr;
+  }
+  if (pmID >= static_cast<int>(fSignalPool.size())) {
+    fSignalPool.resize(pmID + 1);
+    fIsTouched.resize(pmID + 1, false);
+  }
+  if (!fIsTouched[pmID]) {
+    fIsTouched[pmID] = true;
+    fTouchedPMs.push_back(pmID);
+  }
+  return &fSignalPool[pmID];
+}
+
+void TaskC1::resetPooledSignals()
+{
+  for (auto pmID : fTouchedPMs) {
+    // copy assignment of an empty signal keeps the capacity of the containers
+    fSignalPool[pmID] = fEmptySignal;
+    fIsTouched[pmID] = false;
+  }
+  fTouchedPMs.clear();
+}
 
-void TaskC1::saveRawSignal( JPetRawSignal sig)
+void TaskC1::saveRawSignal(const JPetRawSignal& sig)
 {
   assert(fWriter);
   fWriter->write(sig);
@@ -43,11 +43,22 @@ public:
     return fParamManager->getParamBank();
   }
 protected:
-  void saveRawSignal( JPetRawSignal sig);
+  void saveRawSignal(const JPetRawSignal& sig);
+  /// Signal of the PM in the pool; nullptr for a negative ID (SigCh without a PM)
+  JPetRawSignal* getPooledSignal(int pmID);
+  void resetPooledSignals();
 
   JPetWriter* fWriter;
   JPetParamManager* fParamManager;
 
+  /// Signals indexed by PM ID, reused in every time window, so their
+  /// containers of points keep the memory allocated in the previous windows.
+  std::vector<JPetRawSignal> fSignalPool;
+  /// IDs of PMs with points in the current time window, in the order of their first point
+  std::vector<int> fTouchedPMs;
+  std::vector<bool> fIsTouched;
+  const JPetRawSignal fEmptySignal;
+
   //ClassDef(TaskC1, 1);
 };
 #endif /*  !TASKC1_H */
@@ -15,6 +15,7 @@
 
 #include "./TaskC2.h"
 #include "JPetWriter/JPetWriter.h"
+#include "RawSignalView.h"
 
 //ClassImp(TaskC2);
 
@@ -48,9 +49,11 @@ JPetRecoSignal TaskC2::createRecoSignal(JPetRawSignal& rawSignal)
   // example dummy analysis - calculate Time Over Threshold:
   
   // first, get vectors of SigCh-s from both edges, sorted by their threshold values
-  std::vector<JPetSigCh> leadingPoints = rawSignal.getPoints(
+  // the view sorts the points once and returns them by reference later
+  RawSignalView view(rawSignal);
+  const std::vector<JPetSigCh>& leadingPoints = view.getPoints(
 							     JPetSigCh::Leading, JPetRawSignal::ByThrValue);
-  std::vector<JPetSigCh> trailingPoints = rawSignal.getPoints(
+  const std::vector<JPetSigCh>& trailingPoints = view.getPoints(
 							      JPetSigCh::Trailing, JPetRawSignal::ByThrValue);
   // if the values of thresholds were not set i the database, you may want to use
   // JPetRawSignal::ByThrNum option instead which will sort the SigCh-s by the number
@@ -86,10 +89,10 @@ JPetRecoSignal TaskC2::createRecoSignal(JPetRawSignal& rawSignal)
   // one more silly example - calculate time at arbitrary threshold by "interpolation"
   // between lowest and second-lowest threshold measured by DAQ on leading edge
   double thr1, thr2;
-  t1 = rawSignal.getPoints(JPetSigCh::Leading, JPetRawSignal::ByThrValue).at(0).getValue();
-  thr1 = rawSignal.getPoints(JPetSigCh::Leading, JPetRawSignal::ByThrValue).at(0).getThreshold();
-  t2 = rawSignal.getPoints(JPetSigCh::Leading, JPetRawSignal::ByThrValue).at(1).getValue();
-  thr2 = rawSignal.getPoints(JPetSigCh::Leading, JPetRawSignal::ByThrValue).at(1).getThreshold();
+  t1 = leadingPoints.at(0).getValue();
+  thr1 = leadingPoints.at(0).getThreshold();
+  t2 = leadingPoints.at(1).getValue();
+  thr2 = leadingPoints.at(1).getThreshold();
 
   recoSignal.setRecoTimeAtThreshold((thr1+thr2)/2., (t1+t2)/2. );
   //recoSignal.setRecoTimeAtThreshold(10., 20. );
@@ -16,16 +16,24 @@
 #include "./TaskD.h"
 #include "JPetWriter/JPetWriter.h"
 #include <iostream>
+#include <limits>
 
 //ClassImp(TaskD);
 
 TaskD::TaskD(const char * name, const char * description):
-  JPetTask(name, description)
+  WindowBatchTask(name, description)
 {
 }
 
 void TaskD::init(const JPetTaskInterface::Options& opts)
 {
+  WindowBatchTask::init(opts);
+  // every window is matched at once, it is already buffered by WindowBatchTask
+  fSignalJoin.reset(new StreamingWindowJoin<JPetPhysSignal>(
+    std::numeric_limits<double>::infinity(), std::numeric_limits<std::size_t>::max(),
+    [this](const JPetPhysSignal& signalA, const JPetPhysSignal& signalB) {
+      createHit(signalA, signalB);
+    }));
   getStatistics().createHistogram( new TH1F("No. signals in TSlot", "Signals multiplicity per TSlot", 10,
 					    -0.5, 9.5) );
   getStatistics().createHistogram( new TH1F("Scins multiplicity", "scintillators multiplicity", 65, 5.5,
@@ -45,79 +53,75 @@ void TaskD::init(const JPetTaskInterface::Options& opts)
 }
 
 
-void TaskD::exec()
+std::vector<JPetHit> TaskD::processWindow(const std::vector<JPetPhysSignal>& signals)
 {
   // A dummy analysis example:
-  JPetPhysSignal currSignal = (JPetPhysSignal&) (*getEvent());
-  
   // increment the counter of signals
-  getStatistics().getCounter("No. initial signals")++;
-
-  if (fSignals.empty()) {
-    fSignals.push_back(currSignal);
-  } else {
-    if (fSignals[0].getTimeWindowIndex() == currSignal.getTimeWindowIndex()) {
-      fSignals.push_back(currSignal);
-    } else {
-      getStatistics().getHisto1D("No. signals in TSlot").Fill(fSignals.size());
-      saveHits(createHits(fSignals)); //create LORs from previously saved signals
-      fSignals.clear();
-      fSignals.push_back(currSignal);
-    }
-  }
+  getStatistics().getCounter("No. initial signals") += signals.size();
+  getStatistics().getHisto1D("No. signals in TSlot").Fill(signals.size());
+  return createHits(signals); //create hits from the signals of one time window
 }
 
-std::vector<JPetHit> TaskD::createHits(std::vector<JPetPhysSignal>& signals)
+void TaskD::commitWindow(std::vector<JPetHit>& hits)
 {
-  std::vector<JPetHit> hits;
-  for (auto i = signals.begin(); i != signals.end(); ++i) {
-    for (auto j = i; ++j != signals.end(); /**/) {
-      if (i->getPM().getScin() == j->getPM().getScin()) {
-        // found 2 signals from the same scintillator
-        JPetHit hit;
-        if (i->getPM().getSide() == JPetPM::SideA
-            && j->getPM().getSide() == JPetPM::SideB) {
-          hit.setSignalA(*i);
-          hit.setSignalB(*j);
-        } else if (j->getPM().getSide() == JPetPM::SideA
-                   && i->getPM().getSide() == JPetPM::SideB) {
-          hit.setSignalA(*j);
-          hit.setSignalB(*i);
-        } else {
-          WARNING("TWO hits on the same scintillator side we ignore it");
-          // if two hits on the same side, ignore
-          continue;
-        }
-
-        hit.setScintillator(i->getPM().getScin());
-
-        getStatistics().getHisto1D("Scins multiplicity").Fill((*i).getPM().getScin().getID());
-
-        double dt = hit.getSignalA().getTime() - hit.getSignalB().getTime();
-        hit.setTimeDiff(dt);
-
-        double t = 0.5
-                   * (hit.getSignalA().getTime() + hit.getSignalB().getTime());
-        hit.setTime(t);
-
-	// fill the appropriate dt histogram for this scintillator                                                   
-	getStatistics().getHisto1D( 
-				   Form("dt for scin %d", hit.getScintillator().getID())
-				    ).Fill(hit.getTimeDiff());
-
-
-        hits.push_back(hit);
-	// increment the counter of found hits
-	getStatistics().getCounter("No. found hits")++;
-      }
+  saveHits(hits);
+}
+
+std::vector<JPetHit> TaskD::createHits(const std::vector<JPetPhysSignal>& signals)
+{
+  // only signals from the opposite sides of the same scintillator are paired
+  auto sameSidePairs = fSignalJoin->getSameSidePairCount();
+  for (const auto& signal : signals) {
+    auto side = signal.getPM().getSide();
+    if (side == JPetPM::SideA || side == JPetPM::SideB) {
+      fSignalJoin->add(0, signal.getPM().getScin().getID(), side == JPetPM::SideA,
+                       signal.getTime(), signal);
     }
   }
+  fSignalJoin->flush();
+  sameSidePairs = fSignalJoin->getSameSidePairCount() - sameSidePairs;
+  if (sameSidePairs > 0) {
+    // if two hits on the same side, ignore
+    WARNING(Form("%d pairs of hits on the same scintillator side, we ignore them",
+                 static_cast<int>(sameSidePairs)));
+  }
+  std::vector<JPetHit> hits;
+  hits.swap(fHits);
   return hits;
 }
 
+void TaskD::createHit(const JPetPhysSignal& signalA, const JPetPhysSignal& signalB)
+{
+  // found 2 signals from the same scintillator
+  JPetHit hit;
+  hit.setSignalA(signalA);
+  hit.setSignalB(signalB);
+
+  hit.setScintillator(signalA.getPM().getScin());
+
+  getStatistics().getHisto1D("Scins multiplicity").Fill(signalA.getPM().getScin().getID());
+
+  double dt = hit.getSignalA().getTime() - hit.getSignalB().getTime();
+  hit.setTimeDiff(dt);
+
+  double t = 0.5
+             * (hit.getSignalA().getTime() + hit.getSignalB().getTime());
+  hit.setTime(t);
+
+  // fill the appropriate dt histogram for this scintillator
+  getStatistics().getHisto1D(
+                             Form("dt for scin %d", hit.getScintillator().getID())
+                            ).Fill(hit.getTimeDiff());
+
+
+  fHits.push_back(hit);
+  // increment the counter of found hits
+  getStatistics().getCounter("No. found hits")++;
+}
+
 void TaskD::terminate()
 {
-  //  saveHits(createHits(fSignals)); //if there is something left
+  WindowBatchTask::terminate(); //the last time window is processed here
   INFO( Form("From %d initial signals %d hits were paired.", 
 	     static_cast<int>(getStatistics().getCounter("No. initial signals")),
 	     static_cast<int>(getStatistics().getCounter("No. found hits")) )
@@ -125,10 +129,10 @@ void TaskD::terminate()
 }
 
 
-void TaskD::saveHits(std::vector<JPetHit> hits)
+void TaskD::saveHits(const std::vector<JPetHit>& hits)
 {
   assert(fWriter);
-  for (auto hit : hits) { 
+  for (const auto& hit : hits) {
     fWriter->write(hit);
   }
 }
@@ -16,26 +16,34 @@
 #ifndef TASKD_H 
 #define TASKD_H 
 
-#include "JPetTask/JPetTask.h"
+#include <memory>
 #include "JPetHit/JPetHit.h"
 #include "JPetPhysSignal/JPetPhysSignal.h"
+#include "StreamingWindowJoin.h"
+#include "WindowBatchTask.h"
 
 class JPetWriter;
 
-class TaskD:public JPetTask {
+// the signals are delivered to processWindow() per time window by WindowBatchTask
+class TaskD:public WindowBatchTask<JPetPhysSignal, std::vector<JPetHit>> {
  public:
   TaskD(const char * name, const char * description);
   virtual void init(const JPetTaskInterface::Options& opts);
-  virtual void exec();
   virtual void terminate();
   virtual void setWriter(JPetWriter* writer) {fWriter =writer;}
  protected:
-  std::vector<JPetHit> createHits(std::vector<JPetPhysSignal>& signals);
-  void saveHits(std::vector<JPetHit> hits);
+  virtual std::vector<JPetHit> processWindow(const std::vector<JPetPhysSignal>& signals);
+  virtual void commitWindow(std::vector<JPetHit>& hits);
+  std::vector<JPetHit> createHits(const std::vector<JPetPhysSignal>& signals);
+  void createHit(const JPetPhysSignal& signalA, const JPetPhysSignal& signalB);
+  void saveHits(const std::vector<JPetHit>& hits);
   // for statistics of the processing:
   int fInitialSignals;
   int fPairsFound;
-  std::vector<JPetPhysSignal> fSignals;
+  // signals of a time window keyed on scintillator ID, side A on the left;
+  // all the pairs of sides A and B of a scintillator are matched
+  std::unique_ptr<StreamingWindowJoin<JPetPhysSignal>> fSignalJoin;
+  std::vector<JPetHit> fHits;
   
   JPetWriter* fWriter;
 
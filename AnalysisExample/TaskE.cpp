@@ -19,40 +19,47 @@
 //ClassImp(TaskE);
 
 TaskE::TaskE(const char * name, const char * description):
-  JPetTask(name, description)
+  WindowBatchTask(name, description)
 {
 }
 
 void TaskE::init(const JPetTaskInterface::Options& opts)
 {
+  WindowBatchTask::init(opts);
+  TaskOptions::read(opts, "TaskE_CoincidenceWindow", fCoincidenceWindow);
+  TaskOptions::read(opts, "TaskE_DelayedWindow", fDelayedWindow);
+  fCoincidences = CoincidenceEngine<JPetHit>(fCoincidenceWindow, fDelayedWindow);
+  // geometric prefilter: only hits in different scintillators form a LOR
+  fCoincidences.setFilter([](const JPetHit& first, const JPetHit& second) {
+    return first.getScintillator().getID() != second.getScintillator().getID();
+  });
+
   // initialize some scalar counters
   getStatistics().createCounter("No. initial hits");
   getStatistics().createCounter("No. found LORs");
 }
 
 
-void TaskE::exec()
+long long TaskE::getWindowIndex(const JPetHit& hit) const
+{
+  return hit.getSignalB().getTimeWindowIndex();
+}
+
+std::vector<JPetLOR> TaskE::processWindow(const std::vector<JPetHit>& hits)
 {
   // A dummy analysis example:
-  JPetHit currHit = (JPetHit&) (*getEvent());
-  getStatistics().getCounter("No. initial hits")++;
+  getStatistics().getCounter("No. initial hits") += hits.size();
+  return createLORs(hits); //create LORs from the hits of one time window
+}
 
-  if (fHits.empty()) {
-    fHits.push_back(currHit);
-  } else {
-    if (fHits[0].getTimeWindowIndex() == currHit.getSignalB().getTimeWindowIndex()) {
-      fHits.push_back(currHit);
-    } else {
-      saveLORs(createLORs(fHits)); //create LORs from previously saved signals
-      fHits.clear();
-      fHits.push_back(currHit);
-    }
-  }
+void TaskE::commitWindow(std::vector<JPetLOR>& lors)
+{
+  saveLORs(lors);
 }
 
 void TaskE::terminate()
 {
-  saveLORs(createLORs(fHits)); //if there is something left
+  WindowBatchTask::terminate(); //the last time window is processed here
 
   INFO( Form("From %d initial hits %d LORs were paired.", 
 	     static_cast<int>(getStatistics().getCounter("No. initial hits")),
@@ -60,39 +67,30 @@ void TaskE::terminate()
 	);
 }
 
-std::vector<JPetLOR> TaskE::createLORs(std::vector<JPetHit>& hits)
+std::vector<JPetLOR> TaskE::createLORs(const std::vector<JPetHit>& hits)
 {
   std::vector<JPetLOR> lors;
-  for (auto i = hits.begin(); i != hits.end(); ++i) {
-    for (auto j = i; ++j != hits.end(); /**/) {
-      if (i->getScintillator() != j->getScintillator()) {
-        // found 2 hits in different scintillators -> an event!
+  // hits are compared only with the hits within the coincidence window
+  fCoincidences.findCoincidences(hits, [this, &lors](const JPetHit& first, const JPetHit& second) {
+    // found 2 hits in different scintillators -> an event!
 
-        // create an event object
-        JPetLOR event;
-        // convention: "first hit" is the one with earlier time
-        if (i->getTime() < j->getTime()) {
-          event.setFirstHit(*i);
-          event.setSecondHit(*j);
-        } else {
-
-          event.setFirstHit(*j);
-          event.setSecondHit(*i);
-        }
-        double dt = event.getFirstHit().getTime()
-                    - event.getSecondHit().getTime();
-        event.setTimeDiff(dt);
-        lors.push_back(event);
-	getStatistics().getCounter("No. found LORs")++;
-      }
-    }
-  }
+    // create an event object
+    // convention: "first hit" is the one with earlier time
+    lors.emplace_back();
+    JPetLOR& event = lors.back();
+    event.setFirstHit(first);
+    event.setSecondHit(second);
+    double dt = event.getFirstHit().getTime()
+                - event.getSecondHit().getTime();
+    event.setTimeDiff(dt);
+    getStatistics().getCounter("No. found LORs")++;
+  });
   return lors;
 }
 
-void TaskE::saveLORs(std::vector<JPetLOR> lors)
+void TaskE::saveLORs(const std::vector<JPetLOR>& lors)
 {
-  for (auto lor : lors) {
+  for (const auto& lor : lors) {
     fWriter->write(lor);
   }
 }
@@ -16,26 +16,35 @@
 #ifndef TASKE_H 
 #define TASKE_H 
 
-#include "JPetTask/JPetTask.h"
 #include "JPetHit/JPetHit.h"
 #include "JPetLOR/JPetLOR.h"
+#include "CoincidenceEngine.h"
+#include "WindowBatchTask.h"
 
 class JPetWriter;
 
-class TaskE:public JPetTask {
+// the hits are delivered to processWindow() per time window by WindowBatchTask
+class TaskE:public WindowBatchTask<JPetHit, std::vector<JPetLOR>> {
  public:
   TaskE(const char * name, const char * description);
   virtual void init(const JPetTaskInterface::Options& opts);
-  virtual void exec();
   virtual void terminate();
   virtual void setWriter(JPetWriter* writer) {fWriter =writer;}
  protected:
-  std::vector<JPetLOR> createLORs(std::vector<JPetHit>& hits);
-  void saveLORs(std::vector<JPetLOR> lors);
+  virtual long long getWindowIndex(const JPetHit& hit) const;
+  virtual std::vector<JPetLOR> processWindow(const std::vector<JPetHit>& hits);
+  virtual void commitWindow(std::vector<JPetLOR>& lors);
+  std::vector<JPetLOR> createLORs(const std::vector<JPetHit>& hits);
+  void saveLORs(const std::vector<JPetLOR>& lors);
   // for statistics of the processing:
   int fInitialHits;
   int fPairsFound;
-  std::vector<JPetHit> fHits;
+  // hits are paired only within the coincidence window [ps] (option "TaskE_CoincidenceWindow");
+  // with "TaskE_DelayedWindow" [ps] > 0 the LORs are built from delayed coincidences
+  // to estimate the random ones
+  double fCoincidenceWindow = 10000.;
+  double fDelayedWindow = 0.;
+  CoincidenceEngine<JPetHit> fCoincidences{fCoincidenceWindow};
   
   JPetWriter* fWriter;
 
@@ -0,0 +1,114 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file CoincidenceEngine.h
+ */
+
+#ifndef COINCIDENCEENGINE_H
+#define COINCIDENCEENGINE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Finds pairs of hits (or any objects with getTime()) in time coincidence.
+ *
+ * The hits are sorted by time (only their indices, the hits are not copied) and scanned
+ * with two pointers, so every hit is compared only with the hits within the coincidence
+ * window and the cost scales with the number of coincidences instead of n^2.
+ *
+ * Prompt mode (delay = 0): pairs with |t2 - t1| < window.
+ * Delayed mode (delay > 0): pairs with |t2 - t1 - delay| < window, i.e. coincidences
+ * of a hit with the hits delayed by the given time, used to estimate the random
+ * coincidences. The delay should be at least the window, so the delayed window
+ * does not overlap with the prompt one.
+ *
+ * An optional filter (e.g. a geometric condition on the scintillators of the hits)
+ * is checked for every pair in the time window before the pair is passed on.
+ */
+template<class Hit>
+class CoincidenceEngine
+{
+public:
+  typedef std::function<bool(const Hit& first, const Hit& second)> Filter;
+
+  explicit CoincidenceEngine(double window, double delay = 0.):
+    fWindow(window),
+    fDelay(delay)
+  {
+    /**/
+  }
+
+  void setFilter(Filter filter)
+  {
+    fFilter = filter;
+  }
+  double getWindow() const
+  {
+    return fWindow;
+  }
+  double getDelay() const
+  {
+    return fDelay;
+  }
+
+  /// Calls onPair(first, second) for every coincidence, with first earlier than second,
+  /// ordered by the time of the first and then of the second hit.
+  /// Returns the number of pairs.
+  template<class Callback>
+  std::size_t findCoincidences(const std::vector<Hit>& hits, Callback onPair)
+  {
+    fOrder.resize(hits.size());
+    fTimes.resize(hits.size());
+    for (std::size_t i = 0; i < hits.size(); i++) {
+      fOrder[i] = i;
+    }
+    std::stable_sort(fOrder.begin(), fOrder.end(), [&hits](std::size_t first, std::size_t second) {
+      return hits[first].getTime() < hits[second].getTime();
+    });
+    for (std::size_t i = 0; i < hits.size(); i++) {
+      fTimes[i] = hits[fOrder[i]].getTime();
+    }
+    std::size_t pairs = 0;
+    std::size_t begin = 0;
+    for (std::size_t i = 0; i < hits.size(); i++) {
+      /// the hits too early for this hit are too early for all the next ones
+      if (fDelay > 0.) {
+        while (begin < hits.size() && fTimes[begin] - fTimes[i] <= fDelay - fWindow) {
+          begin++;
+        }
+      } else {
+        begin = i + 1;
+      }
+      for (auto j = std::max(begin, i + 1); j < hits.size() && fTimes[j] - fTimes[i] < fDelay + fWindow; j++) {
+        const Hit& first = hits[fOrder[i]];
+        const Hit& second = hits[fOrder[j]];
+        if (!fFilter || fFilter(first, second)) {
+          onPair(first, second);
+          pairs++;
+        }
+      }
+    }
+    return pairs;
+  }
+
+private:
+  double fWindow;
+  double fDelay;
+  Filter fFilter;
+  /// reused between the calls
+  std::vector<std::size_t> fOrder;
+  std::vector<double> fTimes;
+};
+#endif /*  !COINCIDENCEENGINE_H */
@@ -0,0 +1,80 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE CoincidenceEngine
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "CoincidenceEngine.h"
+
+namespace
+{
+struct TestHit {
+  double fTime;
+  int fScin;
+  double getTime() const
+  {
+    return fTime;
+  }
+};
+
+typedef std::set<std::pair<int, int>> PairSet;
+
+/// pairs of scintillators of the hits (unique in the tests), found by comparing all pairs
+PairSet findAllPairs(const std::vector<TestHit>& hits, double window, double delay)
+{
+  PairSet pairs;
+  for (const auto& first : hits) {
+    for (const auto& second : hits) {
+      if (&first != &second && first.fTime <= second.fTime
+          && std::fabs(second.fTime - first.fTime - delay) < window
+          && first.fScin % 2 != second.fScin % 2) {
+        pairs.insert(std::make_pair(first.fScin, second.fScin));
+      }
+    }
+  }
+  return pairs;
+}
+}
+
+BOOST_AUTO_TEST_SUITE (CoincidenceEngineSuite)
+
+BOOST_AUTO_TEST_CASE (promptWindow)
+{
+  std::vector<TestHit> hits = {{30., 1}, {0., 2}, {12., 3}, {5., 4}, {100., 5}};
+  CoincidenceEngine<TestHit> engine(10.);
+  std::vector<std::pair<int, int>> pairs;
+  auto count = engine.findCoincidences(hits, [&pairs](const TestHit& first, const TestHit& second) {
+    pairs.push_back(std::make_pair(first.fScin, second.fScin));
+  });
+  std::vector<std::pair<int, int>> expected = {{2, 4}, {4, 3}};
+  BOOST_REQUIRE_EQUAL(count, 2u);
+  BOOST_REQUIRE(pairs == expected);
+}
+
+BOOST_AUTO_TEST_CASE (sameAsAllPairs)
+{
+  std::srand(1);
+  std::vector<TestHit> hits;
+  for (int i = 0; i < 500; i++) {
+    hits.push_back(TestHit{std::rand() % 100000 + 0.5 * (std::rand() % 2), i});
+  }
+  for (double delay : {0., 1000., 5000.}) {
+    CoincidenceEngine<TestHit> engine(300., delay);
+    engine.setFilter([](const TestHit& first, const TestHit& second) {
+      return first.fScin % 2 != second.fScin % 2;
+    });
+    PairSet pairs;
+    engine.findCoincidences(hits, [&pairs](const TestHit& first, const TestHit& second) {
+      BOOST_REQUIRE(first.fTime <= second.fTime);
+      pairs.insert(std::make_pair(first.fScin, second.fScin));
+    });
+    auto expected = findAllPairs(hits, 300., delay);
+    BOOST_REQUIRE(!expected.empty());
+    BOOST_REQUIRE(pairs == expected);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
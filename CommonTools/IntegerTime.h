@@ -0,0 +1,54 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file IntegerTime.h
+ */
+
+#ifndef INTEGERTIME_H
+#define INTEGERTIME_H
+
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @brief Times as integer numbers of ps.
+ *
+ * The times are rounded to ps once, when they enter the chain (the TDC times in ns)
+ * or are shifted by a calibration. From then on the sums and differences of the times
+ * are integer operations, so they do not depend on the order of the operations, and
+ * sorting and comparing them is exact.
+ *
+ * The data objects of the framework keep the times as double. Integer times up to
+ * 2^53 ps (about 100 days) are stored there exactly, so toPs(fromPs(t)) gives back
+ * the same integer in every task.
+ */
+namespace IntegerTime
+{
+typedef std::int64_t TimePs;
+
+/// nearest ps
+inline TimePs fromPs(double ps)
+{
+  return std::llround(ps);
+}
+/// nearest ps
+inline TimePs fromNs(double ns)
+{
+  return std::llround(ns * 1000.);
+}
+/// exact for |time| < 2^53 ps
+inline double toPs(TimePs time)
+{
+  return static_cast<double>(time);
+}
+}
+#endif /*  !INTEGERTIME_H */
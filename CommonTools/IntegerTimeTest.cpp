@@ -0,0 +1,29 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE IntegerTime
+#include <boost/test/unit_test.hpp>
+
+#include "IntegerTime.h"
+
+BOOST_AUTO_TEST_SUITE (IntegerTimeSuite)
+
+BOOST_AUTO_TEST_CASE (conversions)
+{
+  BOOST_REQUIRE_EQUAL(IntegerTime::fromNs(-123.4567), -123457);
+  BOOST_REQUIRE_EQUAL(IntegerTime::fromNs(-999999.9994), -999999999);
+  BOOST_REQUIRE_EQUAL(IntegerTime::fromPs(10.5), 11);
+  BOOST_REQUIRE_EQUAL(IntegerTime::fromPs(-10.5), -11);
+  BOOST_REQUIRE_EQUAL(IntegerTime::toPs(-123457), -123457.);
+}
+
+BOOST_AUTO_TEST_CASE (roundTripIsExact)
+{
+  for (IntegerTime::TimePs time : {IntegerTime::TimePs(0), IntegerTime::TimePs(-1000000000),
+                                   IntegerTime::TimePs(1) << 52, -(IntegerTime::TimePs(1) << 53)}) {
+    BOOST_REQUIRE_EQUAL(IntegerTime::fromPs(IntegerTime::toPs(time)), time);
+  }
+  /// the difference of two times does not depend on where they are
+  double shifted = IntegerTime::toPs(IntegerTime::fromNs(-987654.321) - IntegerTime::fromNs(0.4));
+  BOOST_REQUIRE_EQUAL(shifted, -987654721.);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
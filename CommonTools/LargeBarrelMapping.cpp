@@ -0,0 +1,420 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file LargeBarrelMapping.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include "LargeBarrelMapping.h"
+
+namespace
+{
+const char kSnapshotMagic[4] = {'J', 'P', 'L', 'B'};
+const std::uint32_t kSnapshotVersion = 3;
+
+/// Stored is the type of the entries in the snapshot: int32 for the int tables, double for the others
+template<class Stored, class T>
+void writeTable(std::ofstream& file, const std::vector<T>& table)
+{
+  std::uint32_t size = table.size();
+  file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  std::vector<Stored> entries(table.begin(), table.end());
+  file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Stored));
+}
+
+template<class Stored, class T>
+bool readTable(std::ifstream& file, std::vector<T>& table)
+{
+  std::uint32_t size = 0;
+  if (!file.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+    return false;
+  }
+  std::vector<Stored> entries(size);
+  if (!file.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(Stored))) {
+    return false;
+  }
+  table.assign(entries.begin(), entries.end());
+  return true;
+}
+
+/// the values are doubles in the auxilliary data, exact for the int tables
+template<class T>
+void saveTable(JPetAuxilliaryData& auxData, const std::string& mapName, const std::string& name, const std::vector<T>& table)
+{
+  auxData.setValue(mapName, name + "_size", table.size());
+  for (std::size_t i = 0; i < table.size(); i++) {
+    auxData.setValue(mapName, name + "_" + std::to_string(i), table[i]);
+  }
+}
+
+template<class T>
+void loadTable(JPetAuxilliaryData& auxData, const std::string& mapName, const std::string& name, std::vector<T>& table)
+{
+  double size = auxData.getValue(mapName, name + "_size");
+  table.assign(size > 0. ? static_cast<std::size_t>(size) : 0, T());
+  for (std::size_t i = 0; i < table.size(); i++) {
+    table[i] = static_cast<T>(auxData.getValue(mapName, name + "_" + std::to_string(i)));
+  }
+}
+
+template<class T>
+void setEntry(std::vector<T>& table, int index, T value, T missing)
+{
+  if (index < 0) {
+    throw std::out_of_range("LargeBarrelMapping: negative ID");
+  }
+  if (static_cast<std::size_t>(index) >= table.size()) {
+    table.resize(index + 1, missing);
+  }
+  table[index] = value;
+}
+
+void setEntry(std::vector<int>& table, int index, int value)
+{
+  setEntry(table, index, value, -1);
+}
+
+void setEntry(std::vector<double>& table, int index, double value)
+{
+  setEntry(table, index, value, std::numeric_limits<double>::quiet_NaN());
+}
+}
+
+const std::string LargeBarrelMapping::kAuxilliaryDataMapName = "Large Barrel mapping";
+
+LargeBarrelMapping::LargeBarrelMapping() {}
+LargeBarrelMapping::~LargeBarrelMapping() {}
+LargeBarrelMapping::LargeBarrelMapping(const JPetParamBank& paramBank)
+{
+  buildMappings(paramBank);
+}
+
+int LargeBarrelMapping::lookup(const std::vector<int>& table, int index)
+{
+  if (index < 0 || static_cast<std::size_t>(index) >= table.size() || table[index] < 0) {
+    throw std::out_of_range("LargeBarrelMapping: unknown ID");
+  }
+  return table[index];
+}
+
+double LargeBarrelMapping::lookup(const std::vector<double>& table, int index)
+{
+  if (index < 0 || static_cast<std::size_t>(index) >= table.size() || std::isnan(table[index])) {
+    throw std::out_of_range("LargeBarrelMapping: unknown ID");
+  }
+  return table[index];
+}
+
+int LargeBarrelMapping::getNumberOfLayers() const
+{
+  return fNumberOfSlotsInLayer.size();
+}
+int LargeBarrelMapping::getLayerNumber(const JPetLayer& layer) const
+{
+  return lookup(fLayerNumbers, layer.getID());
+}
+int LargeBarrelMapping::getLayerNumberByID(int layerID) const
+{
+  return lookup(fLayerNumbers, layerID);
+}
+int LargeBarrelMapping::getNumberOfSlots(const JPetLayer& layer) const
+{
+  return fNumberOfSlotsInLayer[getLayerNumber(layer) - 1];
+}
+int LargeBarrelMapping::getNumberOfSlots(int layerNumber) const
+{
+  return fNumberOfSlotsInLayer.at(layerNumber - 1);
+}
+int LargeBarrelMapping::getSlotNumber(const JPetBarrelSlot& slot) const
+{
+  return lookup(fSlotNumbers, slot.getID());
+}
+int LargeBarrelMapping::getSlotNumberByID(int slotID) const
+{
+  return lookup(fSlotNumbers, slotID);
+}
+int LargeBarrelMapping::getSlotLayerNumber(int slotID) const
+{
+  return lookup(fSlotLayerNumbers, slotID);
+}
+std::vector<int> LargeBarrelMapping::getSlotIDs(int layerNumber) const
+{
+  std::vector<int> slotIDs(getNumberOfSlots(layerNumber), -1);
+  for (std::size_t id = 0; id < fSlotLayerNumbers.size(); id++) {
+    if (fSlotLayerNumbers[id] == layerNumber) {
+      slotIDs[fSlotNumbers[id] - 1] = id;
+    }
+  }
+  return slotIDs;
+}
+int LargeBarrelMapping::getGlobalPMNumber(const JPetPM& pm) const
+{
+  return getGlobalPMNumber(pm.getBarrelSlot().getID(), pm.getSide());
+}
+int LargeBarrelMapping::getGlobalPMNumber(int slotID, JPetPM::Side side) const
+{
+  int pm_no = lookup(fSlotGlobalPMNumbers, slotID);
+  if (side == JPetPM::SideB) {
+    pm_no += fNumberOfSlotsInLayer[fSlotLayerNumbers[slotID] - 1];
+  }
+  return pm_no;
+}
+int LargeBarrelMapping::getOppositeSlotID(int slotID) const
+{
+  lookup(fSlotNumbers, slotID);
+  return fOppositeSlotIDs[slotID];
+}
+int LargeBarrelMapping::calcDeltaID(const JPetHit& hit1, const JPetHit& hit2) const
+{
+  return calcDeltaID(hit1.getBarrelSlot().getID(), hit2.getBarrelSlot().getID());
+}
+int LargeBarrelMapping::calcDeltaID(int slotID1, int slotID2) const
+{
+  int layer_number = getSlotLayerNumber(slotID1);
+  if (layer_number != getSlotLayerNumber(slotID2)) {
+    return -1;//maybe throwing an exception would be a better solution?
+  }
+  int delta_ID = std::abs(fSlotNumbers[slotID1] - fSlotNumbers[slotID2]);
+  int layer_size = fNumberOfSlotsInLayer[layer_number - 1];
+  int half_layer_size = layer_size / 2;
+  if (delta_ID > half_layer_size) return layer_size - delta_ID;
+  return delta_ID;
+}
+bool LargeBarrelMapping::hasPM(int pmID) const
+{
+  return pmID >= 0 && static_cast<std::size_t>(pmID) < fPMSides.size() && fPMSides[pmID] >= 0;
+}
+JPetPM::Side LargeBarrelMapping::getPMSide(int pmID) const
+{
+  return static_cast<JPetPM::Side>(lookup(fPMSides, pmID));
+}
+int LargeBarrelMapping::getPMScinID(int pmID) const
+{
+  return lookup(fPMScinIDs, pmID);
+}
+int LargeBarrelMapping::getPMSlotID(int pmID) const
+{
+  return lookup(fPMSlotIDs, pmID);
+}
+double LargeBarrelMapping::getSlotX(int slotID) const
+{
+  return lookup(fSlotX, slotID);
+}
+double LargeBarrelMapping::getSlotY(int slotID) const
+{
+  return lookup(fSlotY, slotID);
+}
+
+void LargeBarrelMapping::buildMappings(const JPetParamBank& paramBank)
+{
+  std::vector<LayerGeometry> layers;
+  for (auto& layer : paramBank.getLayers()) {
+    layers.push_back(LayerGeometry{layer.second->getID(), layer.second->getRadius()});
+  }
+  std::vector<SlotGeometry> slots;
+  for (auto& slot : paramBank.getBarrelSlots()) {
+    slots.push_back(SlotGeometry{slot.second->getID(), slot.second->getLayer().getID(), slot.second->getTheta()});
+  }
+  std::vector<PMGeometry> pms;
+  for (auto& pm : paramBank.getPMs()) {
+    pms.push_back(PMGeometry{pm.second->getID(), pm.second->getSide(),
+                             pm.second->getScin().getID(), pm.second->getBarrelSlot().getID()});
+  }
+  buildMappings(layers, slots, pms);
+}
+
+void LargeBarrelMapping::buildMappings(const std::vector<LayerGeometry>& layers, const std::vector<SlotGeometry>& slots,
+                                       const std::vector<PMGeometry>& pms)
+{
+  fLayerNumbers.clear();
+  fNumberOfSlotsInLayer.assign(layers.size(), 0);
+  fSlotLayerNumbers.clear();
+  fSlotNumbers.clear();
+  fSlotGlobalPMNumbers.clear();
+  fOppositeSlotIDs.clear();
+  fSlotX.clear();
+  fSlotY.clear();
+  fPMSides.clear();
+  fPMScinIDs.clear();
+  fPMSlotIDs.clear();
+
+  auto sortedLayers = layers;
+  std::sort(sortedLayers.begin(), sortedLayers.end(), [](const LayerGeometry & first, const LayerGeometry & second) {
+    return first.fRadius < second.fRadius || (first.fRadius == second.fRadius && first.fID < second.fID);
+  });
+  for (std::size_t i = 0; i < sortedLayers.size(); i++) {
+    setEntry(fLayerNumbers, sortedLayers[i].fID, i + 1);
+  }
+
+  auto sortedSlots = slots;
+  std::sort(sortedSlots.begin(), sortedSlots.end(), [](const SlotGeometry & first, const SlotGeometry & second) {
+    return first.fTheta < second.fTheta || (first.fTheta == second.fTheta && first.fID < second.fID);
+  });
+  /// IDs of the slots of every layer in the order of their numbers
+  std::vector<std::vector<int>> slotIDs(layers.size());
+  for (const auto& slot : sortedSlots) {
+    int layer_number = getLayerNumberByID(slot.fLayerID);
+    slotIDs[layer_number - 1].push_back(slot.fID);
+    fNumberOfSlotsInLayer[layer_number - 1]++;
+    setEntry(fSlotLayerNumbers, slot.fID, layer_number);
+    setEntry(fSlotNumbers, slot.fID, static_cast<int>(slotIDs[layer_number - 1].size()));
+    const double radius = sortedLayers[layer_number - 1].fRadius;
+    setEntry(fSlotX, slot.fID, radius * std::cos(slot.fTheta));
+    setEntry(fSlotY, slot.fID, radius * std::sin(slot.fTheta));
+  }
+
+  const int number_of_sides = 2;
+  int first_pm_in_layer = 0;
+  for (std::size_t l = 0; l < slotIDs.size(); l++) {
+    int layer_size = slotIDs[l].size();
+    for (int s = 0; s < layer_size; s++) {
+      int slot_ID = slotIDs[l][s];
+      setEntry(fSlotGlobalPMNumbers, slot_ID, first_pm_in_layer + s);
+      setEntry(fOppositeSlotIDs, slot_ID, layer_size % 2 == 0 ? slotIDs[l][(s + layer_size / 2) % layer_size] : -1);
+    }
+    first_pm_in_layer += number_of_sides * layer_size;
+  }
+
+  for (const auto& pm : pms) {
+    setEntry(fPMSides, pm.fID, static_cast<int>(pm.fSide));
+    setEntry(fPMScinIDs, pm.fID, pm.fScinID);
+    setEntry(fPMSlotIDs, pm.fID, pm.fSlotID);
+  }
+}
+
+bool LargeBarrelMapping::saveSnapshot(const std::string& fileName) const
+{
+  std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    return false;
+  }
+  file.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+  file.write(reinterpret_cast<const char*>(&kSnapshotVersion), sizeof(kSnapshotVersion));
+  writeTable<std::int32_t>(file, fLayerNumbers);
+  writeTable<std::int32_t>(file, fNumberOfSlotsInLayer);
+  writeTable<std::int32_t>(file, fSlotLayerNumbers);
+  writeTable<std::int32_t>(file, fSlotNumbers);
+  writeTable<std::int32_t>(file, fSlotGlobalPMNumbers);
+  writeTable<std::int32_t>(file, fOppositeSlotIDs);
+  writeTable<std::int32_t>(file, fPMSides);
+  writeTable<std::int32_t>(file, fPMScinIDs);
+  writeTable<std::int32_t>(file, fPMSlotIDs);
+  writeTable<double>(file, fSlotX);
+  writeTable<double>(file, fSlotY);
+  return file.good();
+}
+
+bool LargeBarrelMapping::loadSnapshot(const std::string& fileName)
+{
+  std::ifstream file(fileName, std::ios::binary);
+  char magic[sizeof(kSnapshotMagic)];
+  std::uint32_t version = 0;
+  if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, kSnapshotMagic, sizeof(magic)) != 0
+      || !file.read(reinterpret_cast<char*>(&version), sizeof(version)) || version != kSnapshotVersion) {
+    return false;
+  }
+  LargeBarrelMapping loaded;
+  if (!readTable<std::int32_t>(file, loaded.fLayerNumbers)
+      || !readTable<std::int32_t>(file, loaded.fNumberOfSlotsInLayer)
+      || !readTable<std::int32_t>(file, loaded.fSlotLayerNumbers)
+      || !readTable<std::int32_t>(file, loaded.fSlotNumbers)
+      || !readTable<std::int32_t>(file, loaded.fSlotGlobalPMNumbers)
+      || !readTable<std::int32_t>(file, loaded.fOppositeSlotIDs)
+      || !readTable<std::int32_t>(file, loaded.fPMSides)
+      || !readTable<std::int32_t>(file, loaded.fPMScinIDs)
+      || !readTable<std::int32_t>(file, loaded.fPMSlotIDs)
+      || !readTable<double>(file, loaded.fSlotX)
+      || !readTable<double>(file, loaded.fSlotY)
+      || !loaded.isConsistent()) {
+    return false;
+  }
+  *this = loaded;
+  return true;
+}
+
+void LargeBarrelMapping::saveToAuxilliaryData(JPetAuxilliaryData& auxData, const std::string& mapName) const
+{
+  auxData.createMap(mapName);
+  auxData.setValue(mapName, "version", kSnapshotVersion);
+  saveTable(auxData, mapName, "layerNumbers", fLayerNumbers);
+  saveTable(auxData, mapName, "numberOfSlotsInLayer", fNumberOfSlotsInLayer);
+  saveTable(auxData, mapName, "slotLayerNumbers", fSlotLayerNumbers);
+  saveTable(auxData, mapName, "slotNumbers", fSlotNumbers);
+  saveTable(auxData, mapName, "slotGlobalPMNumbers", fSlotGlobalPMNumbers);
+  saveTable(auxData, mapName, "oppositeSlotIDs", fOppositeSlotIDs);
+  saveTable(auxData, mapName, "PMSides", fPMSides);
+  saveTable(auxData, mapName, "PMScinIDs", fPMScinIDs);
+  saveTable(auxData, mapName, "PMSlotIDs", fPMSlotIDs);
+  saveTable(auxData, mapName, "slotX", fSlotX);
+  saveTable(auxData, mapName, "slotY", fSlotY);
+}
+
+bool LargeBarrelMapping::loadFromAuxilliaryData(JPetAuxilliaryData& auxData, const std::string& mapName)
+{
+  if (auxData.getValue(mapName, "version") != kSnapshotVersion) {
+    return false;
+  }
+  LargeBarrelMapping loaded;
+  loadTable(auxData, mapName, "layerNumbers", loaded.fLayerNumbers);
+  loadTable(auxData, mapName, "numberOfSlotsInLayer", loaded.fNumberOfSlotsInLayer);
+  loadTable(auxData, mapName, "slotLayerNumbers", loaded.fSlotLayerNumbers);
+  loadTable(auxData, mapName, "slotNumbers", loaded.fSlotNumbers);
+  loadTable(auxData, mapName, "slotGlobalPMNumbers", loaded.fSlotGlobalPMNumbers);
+  loadTable(auxData, mapName, "oppositeSlotIDs", loaded.fOppositeSlotIDs);
+  loadTable(auxData, mapName, "PMSides", loaded.fPMSides);
+  loadTable(auxData, mapName, "PMScinIDs", loaded.fPMScinIDs);
+  loadTable(auxData, mapName, "PMSlotIDs", loaded.fPMSlotIDs);
+  loadTable(auxData, mapName, "slotX", loaded.fSlotX);
+  loadTable(auxData, mapName, "slotY", loaded.fSlotY);
+  if (loaded.getNumberOfLayers() == 0 || !loaded.isConsistent()) {
+    return false;
+  }
+  *this = loaded;
+  return true;
+}
+
+bool LargeBarrelMapping::loadOrBuildMappings(const JPetParamBank& paramBank, JPetAuxilliaryData& auxData)
+{
+  if (loadFromAuxilliaryData(auxData)) {
+    return true;
+  }
+  buildMappings(paramBank);
+  saveToAuxilliaryData(auxData);
+  return false;
+}
+
+bool LargeBarrelMapping::isConsistent() const
+{
+  /// the slot tables are read with the slot IDs as indices
+  auto slots = fSlotNumbers.size();
+  if (fSlotLayerNumbers.size() != slots || fSlotGlobalPMNumbers.size() != slots
+      || fOppositeSlotIDs.size() != slots || fSlotX.size() != slots || fSlotY.size() != slots) {
+    return false;
+  }
+  auto pms = fPMSides.size();
+  if (fPMScinIDs.size() != pms || fPMSlotIDs.size() != pms) {
+    return false;
+  }
+  for (auto layer_number : fSlotLayerNumbers) {
+    if (layer_number > getNumberOfLayers()) {
+      return false;
+    }
+  }
+  return true;
+}
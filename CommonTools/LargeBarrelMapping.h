@@ -0,0 +1,141 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file LargeBarrelMapping.h
+ */
+
+#ifndef _LARGE_BARREL_MAPPING_
+#define _LARGE_BARREL_MAPPING_
+
+#include <string>
+#include <vector>
+#include <JPetAuxilliaryData/JPetAuxilliaryData.h>
+#include <JPetParamBank/JPetParamBank.h>
+#include <JPetHit/JPetHit.h>
+#include <JPetPM/JPetPM.h>
+
+/**
+ * @brief Numbering of the layers, slots and PMs of the Large Barrel.
+ *
+ * The layers are numbered from 1 in the order of increasing radius and the slots
+ * of every layer from 1 in the order of increasing theta. The global PM number counts
+ * first the side A and then the side B PMs of layer 1, then of layer 2 etc., from 0.
+ *
+ * All the numbers are computed once in buildMappings() and stored in tables indexed
+ * by the integer ID of the layer or slot from the param bank, so every query is an
+ * array read. An unknown ID throws std::out_of_range.
+ *
+ * The side, scintillator and slot of every PM of the param bank are kept in the same way,
+ * so the tasks find them by the PM ID instead of walking the parameter objects copied
+ * into every signal. hasPM() tells whether a PM is known without an exception.
+ * The x and y of the centre of every slot (radius of its layer times cos and sin of
+ * its theta) are kept by the slot ID as well, for the positions of the hits.
+ *
+ * The tables can be saved to and loaded from a binary snapshot, so the mapping
+ * can be used without a param bank (e.g. in tests or in tools reading the output files).
+ * Snapshot layout (native byte order): "JPLB" u32 version, then every integer table as
+ * u32 size followed by the int32 entries and the x and y tables as u32 size followed
+ * by the f64 entries.
+ *
+ * The same tables are passed to the next tasks in the auxilliary data of the output file,
+ * in the map kAuxilliaryDataMapName: "version", "<table>_size" and "<table>_<index>".
+ * loadOrBuildMappings() reads them once per task if the input file has them; otherwise it
+ * builds the mapping from the param bank and saves it, so every output file carries it.
+ */
+class LargeBarrelMapping
+{
+public:
+  struct LayerGeometry {
+    int fID;
+    double fRadius;
+  };
+  struct SlotGeometry {
+    int fID;
+    int fLayerID;
+    double fTheta;
+  };
+  struct PMGeometry {
+    int fID;
+    JPetPM::Side fSide;
+    int fScinID;
+    int fSlotID;
+  };
+
+  LargeBarrelMapping();
+  LargeBarrelMapping(const JPetParamBank& paramBank);
+  virtual ~LargeBarrelMapping();
+
+  void buildMappings(const JPetParamBank& paramBank);
+  void buildMappings(const std::vector<LayerGeometry>& layers, const std::vector<SlotGeometry>& slots,
+                     const std::vector<PMGeometry>& pms = std::vector<PMGeometry>());
+  bool saveSnapshot(const std::string& fileName) const;
+  bool loadSnapshot(const std::string& fileName);
+  void saveToAuxilliaryData(JPetAuxilliaryData& auxData, const std::string& mapName = kAuxilliaryDataMapName) const;
+  /// Returns false (and leaves the mapping unchanged) if the map has no valid mapping
+  bool loadFromAuxilliaryData(JPetAuxilliaryData& auxData, const std::string& mapName = kAuxilliaryDataMapName);
+  /// Loads the mapping from the auxilliary data or builds it from the param bank and saves it there.
+  /// Returns true if it was loaded.
+  bool loadOrBuildMappings(const JPetParamBank& paramBank, JPetAuxilliaryData& auxData);
+
+  static const std::string kAuxilliaryDataMapName;
+
+  int getNumberOfLayers() const;
+  int getLayerNumber(const JPetLayer& layer) const;
+  int getLayerNumberByID(int layerID) const;
+  int getNumberOfSlots(const JPetLayer& layer) const;
+  int getNumberOfSlots(int layerNumber) const;
+  int getSlotNumber(const JPetBarrelSlot& slot) const;
+  int getSlotNumberByID(int slotID) const;
+  /// number of the layer of the slot
+  int getSlotLayerNumber(int slotID) const;
+  /// IDs of the slots of the layer in the order of their numbers
+  std::vector<int> getSlotIDs(int layerNumber) const;
+  int getGlobalPMNumber(const JPetPM& pm) const;
+  int getGlobalPMNumber(int slotID, JPetPM::Side side) const;
+  /// ID of the slot on the other side of the layer, -1 for layers with odd number of slots
+  int getOppositeSlotID(int slotID) const;
+  /// Distance between the slots of the hits in the number of slots, -1 if they are in different layers
+  int calcDeltaID(const JPetHit& hit1, const JPetHit& hit2) const;
+  int calcDeltaID(int slotID1, int slotID2) const;
+  bool hasPM(int pmID) const;
+  JPetPM::Side getPMSide(int pmID) const;
+  int getPMScinID(int pmID) const;
+  int getPMSlotID(int pmID) const;
+  /// position of the centre of the slot
+  double getSlotX(int slotID) const;
+  double getSlotY(int slotID) const;
+
+private:
+  static int lookup(const std::vector<int>& table, int index);
+  static double lookup(const std::vector<double>& table, int index);
+  /// checks the sizes and the numbers of the tables read from a snapshot
+  bool isConsistent() const;
+
+  /// indexed by layer ID
+  std::vector<int> fLayerNumbers;
+  /// indexed by layer number - 1
+  std::vector<int> fNumberOfSlotsInLayer;
+  /// indexed by slot ID
+  std::vector<int> fSlotLayerNumbers;
+  std::vector<int> fSlotNumbers;
+  std::vector<int> fSlotGlobalPMNumbers; /// of the side A PM
+  std::vector<int> fOppositeSlotIDs;
+  /// NaN for unknown slot IDs
+  std::vector<double> fSlotX;
+  std::vector<double> fSlotY;
+  /// indexed by PM ID
+  std::vector<int> fPMSides;
+  std::vector<int> fPMScinIDs;
+  std::vector<int> fPMSlotIDs;
+};
+
+#endif /* _LARGE_BARREL_MAPPING_ */
@@ -0,0 +1,123 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE LargeBarrelMapping
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#include "LargeBarrelMapping.h"
+
+namespace
+{
+/// layer ID 7 (inner) with 4 slots, layer ID 3 (outer) with 3 slots
+LargeBarrelMapping createMapping()
+{
+  std::vector<LargeBarrelMapping::LayerGeometry> layers = {{3, 50.}, {7, 42.5}};
+  std::vector<LargeBarrelMapping::SlotGeometry> slots = {
+    {10, 7, 90.}, {11, 7, 0.}, {12, 7, 270.}, {13, 7, 180.},
+    {20, 3, 240.}, {21, 3, 120.}, {22, 3, 0.}
+  };
+  /// scintillator 100 + slot ID in every slot, PM IDs 1, 2 on the sides of slot 11 and 5 on the side B of slot 22
+  std::vector<LargeBarrelMapping::PMGeometry> pms = {
+    {5, JPetPM::SideB, 122, 22}, {1, JPetPM::SideA, 111, 11}, {2, JPetPM::SideB, 111, 11}
+  };
+  LargeBarrelMapping mapping;
+  mapping.buildMappings(layers, slots, pms);
+  return mapping;
+}
+
+void checkMapping(const LargeBarrelMapping& mapping)
+{
+  BOOST_REQUIRE_EQUAL(mapping.getNumberOfLayers(), 2);
+  BOOST_REQUIRE_EQUAL(mapping.getLayerNumberByID(7), 1);
+  BOOST_REQUIRE_EQUAL(mapping.getLayerNumberByID(3), 2);
+  BOOST_REQUIRE_EQUAL(mapping.getNumberOfSlots(1), 4);
+  BOOST_REQUIRE_EQUAL(mapping.getNumberOfSlots(2), 3);
+
+  BOOST_REQUIRE_EQUAL(mapping.getSlotNumberByID(11), 1);
+  BOOST_REQUIRE_EQUAL(mapping.getSlotNumberByID(10), 2);
+  BOOST_REQUIRE_EQUAL(mapping.getSlotNumberByID(13), 3);
+  BOOST_REQUIRE_EQUAL(mapping.getSlotNumberByID(12), 4);
+  BOOST_REQUIRE_EQUAL(mapping.getSlotNumberByID(20), 3);
+  BOOST_REQUIRE_EQUAL(mapping.getSlotLayerNumber(20), 2);
+
+  BOOST_REQUIRE_EQUAL(mapping.getGlobalPMNumber(11, JPetPM::SideA), 0);
+  BOOST_REQUIRE_EQUAL(mapping.getGlobalPMNumber(12, JPetPM::SideA), 3);
+  BOOST_REQUIRE_EQUAL(mapping.getGlobalPMNumber(12, JPetPM::SideB), 7);
+  BOOST_REQUIRE_EQUAL(mapping.getGlobalPMNumber(22, JPetPM::SideA), 8);
+  BOOST_REQUIRE_EQUAL(mapping.getGlobalPMNumber(20, JPetPM::SideB), 13);
+
+  BOOST_REQUIRE_EQUAL(mapping.getOppositeSlotID(11), 13);
+  BOOST_REQUIRE_EQUAL(mapping.getOppositeSlotID(12), 10);
+  BOOST_REQUIRE_EQUAL(mapping.getOppositeSlotID(21), -1);
+
+  BOOST_REQUIRE_EQUAL(mapping.calcDeltaID(11, 12), 1);
+  BOOST_REQUIRE_EQUAL(mapping.calcDeltaID(11, 13), 2);
+  BOOST_REQUIRE_EQUAL(mapping.calcDeltaID(20, 22), 1);
+  BOOST_REQUIRE_EQUAL(mapping.calcDeltaID(11, 22), -1);
+
+  BOOST_REQUIRE_THROW(mapping.getSlotNumberByID(15), std::out_of_range);
+  BOOST_REQUIRE_THROW(mapping.getSlotNumberByID(1000), std::out_of_range);
+  BOOST_REQUIRE_THROW(mapping.getLayerNumberByID(-1), std::out_of_range);
+
+  BOOST_REQUIRE_EQUAL(mapping.getSlotX(11), 42.5);
+  BOOST_REQUIRE_EQUAL(mapping.getSlotY(11), 0.);
+  BOOST_REQUIRE_EQUAL(mapping.getSlotX(21), 50. * std::cos(120.));
+  BOOST_REQUIRE_EQUAL(mapping.getSlotY(21), 50. * std::sin(120.));
+  BOOST_REQUIRE_THROW(mapping.getSlotX(15), std::out_of_range);
+  BOOST_REQUIRE_THROW(mapping.getSlotY(1000), std::out_of_range);
+
+  BOOST_REQUIRE(mapping.hasPM(1));
+  BOOST_REQUIRE(mapping.hasPM(5));
+  BOOST_REQUIRE(!mapping.hasPM(3));
+  BOOST_REQUIRE(!mapping.hasPM(6));
+  BOOST_REQUIRE(!mapping.hasPM(-1));
+  BOOST_REQUIRE_EQUAL(mapping.getPMSide(1), JPetPM::SideA);
+  BOOST_REQUIRE_EQUAL(mapping.getPMSide(2), JPetPM::SideB);
+  BOOST_REQUIRE_EQUAL(mapping.getPMScinID(2), 111);
+  BOOST_REQUIRE_EQUAL(mapping.getPMSlotID(5), 22);
+  BOOST_REQUIRE_EQUAL(mapping.getPMScinID(5), 122);
+  BOOST_REQUIRE_THROW(mapping.getPMScinID(3), std::out_of_range);
+  BOOST_REQUIRE_THROW(mapping.getPMSlotID(100), std::out_of_range);
+}
+}
+
+BOOST_AUTO_TEST_SUITE (LargeBarrelMappingSuite)
+
+BOOST_AUTO_TEST_CASE (numbering)
+{
+  checkMapping(createMapping());
+}
+
+BOOST_AUTO_TEST_CASE (snapshot)
+{
+  const char* fileName = "LargeBarrelMappingTest.snapshot";
+  BOOST_REQUIRE(createMapping().saveSnapshot(fileName));
+  LargeBarrelMapping loaded;
+  BOOST_REQUIRE(loaded.loadSnapshot(fileName));
+  checkMapping(loaded);
+
+  /// a truncated snapshot is rejected and the mapping is not changed
+  std::FILE* truncated = std::fopen(fileName, "wb");
+  BOOST_REQUIRE(truncated);
+  std::fwrite("JPLB", 1, 4, truncated);
+  std::fclose(truncated);
+  BOOST_REQUIRE(!loaded.loadSnapshot(fileName));
+  checkMapping(loaded);
+  std::remove(fileName);
+}
+
+BOOST_AUTO_TEST_CASE (auxilliaryData)
+{
+  JPetAuxilliaryData auxData;
+  LargeBarrelMapping loaded;
+  BOOST_REQUIRE(!loaded.loadFromAuxilliaryData(auxData));
+  BOOST_REQUIRE_EQUAL(loaded.getNumberOfLayers(), 0);
+
+  createMapping().saveToAuxilliaryData(auxData);
+  BOOST_REQUIRE(loaded.loadFromAuxilliaryData(auxData));
+  checkMapping(loaded);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,60 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file PackedTimeWindow.cpp
+ */
+
+#include "PackedTimeWindow.h"
+
+PackedTimeWindow PackedTimeWindow::fromTimeWindow(const JPetTimeWindow& window)
+{
+  PackedTimeWindow packed;
+  packed.setIndex(window.getIndex());
+  const auto& sigChs = window.getSigChVect();
+  packed.fSigChs.reserve(sigChs.size());
+  for (const auto& sigCh : sigChs) {
+    packed.add(sigCh.getDAQch(), sigCh.getType(), sigCh.getThresholdNumber(), sigCh.getValue());
+  }
+  return packed;
+}
+
+JPetSigCh PackedTimeWindow::makeSigCh(const PackedSigCh& sigCh, const JPetParamBank& paramBank)
+{
+  const JPetTOMBChannel& channel = paramBank.getTOMBChannel(sigCh.fChannel);
+  JPetSigCh result;
+  result.setDAQch(sigCh.fChannel);
+  result.setType(static_cast<JPetSigCh::EdgeType>(sigCh.fEdge));
+  result.setThresholdNumber(sigCh.fThresholdNumber);
+  result.setThreshold(channel.getThreshold());
+  result.setPM(channel.getPM());
+  result.setFEB(channel.getFEB());
+  result.setTRB(channel.getTRB());
+  result.setTOMBChannel(channel);
+  result.setValue(IntegerTime::toPs(sigCh.fTime));
+  return result;
+}
+
+std::size_t PackedTimeWindow::toTimeWindow(const JPetParamBank& paramBank, JPetTimeWindow& window) const
+{
+  window = JPetTimeWindow();
+  window.setIndex(fIndex);
+  const auto& channels = paramBank.getTOMBChannels();
+  std::size_t skipped = 0;
+  for (const auto& sigCh : fSigChs) {
+    if (channels.count(sigCh.fChannel) == 0) {
+      skipped++;
+      continue;
+    }
+    window.addCh(makeSigCh(sigCh, paramBank));
+  }
+  return skipped;
+}
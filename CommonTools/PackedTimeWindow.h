@@ -0,0 +1,107 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file PackedTimeWindow.h
+ */
+
+#ifndef PACKEDTIMEWINDOW_H
+#define PACKEDTIMEWINDOW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <JPetParamBank/JPetParamBank.h>
+#include <JPetTimeWindow/JPetTimeWindow.h>
+#include "IntegerTime.h"
+
+/**
+ * @brief Signal channel reduced to its payload: 16 bytes instead of a JPetSigCh
+ * with copies of its JPetPM, JPetFEB, JPetTRB and JPetTOMBChannel.
+ *
+ * The parameter objects are found by the DAQ channel number in the param bank
+ * only when a JPetSigCh is needed (see PackedTimeWindow::makeSigCh).
+ */
+struct PackedSigCh {
+  std::uint32_t fChannel = 0; /// DAQ (TOMB) channel number
+  std::uint8_t fEdge = 0; /// JPetSigCh::EdgeType
+  std::uint8_t fThresholdNumber = 0;
+  std::uint16_t fReserved = 0;
+  IntegerTime::TimePs fTime = 0;
+};
+static_assert(sizeof(PackedSigCh) == 16, "PackedSigCh is written to the files as it is");
+
+/**
+ * @brief Time window as a contiguous array of PackedSigCh.
+ *
+ * The times are rounded to integer ps, far below the resolution of the TDCs.
+ * toTimeWindow() is the adapter for the tasks which expect a JPetTimeWindow.
+ */
+class PackedTimeWindow
+{
+public:
+  void setIndex(std::uint64_t index)
+  {
+    fIndex = index;
+  }
+  std::uint64_t getIndex() const
+  {
+    return fIndex;
+  }
+  void clear()
+  {
+    fSigChs.clear();
+  }
+  void add(const PackedSigCh& sigCh)
+  {
+    fSigChs.push_back(sigCh);
+  }
+  /// time in ps
+  void add(unsigned int channel, JPetSigCh::EdgeType edge, int thresholdNumber, double time)
+  {
+    PackedSigCh sigCh;
+    sigCh.fChannel = channel;
+    sigCh.fEdge = static_cast<std::uint8_t>(edge);
+    sigCh.fThresholdNumber = static_cast<std::uint8_t>(thresholdNumber);
+    sigCh.fTime = IntegerTime::fromPs(time);
+    fSigChs.push_back(sigCh);
+  }
+  std::size_t size() const
+  {
+    return fSigChs.size();
+  }
+  const PackedSigCh& operator[](std::size_t i) const
+  {
+    return fSigChs[i];
+  }
+  const std::vector<PackedSigCh>& getSigChs() const
+  {
+    return fSigChs;
+  }
+  std::vector<PackedSigCh>& getSigChs()
+  {
+    return fSigChs;
+  }
+
+  /// Packs the signal channels of the window; the parameter objects are dropped
+  static PackedTimeWindow fromTimeWindow(const JPetTimeWindow& window);
+  /// JPetSigCh with the parameter objects of its channel, as created by TimeWindowCreator.
+  /// The channel must exist in the param bank.
+  static JPetSigCh makeSigCh(const PackedSigCh& sigCh, const JPetParamBank& paramBank);
+  /// Fills window (cleared first) with JPetSigChs made by makeSigCh. The signal channels
+  /// from channels missing in the param bank are skipped; returns their number.
+  std::size_t toTimeWindow(const JPetParamBank& paramBank, JPetTimeWindow& window) const;
+
+private:
+  std::uint64_t fIndex = 0;
+  std::vector<PackedSigCh> fSigChs;
+};
+#endif /*  !PACKEDTIMEWINDOW_H */
@@ -0,0 +1,330 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file PackedTimeWindowFile.cpp
+ */
+
+#include <cstring>
+#include <utility>
+#include <zlib.h>
+#include "PackedTimeWindowFile.h"
+#include "TimeDeltaCodec.h"
+#include "JPetLoggerInclude.h"
+
+using namespace PackedTimeWindowFile;
+
+namespace
+{
+const char kMagic[4] = {'J', 'P', 'T', 'W'};
+const char kEndMagic[4] = {'J', 'P', 'T', 'E'};
+const std::uint32_t kVersion = 2;
+/// read as 0x04030201 on a machine with the other byte order
+const std::uint32_t kByteOrderMark = 0x01020304;
+const std::uint32_t kRawEncoding = 0;
+const std::uint32_t kDeltaZlibEncoding = 1;
+const std::uint32_t kDeltaEncoding = 2;
+const std::size_t kFileHeaderSize = 16;
+const std::size_t kWindowHeaderSize = 16;
+const std::size_t kIndexEntrySize = 24;
+const std::size_t kTrailerSize = 16;
+
+template<class T>
+void append(std::vector<char>& buffer, const T& value)
+{
+  const char* bytes = reinterpret_cast<const char*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template<class T>
+T read(const char* data)
+{
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+}
+
+Writer::Writer(const std::string& fileName, int compressionLevel, std::size_t blockSize):
+  fFileName(fileName),
+  fCompressionLevel(compressionLevel),
+  fBlockSize(blockSize)
+{
+  fFile = std::fopen(fileName.c_str(), "wb");
+  if (!fFile) {
+    return;
+  }
+  const std::uint32_t reserved = 0;
+  writeBytes(kMagic, sizeof(kMagic));
+  writeBytes(&kVersion, sizeof(kVersion));
+  writeBytes(&kByteOrderMark, sizeof(kByteOrderMark));
+  writeBytes(&reserved, sizeof(reserved));
+  fOffset = kFileHeaderSize;
+  fBlock.reserve(fBlockSize + kWindowHeaderSize);
+}
+
+Writer::~Writer()
+{
+  close();
+}
+
+bool Writer::isOpen() const
+{
+  return fFile != nullptr && !fFailed;
+}
+
+void Writer::writeBytes(const void* data, std::size_t size)
+{
+  if (fFailed || size == 0) {
+    return;
+  }
+  if (std::fwrite(data, 1, size, fFile) != size) {
+    ERROR("Cannot write the packed time window file " + fFileName);
+    fFailed = true;
+  }
+}
+
+void Writer::write(const PackedTimeWindow& window)
+{
+  if (!isOpen()) {
+    return;
+  }
+  if (fCompressionLevel > 0) {
+    TimeDeltaCodec::encodeWindow(window, fBlock);
+  } else {
+    append(fBlock, window.getIndex());
+    append(fBlock, static_cast<std::uint32_t>(window.size()));
+    append(fBlock, static_cast<std::uint32_t>(0));
+    const char* records = reinterpret_cast<const char*>(window.getSigChs().data());
+    fBlock.insert(fBlock.end(), records, records + window.size() * sizeof(PackedSigCh));
+  }
+  fBlockRecordsSize += kWindowHeaderSize + window.size() * sizeof(PackedSigCh);
+  fBlockWindows++;
+  fWindowCount++;
+  if (fBlockRecordsSize >= fBlockSize) {
+    flushBlock();
+  }
+}
+
+void Writer::flushBlock()
+{
+  if (!isOpen() || fBlockWindows == 0) {
+    return;
+  }
+  const char* stored = fBlock.data();
+  std::uint32_t storedSize = fBlock.size();
+  std::uint32_t encoding = kRawEncoding;
+  if (fCompressionLevel > 0) {
+    encoding = kDeltaEncoding;
+    uLongf compressedSize = compressBound(fBlock.size());
+    fCompressed.resize(compressedSize);
+    if (compress2(reinterpret_cast<Bytef*>(fCompressed.data()), &compressedSize,
+                  reinterpret_cast<const Bytef*>(fBlock.data()), fBlock.size(), fCompressionLevel) == Z_OK
+        && compressedSize < fBlock.size()) {
+      stored = fCompressed.data();
+      storedSize = compressedSize;
+      encoding = kDeltaZlibEncoding;
+    }
+  }
+  writeBytes(stored, storedSize);
+  append(fIndex, fOffset);
+  append(fIndex, storedSize);
+  append(fIndex, static_cast<std::uint32_t>(fBlock.size()));
+  append(fIndex, fBlockWindows);
+  append(fIndex, encoding);
+  fOffset += storedSize;
+  fBlockCount++;
+  fBlock.clear();
+  fBlockRecordsSize = 0;
+  fBlockWindows = 0;
+}
+
+bool Writer::close()
+{
+  if (!fFile) {
+    return !fFailed;
+  }
+  flushBlock();
+  writeBytes(fIndex.data(), fIndex.size());
+  writeBytes(&fOffset, sizeof(fOffset));
+  writeBytes(&fBlockCount, sizeof(fBlockCount));
+  writeBytes(kEndMagic, sizeof(kEndMagic));
+  /// the buffered data are written only now, so the errors may show up here
+  if (std::fclose(fFile) != 0 && !fFailed) {
+    ERROR("Cannot write the packed time window file " + fFileName);
+    fFailed = true;
+  }
+  fFile = nullptr;
+  return !fFailed;
+}
+
+Reader::Reader(const std::string& fileName)
+{
+  fFile = std::fopen(fileName.c_str(), "rb");
+  if (fFile && !readIndex()) {
+    std::fclose(fFile);
+    fFile = nullptr;
+    fBlocks.clear();
+  }
+}
+
+Reader::~Reader()
+{
+  if (fFile) {
+    std::fclose(fFile);
+  }
+}
+
+bool Reader::isOpen() const
+{
+  return fFile != nullptr;
+}
+
+std::size_t Reader::getWindowCount() const
+{
+  std::size_t count = 0;
+  for (const auto& block : fBlocks) {
+    count += block.fWindows;
+  }
+  return count;
+}
+
+bool Reader::readIndex()
+{
+  char header[kFileHeaderSize];
+  char trailer[kTrailerSize];
+  if (std::fread(header, 1, kFileHeaderSize, fFile) != kFileHeaderSize
+      || std::memcmp(header, kMagic, sizeof(kMagic)) != 0
+      || read<std::uint32_t>(header + sizeof(kMagic)) != kVersion
+      || read<std::uint32_t>(header + sizeof(kMagic) + 4) != kByteOrderMark
+      || std::fseek(fFile, 0, SEEK_END) != 0) {
+    return false;
+  }
+  long fileSize = std::ftell(fFile);
+  if (fileSize < static_cast<long>(kFileHeaderSize + kTrailerSize)
+      || std::fseek(fFile, fileSize - kTrailerSize, SEEK_SET) != 0
+      || std::fread(trailer, 1, kTrailerSize, fFile) != kTrailerSize
+      || std::memcmp(trailer + kTrailerSize - sizeof(kEndMagic), kEndMagic, sizeof(kEndMagic)) != 0) {
+    return false;
+  }
+  auto indexOffset = read<std::uint64_t>(trailer);
+  auto blockCount = read<std::uint32_t>(trailer + 8);
+  if (indexOffset + blockCount * kIndexEntrySize + kTrailerSize != static_cast<std::uint64_t>(fileSize)) {
+    return false;
+  }
+  std::vector<char> index(blockCount * kIndexEntrySize);
+  if (std::fseek(fFile, indexOffset, SEEK_SET) != 0
+      || std::fread(index.data(), 1, index.size(), fFile) != index.size()) {
+    return false;
+  }
+  for (std::uint32_t i = 0; i < blockCount; i++) {
+    const char* entry = index.data() + i * kIndexEntrySize;
+    BlockInfo block;
+    block.fOffset = read<std::uint64_t>(entry);
+    block.fStoredSize = read<std::uint32_t>(entry + 8);
+    block.fRawSize = read<std::uint32_t>(entry + 12);
+    block.fWindows = read<std::uint32_t>(entry + 16);
+    block.fEncoding = read<std::uint32_t>(entry + 20);
+    if (block.fOffset + block.fStoredSize > indexOffset
+        || block.fEncoding > kDeltaEncoding) {
+      return false;
+    }
+    fBlocks.push_back(block);
+  }
+  return true;
+}
+
+bool Reader::loadBlock(std::size_t index)
+{
+  const auto& block = fBlocks[index];
+  auto& stored = (block.fEncoding == kDeltaZlibEncoding) ? fStored : fBlock;
+  stored.resize(block.fStoredSize);
+  if (std::fseek(fFile, block.fOffset, SEEK_SET) != 0
+      || std::fread(stored.data(), 1, stored.size(), fFile) != stored.size()) {
+    return false;
+  }
+  if (block.fEncoding == kDeltaZlibEncoding) {
+    fBlock.resize(block.fRawSize);
+    uLongf rawSize = block.fRawSize;
+    if (uncompress(reinterpret_cast<Bytef*>(fBlock.data()), &rawSize,
+                   reinterpret_cast<const Bytef*>(fStored.data()), fStored.size()) != Z_OK
+        || rawSize != block.fRawSize) {
+      return false;
+    }
+  }
+  fBlockEncoding = block.fEncoding;
+  fBlockPosition = 0;
+  return true;
+}
+
+bool Reader::next(PackedTimeWindow& window)
+{
+  if (fHasPending) {
+    std::swap(window, fPending);
+    fHasPending = false;
+    return true;
+  }
+  if (!fFile) {
+    return false;
+  }
+  while (!fBlockLoaded || fBlockPosition >= fBlock.size()) {
+    if (fBlockLoaded) {
+      fCurrentBlock++;
+    }
+    if (fCurrentBlock >= fBlocks.size() || !loadBlock(fCurrentBlock)) {
+      fBlockLoaded = false;
+      fCurrentBlock = fBlocks.size();
+      return false;
+    }
+    fBlockLoaded = true;
+  }
+  if (fBlockEncoding != kRawEncoding) {
+    const char* position = fBlock.data() + fBlockPosition;
+    if (!TimeDeltaCodec::decodeWindow(position, fBlock.data() + fBlock.size(), window)) {
+      return false;
+    }
+    fBlockPosition = position - fBlock.data();
+    return true;
+  }
+  if (fBlockPosition + kWindowHeaderSize > fBlock.size()) {
+    return false;
+  }
+  const char* header = fBlock.data() + fBlockPosition;
+  auto nRecords = read<std::uint32_t>(header + 8);
+  std::size_t recordsSize = nRecords * sizeof(PackedSigCh);
+  if (fBlockPosition + kWindowHeaderSize + recordsSize > fBlock.size()) {
+    return false;
+  }
+  window.setIndex(read<std::uint64_t>(header));
+  auto& sigChs = window.getSigChs();
+  sigChs.resize(nRecords);
+  if (nRecords > 0) {
+    std::memcpy(sigChs.data(), header + kWindowHeaderSize, recordsSize);
+  }
+  fBlockPosition += kWindowHeaderSize + recordsSize;
+  return true;
+}
+
+bool Reader::readWindow(std::uint64_t index, PackedTimeWindow& window)
+{
+  while (next(window)) {
+    if (window.getIndex() == index) {
+      return true;
+    }
+    if (window.getIndex() > index) {
+      // may be requested later
+      std::swap(window, fPending);
+      fHasPending = true;
+      return false;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,135 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file PackedTimeWindowFile.h
+ */
+
+#ifndef PACKEDTIMEWINDOWFILE_H
+#define PACKEDTIMEWINDOWFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "PackedTimeWindow.h"
+
+/**
+ * @brief Binary file with PackedTimeWindows, a compact alternative to the tslot ROOT files.
+ *
+ * The windows are grouped in blocks of about blockSize bytes (of PackedSigCh records),
+ * read and written as a whole. With compression (the default) every window of a block
+ * is encoded with TimeDeltaCodec and the block is compressed with zlib; the sorted
+ * time differences take a few bytes per signal channel instead of 16.
+ * The index of the blocks is written at the end of the file.
+ *
+ * The numbers are stored in the byte order of the machine writing the file, so the raw
+ * records can be copied as they are; the header records this order with the u32 value
+ * 0x01020304, and a file written with the other byte order is not opened by the reader.
+ * File layout:
+ * "JPTW" u32 version, u32 byte order mark, u32 reserved | blocks... | index: {u64 offset, u32 stored size, u32 raw size,
+ * u32 number of windows, u32 encoding} per block | u64 index offset, u32 number of blocks, "JPTE"
+ * Block content: for every window {u64 window index, u32 number of records, u32 reserved,
+ * PackedSigCh records} for encoding 0 (stored as it is); the windows encoded by
+ * TimeDeltaCodec and compressed with zlib for encoding 1; the encoded windows alone
+ * for encoding 2 (if zlib does not make the block smaller).
+ */
+namespace PackedTimeWindowFile
+{
+class Writer
+{
+public:
+  /// compressionLevel: 0 - records stored as they are, 1-9 - delta encoding and zlib levels
+  explicit Writer(const std::string& fileName, int compressionLevel = 1, std::size_t blockSize = 1 << 20);
+  ~Writer();
+  /// False if the file could not be opened or a write failed (reported as ERROR)
+  bool isOpen() const;
+  void write(const PackedTimeWindow& window);
+  /// Writes the last block and the index. Called also by the destructor.
+  /// Returns false if any part of the file could not be written.
+  bool close();
+  std::size_t getWindowCount() const
+  {
+    return fWindowCount;
+  }
+
+private:
+  Writer(const Writer&);
+  void operator=(const Writer&);
+  void flushBlock();
+  void writeBytes(const void* data, std::size_t size);
+
+  std::string fFileName;
+  std::FILE* fFile = nullptr;
+  bool fFailed = false;
+  int fCompressionLevel;
+  std::size_t fBlockSize;
+  std::vector<char> fBlock;
+  /// size of the records of the current block, as if it was not encoded
+  std::size_t fBlockRecordsSize = 0;
+  std::vector<char> fCompressed;
+  std::vector<char> fIndex;
+  std::uint32_t fBlockWindows = 0;
+  std::uint32_t fBlockCount = 0;
+  std::uint64_t fOffset = 0;
+  std::size_t fWindowCount = 0;
+};
+
+/**
+ * @brief Reader of the packed time window files, one block in memory at a time.
+ * All the encodings are read.
+ */
+class Reader
+{
+public:
+  explicit Reader(const std::string& fileName);
+  ~Reader();
+  bool isOpen() const;
+  std::size_t getBlockCount() const
+  {
+    return fBlocks.size();
+  }
+  std::size_t getWindowCount() const;
+  /// Reads the next window; returns false at the end of the file or on error
+  bool next(PackedTimeWindow& window);
+  /// Skips the windows with smaller indices and reads the one with the given index.
+  /// Returns false if there is no such window; the windows must be stored in increasing
+  /// order of their indices, as they are written by the unpacking tasks.
+  bool readWindow(std::uint64_t index, PackedTimeWindow& window);
+
+private:
+  struct BlockInfo {
+    std::uint64_t fOffset;
+    std::uint32_t fStoredSize;
+    std::uint32_t fRawSize;
+    std::uint32_t fWindows;
+    std::uint32_t fEncoding;
+  };
+  Reader(const Reader&);
+  void operator=(const Reader&);
+  bool readIndex();
+  bool loadBlock(std::size_t block);
+
+  std::FILE* fFile = nullptr;
+  std::vector<BlockInfo> fBlocks;
+  std::vector<char> fStored;
+  std::vector<char> fBlock;
+  std::uint32_t fBlockEncoding = 0;
+  std::size_t fBlockPosition = 0;
+  std::size_t fCurrentBlock = 0;
+  bool fBlockLoaded = false;
+  /// the window read last, kept by readWindow() when it is past the requested index
+  PackedTimeWindow fPending;
+  bool fHasPending = false;
+};
+}
+#endif /*  !PACKEDTIMEWINDOWFILE_H */
@@ -0,0 +1,154 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE PackedTimeWindowFile
+#include <boost/test/unit_test.hpp>
+#include <cstdio>
+#include <utility>
+
+#include "PackedTimeWindowFile.h"
+
+namespace
+{
+PackedTimeWindow makeWindow(std::uint64_t index, int nSigChs)
+{
+  PackedTimeWindow window;
+  window.setIndex(index);
+  for (int i = 0; i < nSigChs; i++) {
+    JPetSigCh::EdgeType edge = (i % 2 == 0) ? JPetSigCh::Leading : JPetSigCh::Trailing;
+    window.add(2000 + i, edge, i % 4 + 1, -1.e9 + 1234.4 * i + index);
+  }
+  return window;
+}
+
+void checkWindow(const PackedTimeWindow& window, std::uint64_t index, int nSigChs)
+{
+  BOOST_REQUIRE_EQUAL(window.getIndex(), index);
+  BOOST_REQUIRE_EQUAL(window.size(), static_cast<std::size_t>(nSigChs));
+  PackedTimeWindow expected = makeWindow(index, nSigChs);
+  for (int i = 0; i < nSigChs; i++) {
+    BOOST_REQUIRE_EQUAL(window[i].fChannel, expected[i].fChannel);
+    BOOST_REQUIRE_EQUAL(window[i].fEdge, expected[i].fEdge);
+    BOOST_REQUIRE_EQUAL(window[i].fThresholdNumber, expected[i].fThresholdNumber);
+    BOOST_REQUIRE_EQUAL(window[i].fTime, expected[i].fTime);
+  }
+}
+}
+
+BOOST_AUTO_TEST_SUITE (PackedTimeWindowFileSuite)
+
+BOOST_AUTO_TEST_CASE (timesRoundedToPicoseconds)
+{
+  PackedTimeWindow window;
+  window.add(5, JPetSigCh::Leading, 2, -123456.6);
+  window.add(5, JPetSigCh::Trailing, 2, 10.4);
+  BOOST_REQUIRE_EQUAL(window[0].fTime, -123457);
+  BOOST_REQUIRE_EQUAL(window[1].fTime, 10);
+  BOOST_REQUIRE_EQUAL(window[0].fEdge, static_cast<std::uint8_t>(JPetSigCh::Leading));
+  BOOST_REQUIRE_EQUAL(window[1].fThresholdNumber, 2);
+}
+
+BOOST_AUTO_TEST_CASE (writeAndReadBack)
+{
+  const std::string fileName = "packedTimeWindowFileTest.ptw";
+  std::vector<long> fileSizes;
+  for (int compression : {0, 1}) {
+    {
+      PackedTimeWindowFile::Writer writer(fileName, compression, 4096);
+      BOOST_REQUIRE(writer.isOpen());
+      for (int w = 0; w < 100; w++) {
+        writer.write(makeWindow(w, w % 7 == 0 ? 0 : 50 + w));
+      }
+      BOOST_REQUIRE_EQUAL(writer.getWindowCount(), 100u);
+    }
+    PackedTimeWindowFile::Reader reader(fileName);
+    BOOST_REQUIRE(reader.isOpen());
+    BOOST_REQUIRE(reader.getBlockCount() > 1);
+    BOOST_REQUIRE_EQUAL(reader.getWindowCount(), 100u);
+    PackedTimeWindow window;
+    for (int w = 0; w < 100; w++) {
+      BOOST_REQUIRE(reader.next(window));
+      checkWindow(window, w, w % 7 == 0 ? 0 : 50 + w);
+    }
+    BOOST_REQUIRE(!reader.next(window));
+    std::FILE* file = std::fopen(fileName.c_str(), "rb");
+    std::fseek(file, 0, SEEK_END);
+    fileSizes.push_back(std::ftell(file));
+    std::fclose(file);
+  }
+  /// the times of the test windows grow in steps of about 1 ns
+  BOOST_REQUIRE(fileSizes[1] * 3 < fileSizes[0]);
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE (readWindowsByIndex)
+{
+  const std::string fileName = "packedTimeWindowFileTest2.ptw";
+  {
+    PackedTimeWindowFile::Writer writer(fileName, 1, 256);
+    for (int w : {0, 1, 3, 4, 8}) {
+      writer.write(makeWindow(w, 10));
+    }
+  }
+  PackedTimeWindowFile::Reader reader(fileName);
+  PackedTimeWindow window;
+  BOOST_REQUIRE(reader.readWindow(1, window));
+  checkWindow(window, 1, 10);
+  // window 2 is missing, window 3 must still be available
+  BOOST_REQUIRE(!reader.readWindow(2, window));
+  BOOST_REQUIRE(reader.readWindow(3, window));
+  checkWindow(window, 3, 10);
+  BOOST_REQUIRE(reader.readWindow(8, window));
+  checkWindow(window, 8, 10);
+  BOOST_REQUIRE(!reader.readWindow(9, window));
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE (wrongFile)
+{
+  const std::string fileName = "packedTimeWindowFileTest3.ptw";
+  std::FILE* file = std::fopen(fileName.c_str(), "wb");
+  std::fputs("not a packed time window file", file);
+  std::fclose(file);
+  PackedTimeWindowFile::Reader reader(fileName);
+  BOOST_REQUIRE(!reader.isOpen());
+  PackedTimeWindow window;
+  BOOST_REQUIRE(!reader.next(window));
+  std::remove(fileName.c_str());
+  PackedTimeWindowFile::Reader missing("noSuchFile.ptw");
+  BOOST_REQUIRE(!missing.isOpen());
+}
+
+BOOST_AUTO_TEST_CASE (otherByteOrderNotRead)
+{
+  const std::string fileName = "packedTimeWindowFileTest4.ptw";
+  {
+    PackedTimeWindowFile::Writer writer(fileName);
+    writer.write(makeWindow(1, 10));
+    BOOST_REQUIRE(writer.close());
+  }
+  /// the byte order mark follows the magic and the version; reversed as the other order writes it
+  std::FILE* file = std::fopen(fileName.c_str(), "r+b");
+  unsigned char mark[4];
+  std::fseek(file, 8, SEEK_SET);
+  BOOST_REQUIRE_EQUAL(std::fread(mark, 1, 4, file), 4u);
+  std::swap(mark[0], mark[3]);
+  std::swap(mark[1], mark[2]);
+  std::fseek(file, 8, SEEK_SET);
+  std::fwrite(mark, 1, 4, file);
+  std::fclose(file);
+  PackedTimeWindowFile::Reader reader(fileName);
+  BOOST_REQUIRE(!reader.isOpen());
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE (writeErrorsReported)
+{
+  /// every write to /dev/full fails with ENOSPC
+  PackedTimeWindowFile::Writer writer("/dev/full", 0, 256);
+  for (int w = 0; w < 100; w++) {
+    writer.write(makeWindow(w, 50));
+  }
+  BOOST_REQUIRE(!writer.close());
+  BOOST_REQUIRE(!writer.isOpen());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
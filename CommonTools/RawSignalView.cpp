@@ -0,0 +1,111 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file RawSignalView.cpp
+ */
+
+#include <algorithm>
+#include "RawSignalView.h"
+
+RawSignalView::RawSignalView(const JPetRawSignal& signal):
+  fSignal(signal)
+{
+}
+
+RawSignalView::EdgeCache& RawSignalView::getCache(JPetSigCh::EdgeType edge) const
+{
+  switch (edge) {
+  case JPetSigCh::Leading:
+    return fLeading;
+  case JPetSigCh::Trailing:
+    return fTrailing;
+  default:
+    return fCharge;
+  }
+}
+
+RawSignalView::EdgeCache& RawSignalView::getSortedByThrNum(JPetSigCh::EdgeType edge) const
+{
+  auto& cache = getCache(edge);
+  if (!cache.fByThrNumReady) {
+    cache.fByThrNum = fSignal.getPoints(edge, JPetRawSignal::ByThrNum);
+    /// later points overwrite the earlier ones, as in getTimesVsThresholdNumber
+    for (const auto& point : cache.fByThrNum) {
+      int thrNumber = point.getThresholdNumber();
+      if (thrNumber >= 1 && thrNumber <= kMaxThresholds) {
+        cache.fTimes[thrNumber - 1] = point.getValue();
+        cache.fPresent |= 1u << (thrNumber - 1);
+      }
+    }
+    cache.fByThrNumReady = true;
+  }
+  return cache;
+}
+
+const std::vector<JPetSigCh>& RawSignalView::getPoints(JPetSigCh::EdgeType edge,
+    JPetRawSignal::PointsSortOrder order) const
+{
+  auto& cache = getSortedByThrNum(edge);
+  if (order == JPetRawSignal::ByThrNum) {
+    return cache.fByThrNum;
+  }
+  if (!cache.fByThrValueReady) {
+    cache.fByThrValue = cache.fByThrNum;
+    std::stable_sort(cache.fByThrValue.begin(), cache.fByThrValue.end(),
+    [](const JPetSigCh & first, const JPetSigCh & second) {
+      return first.getThreshold() < second.getThreshold();
+    });
+    cache.fByThrValueReady = true;
+  }
+  return cache.fByThrValue;
+}
+
+std::size_t RawSignalView::getNumberOfPoints(JPetSigCh::EdgeType edge) const
+{
+  return getSortedByThrNum(edge).fByThrNum.size();
+}
+
+bool RawSignalView::hasTime(JPetSigCh::EdgeType edge, int thrNumber) const
+{
+  return thrNumber >= 1 && thrNumber <= kMaxThresholds
+         && (getSortedByThrNum(edge).fPresent & (1u << (thrNumber - 1)));
+}
+
+double RawSignalView::getTime(JPetSigCh::EdgeType edge, int thrNumber) const
+{
+  return hasTime(edge, thrNumber) ? getSortedByThrNum(edge).fTimes[thrNumber - 1] : 0.;
+}
+
+const double* RawSignalView::getTimes(JPetSigCh::EdgeType edge) const
+{
+  return getSortedByThrNum(edge).fTimes;
+}
+
+bool RawSignalView::hasThresholds(JPetSigCh::EdgeType edge, int n) const
+{
+  if (n > kMaxThresholds) {
+    return false;
+  }
+  unsigned int mask = (1u << n) - 1;
+  return (getSortedByThrNum(edge).fPresent & mask) == mask;
+}
+
+int RawSignalView::getFirstThresholdNumber(JPetSigCh::EdgeType edge) const
+{
+  unsigned int present = getSortedByThrNum(edge).fPresent;
+  for (int thrNumber = 1; thrNumber <= kMaxThresholds; thrNumber++) {
+    if (present & (1u << (thrNumber - 1))) {
+      return thrNumber;
+    }
+  }
+  return 0;
+}
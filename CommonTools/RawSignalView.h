@@ -0,0 +1,78 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file RawSignalView.h
+ */
+
+#ifndef RAWSIGNALVIEW_H
+#define RAWSIGNALVIEW_H
+
+#include <vector>
+#include <JPetRawSignal/JPetRawSignal.h>
+#include <JPetSigCh/JPetSigCh.h>
+
+/**
+ * @brief Cached read-only views of the points of a JPetRawSignal.
+ *
+ * Every call of JPetRawSignal::getPoints or getTimesVsThresholdNumber copies and sorts
+ * the points again. The view computes the points of an edge sorted by threshold number
+ * and by threshold value, and the times indexed by threshold number, at the first use
+ * and returns them from the cache later.
+ *
+ * The view keeps a reference to the signal, which must not change while the view is used.
+ */
+class RawSignalView
+{
+public:
+  /// Threshold numbers start from 1; higher numbers are only present in the sorted points
+  static const int kMaxThresholds = 4;
+
+  explicit RawSignalView(const JPetRawSignal& signal);
+
+  const JPetRawSignal& getSignal() const
+  {
+    return fSignal;
+  }
+  /// Points of the edge in the same order as JPetRawSignal::getPoints(edge, order)
+  const std::vector<JPetSigCh>& getPoints(JPetSigCh::EdgeType edge,
+                                          JPetRawSignal::PointsSortOrder order = JPetRawSignal::ByThrNum) const;
+  std::size_t getNumberOfPoints(JPetSigCh::EdgeType edge) const;
+  /// True if there is a point with the threshold number (1..kMaxThresholds) on the edge
+  bool hasTime(JPetSigCh::EdgeType edge, int thrNumber) const;
+  /// Time at the threshold number (1..kMaxThresholds), 0 if there is no such point
+  double getTime(JPetSigCh::EdgeType edge, int thrNumber) const;
+  /// Times indexed by threshold number - 1, as getTimesVsThresholdNumber(edge).at(thrNumber)
+  const double* getTimes(JPetSigCh::EdgeType edge) const;
+  /// True if all the thresholds 1..n are present on the edge
+  bool hasThresholds(JPetSigCh::EdgeType edge, int n) const;
+  /// Lowest threshold number on the edge (as getTimesVsThresholdNumber(edge).begin()), 0 if none
+  int getFirstThresholdNumber(JPetSigCh::EdgeType edge) const;
+
+private:
+  struct EdgeCache {
+    bool fByThrNumReady = false;
+    bool fByThrValueReady = false;
+    std::vector<JPetSigCh> fByThrNum;
+    std::vector<JPetSigCh> fByThrValue;
+    double fTimes[kMaxThresholds] = {0., 0., 0., 0.};
+    unsigned int fPresent = 0; /// bit thrNumber - 1 is set if the time is present
+  };
+
+  EdgeCache& getCache(JPetSigCh::EdgeType edge) const;
+  EdgeCache& getSortedByThrNum(JPetSigCh::EdgeType edge) const;
+
+  const JPetRawSignal& fSignal;
+  mutable EdgeCache fLeading;
+  mutable EdgeCache fTrailing;
+  mutable EdgeCache fCharge;
+};
+#endif /*  !RAWSIGNALVIEW_H */
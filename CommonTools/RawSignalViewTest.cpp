@@ -0,0 +1,68 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE RawSignalView
+#include <boost/test/unit_test.hpp>
+
+#include "RawSignalView.h"
+
+namespace
+{
+JPetSigCh createPoint(JPetSigCh::EdgeType edge, double time, int thrNumber, float threshold)
+{
+  JPetSigCh point(edge, time);
+  point.setThresholdNumber(thrNumber);
+  point.setThreshold(threshold);
+  return point;
+}
+}
+
+BOOST_AUTO_TEST_SUITE (RawSignalViewSuite)
+
+BOOST_AUTO_TEST_CASE (sameAsRawSignal)
+{
+  JPetRawSignal signal;
+  signal.addPoint(createPoint(JPetSigCh::Leading, 300., 3, 80.));
+  signal.addPoint(createPoint(JPetSigCh::Leading, 100., 1, 160.));
+  signal.addPoint(createPoint(JPetSigCh::Leading, 200., 2, 40.));
+  signal.addPoint(createPoint(JPetSigCh::Trailing, 900., 2, 40.));
+
+  RawSignalView view(signal);
+  for (auto order : {JPetRawSignal::ByThrNum, JPetRawSignal::ByThrValue}) {
+    auto expected = signal.getPoints(JPetSigCh::Leading, order);
+    const auto& points = view.getPoints(JPetSigCh::Leading, order);
+    BOOST_REQUIRE_EQUAL(points.size(), expected.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+      BOOST_REQUIRE_EQUAL(points[i].getValue(), expected[i].getValue());
+    }
+    /// the second call returns the cached vector
+    BOOST_REQUIRE_EQUAL(&view.getPoints(JPetSigCh::Leading, order), &points);
+  }
+  BOOST_REQUIRE_EQUAL(view.getNumberOfPoints(JPetSigCh::Leading), 3u);
+  BOOST_REQUIRE_EQUAL(view.getNumberOfPoints(JPetSigCh::Trailing), 1u);
+
+  auto times = signal.getTimesVsThresholdNumber(JPetSigCh::Leading);
+  for (int thr = 1; thr <= RawSignalView::kMaxThresholds; thr++) {
+    BOOST_REQUIRE_EQUAL(view.hasTime(JPetSigCh::Leading, thr), times.count(thr) > 0);
+    if (times.count(thr)) {
+      BOOST_REQUIRE_EQUAL(view.getTime(JPetSigCh::Leading, thr), times.at(thr));
+      BOOST_REQUIRE_EQUAL(view.getTimes(JPetSigCh::Leading)[thr - 1], times.at(thr));
+    }
+  }
+  BOOST_REQUIRE(view.hasThresholds(JPetSigCh::Leading, 3));
+  BOOST_REQUIRE(!view.hasThresholds(JPetSigCh::Leading, 4));
+  BOOST_REQUIRE(!view.hasThresholds(JPetSigCh::Trailing, 1));
+  BOOST_REQUIRE_EQUAL(view.getFirstThresholdNumber(JPetSigCh::Leading), 1);
+  BOOST_REQUIRE_EQUAL(view.getFirstThresholdNumber(JPetSigCh::Trailing), 2);
+}
+
+BOOST_AUTO_TEST_CASE (emptySignal)
+{
+  JPetRawSignal signal;
+  RawSignalView view(signal);
+  BOOST_REQUIRE(view.getPoints(JPetSigCh::Leading).empty());
+  BOOST_REQUIRE(!view.hasTime(JPetSigCh::Leading, 1));
+  BOOST_REQUIRE(!view.hasTime(JPetSigCh::Leading, 0));
+  BOOST_REQUIRE_EQUAL(view.getTime(JPetSigCh::Leading, 1), 0.);
+  BOOST_REQUIRE_EQUAL(view.getFirstThresholdNumber(JPetSigCh::Leading), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
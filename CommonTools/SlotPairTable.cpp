@@ -0,0 +1,63 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file SlotPairTable.cpp
+ */
+
+#include <cstdlib>
+#include "SlotPairTable.h"
+
+SlotPairTable::SlotPairTable() {}
+
+SlotPairTable::SlotPairTable(const LargeBarrelMapping& mapping, int oppositeTolerance)
+{
+  build(mapping, oppositeTolerance);
+}
+
+void SlotPairTable::build(const LargeBarrelMapping& mapping, int oppositeTolerance)
+{
+  fOppositeTolerance = oppositeTolerance;
+  fSlotLayers.clear();
+  fSlotPositions.clear();
+  fLayers.assign(mapping.getNumberOfLayers(), Layer());
+  for (int l = 0; l < mapping.getNumberOfLayers(); l++) {
+    auto slotIDs = mapping.getSlotIDs(l + 1);
+    for (std::size_t s = 0; s < slotIDs.size(); s++) {
+      if (static_cast<std::size_t>(slotIDs[s]) >= fSlotLayers.size()) {
+        fSlotLayers.resize(slotIDs[s] + 1, -1);
+        fSlotPositions.resize(slotIDs[s] + 1, -1);
+      }
+      fSlotLayers[slotIDs[s]] = l;
+      fSlotPositions[slotIDs[s]] = s;
+    }
+
+    Layer& layer = fLayers[l];
+    int size = slotIDs.size();
+    int half_layer_size = size / 2;
+    layer.fSize = size;
+    layer.fDeltaIDs.resize(size * size);
+    layer.fOpposite.resize(size * size);
+    layer.fNearOpposite.resize(size * size);
+    for (int first = 0; first < size; first++) {
+      for (int second = 0; second < size; second++) {
+        int delta_ID = std::abs(first - second);
+        if (delta_ID > half_layer_size) {
+          delta_ID = size - delta_ID;
+        }
+        int index = first * size + second;
+        layer.fDeltaIDs[index] = delta_ID;
+        layer.fOpposite[index] = (delta_ID == half_layer_size);
+        layer.fNearOpposite[index] = (delta_ID >= half_layer_size - oppositeTolerance);
+      }
+    }
+  }
+}
@@ -0,0 +1,95 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file SlotPairTable.h
+ */
+
+#ifndef SLOTPAIRTABLE_H
+#define SLOTPAIRTABLE_H
+
+#include <cstdint>
+#include <vector>
+#include "LargeBarrelMapping.h"
+
+/**
+ * @brief Classification of the pairs of Large Barrel slots, precomputed for one geometry.
+ *
+ * For every layer a matrix of Delta ID (the distance between the slots in the number
+ * of slots, as LargeBarrelMapping::calcDeltaID) and two bit matrices are built:
+ * "opposite" (Delta ID equal to half of the layer) and "near opposite" (Delta ID
+ * at most k slots less than half of the layer). A layer of 96 slots takes less than 20 kB.
+ * The queries take the slot IDs and do not throw: pairs from different layers
+ * or with an unknown slot have Delta ID -1 and are not opposite.
+ */
+class SlotPairTable
+{
+public:
+  SlotPairTable();
+  explicit SlotPairTable(const LargeBarrelMapping& mapping, int oppositeTolerance = 0);
+
+  void build(const LargeBarrelMapping& mapping, int oppositeTolerance = 0);
+
+  int getDeltaID(int slotID1, int slotID2) const
+  {
+    int index = 0;
+    const Layer* layer = findPair(slotID1, slotID2, index);
+    return layer ? layer->fDeltaIDs[index] : -1;
+  }
+  bool isOpposite(int slotID1, int slotID2) const
+  {
+    int index = 0;
+    const Layer* layer = findPair(slotID1, slotID2, index);
+    return layer && layer->fOpposite[index];
+  }
+  /// true if the slots are opposite within +-k slots, k given in build()
+  bool isNearOpposite(int slotID1, int slotID2) const
+  {
+    int index = 0;
+    const Layer* layer = findPair(slotID1, slotID2, index);
+    return layer && layer->fNearOpposite[index];
+  }
+  int getOppositeTolerance() const
+  {
+    return fOppositeTolerance;
+  }
+
+private:
+  struct Layer {
+    int fSize = 0;
+    /// indexed by (slot number 1 - 1) * size + slot number 2 - 1
+    std::vector<std::int16_t> fDeltaIDs;
+    std::vector<bool> fOpposite;
+    std::vector<bool> fNearOpposite;
+  };
+
+  const Layer* findPair(int slotID1, int slotID2, int& index) const
+  {
+    if (slotID1 < 0 || slotID2 < 0
+        || static_cast<std::size_t>(slotID1) >= fSlotLayers.size()
+        || static_cast<std::size_t>(slotID2) >= fSlotLayers.size()) {
+      return nullptr;
+    }
+    int layer = fSlotLayers[slotID1];
+    if (layer < 0 || layer != fSlotLayers[slotID2]) {
+      return nullptr;
+    }
+    index = fSlotPositions[slotID1] * fLayers[layer].fSize + fSlotPositions[slotID2];
+    return &fLayers[layer];
+  }
+
+  /// indexed by slot ID: layer number - 1 (-1 for unknown IDs) and slot number - 1
+  std::vector<int> fSlotLayers;
+  std::vector<int> fSlotPositions;
+  std::vector<Layer> fLayers;
+  int fOppositeTolerance = 0;
+};
+#endif /*  !SLOTPAIRTABLE_H */
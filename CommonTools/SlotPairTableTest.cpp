@@ -0,0 +1,66 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE SlotPairTable
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+#include "SlotPairTable.h"
+
+namespace
+{
+/// layer ID 1 with 8 slots (IDs 100-107), layer ID 2 with 5 slots (IDs 200-204)
+LargeBarrelMapping createMapping()
+{
+  std::vector<LargeBarrelMapping::LayerGeometry> layers = {{1, 42.5}, {2, 50.}};
+  std::vector<LargeBarrelMapping::SlotGeometry> slots;
+  for (int i = 0; i < 8; i++) {
+    slots.push_back(LargeBarrelMapping::SlotGeometry{100 + i, 1, 45. * i});
+  }
+  for (int i = 0; i < 5; i++) {
+    slots.push_back(LargeBarrelMapping::SlotGeometry{200 + i, 2, 72. * i});
+  }
+  LargeBarrelMapping mapping;
+  mapping.buildMappings(layers, slots);
+  return mapping;
+}
+}
+
+BOOST_AUTO_TEST_SUITE (SlotPairTableSuite)
+
+BOOST_AUTO_TEST_CASE (sameAsMapping)
+{
+  auto mapping = createMapping();
+  SlotPairTable table(mapping);
+  std::vector<int> slotIDs = {100, 101, 102, 103, 104, 105, 106, 107, 200, 201, 202, 203, 204};
+  for (auto first : slotIDs) {
+    for (auto second : slotIDs) {
+      BOOST_REQUIRE_EQUAL(table.getDeltaID(first, second), mapping.calcDeltaID(first, second));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE (opposite)
+{
+  SlotPairTable table(createMapping(), 1);
+  BOOST_REQUIRE(table.isOpposite(100, 104));
+  BOOST_REQUIRE(table.isOpposite(107, 103));
+  BOOST_REQUIRE(!table.isOpposite(100, 103));
+  BOOST_REQUIRE(table.isNearOpposite(100, 103));
+  BOOST_REQUIRE(table.isNearOpposite(100, 105));
+  BOOST_REQUIRE(!table.isNearOpposite(100, 102));
+  /// in a layer with odd number of slots the two farthest slots are opposite
+  BOOST_REQUIRE(table.isOpposite(200, 202));
+  BOOST_REQUIRE(table.isOpposite(200, 203));
+  BOOST_REQUIRE(!table.isOpposite(200, 201));
+}
+
+BOOST_AUTO_TEST_CASE (otherLayerOrUnknownSlot)
+{
+  SlotPairTable table(createMapping());
+  BOOST_REQUIRE_EQUAL(table.getDeltaID(100, 200), -1);
+  BOOST_REQUIRE_EQUAL(table.getDeltaID(100, 150), -1);
+  BOOST_REQUIRE_EQUAL(table.getDeltaID(-5, 100), -1);
+  BOOST_REQUIRE_EQUAL(table.getDeltaID(100, 1000), -1);
+  BOOST_REQUIRE(!table.isOpposite(100, 1000));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
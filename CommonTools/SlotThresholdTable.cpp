@@ -0,0 +1,93 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file SlotThresholdTable.cpp
+ */
+
+#include "SlotThresholdTable.h"
+
+namespace
+{
+std::string formatSlotsKey(int layerNumber)
+{
+  return "slots_" + std::to_string(layerNumber);
+}
+}
+
+SlotThresholdTable::SlotThresholdTable()
+{
+  fLayerOffsets.push_back(0);
+}
+
+SlotThresholdTable::SlotThresholdTable(const LargeBarrelMapping& mapping)
+{
+  build(mapping);
+}
+
+void SlotThresholdTable::build(const LargeBarrelMapping& mapping)
+{
+  std::vector<int> numberOfSlots;
+  for (int layer = 1; layer <= mapping.getNumberOfLayers(); layer++) {
+    numberOfSlots.push_back(mapping.getNumberOfSlots(layer));
+  }
+  build(numberOfSlots);
+}
+
+void SlotThresholdTable::build(const std::vector<int>& numberOfSlotsInLayers)
+{
+  fLayerOffsets.assign(1, 0);
+  for (auto slots : numberOfSlotsInLayers) {
+    fLayerOffsets.push_back(fLayerOffsets.back() + slots * kNumOfThresholds);
+  }
+  fValues.assign(fLayerOffsets.back(), std::numeric_limits<double>::quiet_NaN());
+}
+
+bool SlotThresholdTable::set(int layerNumber, int slotNumber, int thr, double value)
+{
+  int index = getIndex(layerNumber, slotNumber, thr);
+  if (index < 0) {
+    return false;
+  }
+  fValues[index] = value;
+  return true;
+}
+
+void SlotThresholdTable::saveToAuxilliaryData(JPetAuxilliaryData& auxData, const std::string& mapName) const
+{
+  auxData.createMap(mapName);
+  auxData.setValue(mapName, "layers", getNumberOfLayers());
+  for (int layer = 1; layer <= getNumberOfLayers(); layer++) {
+    auxData.setValue(mapName, formatSlotsKey(layer),
+                     (fLayerOffsets[layer] - fLayerOffsets[layer - 1]) / kNumOfThresholds);
+  }
+  // the missing values are saved as NaN, so every key of the table is present
+  for (std::size_t i = 0; i < fValues.size(); i++) {
+    auxData.setValue(mapName, std::to_string(i), fValues[i]);
+  }
+}
+
+bool SlotThresholdTable::loadFromAuxilliaryData(JPetAuxilliaryData& auxData, const std::string& mapName)
+{
+  int layers = auxData.getValue(mapName, "layers");
+  std::vector<int> numberOfSlots;
+  for (int layer = 1; layer <= layers; layer++) {
+    numberOfSlots.push_back(auxData.getValue(mapName, formatSlotsKey(layer)));
+  }
+  build(numberOfSlots);
+  if (fValues.empty()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < fValues.size(); i++) {
+    fValues[i] = auxData.getValue(mapName, std::to_string(i));
+  }
+  return true;
+}
@@ -0,0 +1,93 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file SlotThresholdTable.h
+ */
+
+#ifndef SLOTTHRESHOLDTABLE_H
+#define SLOTTHRESHOLDTABLE_H
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include <JPetAuxilliaryData/JPetAuxilliaryData.h>
+#include "LargeBarrelMapping.h"
+
+/**
+ * @brief Dense table of numbers (e.g. calibration constants) for every layer, slot and threshold.
+ *
+ * The values are stored in one array: the slots of layer 1, then of layer 2 etc., with
+ * kNumOfThresholds values per slot, so a lookup is an index computation and an array read.
+ * Missing values are NaN.
+ *
+ * The table is passed to the next tasks in the auxilliary data, in its own map:
+ * "layers" and "slots_<layer number>" give the layout and the key "<index>" the value
+ * of the cell with that index (NaN if missing). The string keys are used only when
+ * the table is saved or loaded (once per task), never in the lookups.
+ */
+class SlotThresholdTable
+{
+public:
+  static const int kNumOfThresholds = 4;
+
+  SlotThresholdTable();
+  /// Layout of the Large Barrel, all the values missing
+  explicit SlotThresholdTable(const LargeBarrelMapping& mapping);
+
+  void build(const LargeBarrelMapping& mapping);
+  /// Layout with the given number of slots in every layer, all the values missing
+  void build(const std::vector<int>& numberOfSlotsInLayers);
+
+  bool has(int layerNumber, int slotNumber, int thr) const
+  {
+    int index = getIndex(layerNumber, slotNumber, thr);
+    return index >= 0 && !std::isnan(fValues[index]);
+  }
+  /// NaN if missing
+  double get(int layerNumber, int slotNumber, int thr) const
+  {
+    int index = getIndex(layerNumber, slotNumber, thr);
+    return index >= 0 ? fValues[index] : std::numeric_limits<double>::quiet_NaN();
+  }
+  /// Returns false if the cell is outside of the table
+  bool set(int layerNumber, int slotNumber, int thr, double value);
+  int getNumberOfLayers() const
+  {
+    return static_cast<int>(fLayerOffsets.size()) - 1;
+  }
+
+  void saveToAuxilliaryData(JPetAuxilliaryData& auxData, const std::string& mapName) const;
+  /// Returns false (and leaves the table empty) if the map has no table
+  bool loadFromAuxilliaryData(JPetAuxilliaryData& auxData, const std::string& mapName);
+
+private:
+  /// -1 if outside of the table
+  int getIndex(int layerNumber, int slotNumber, int thr) const
+  {
+    if (layerNumber < 1 || layerNumber >= static_cast<int>(fLayerOffsets.size())
+        || thr < 1 || thr > kNumOfThresholds) {
+      return -1;
+    }
+    int first = fLayerOffsets[layerNumber - 1];
+    int cell = first + (slotNumber - 1) * kNumOfThresholds + thr - 1;
+    if (slotNumber < 1 || cell >= fLayerOffsets[layerNumber]) {
+      return -1;
+    }
+    return cell;
+  }
+
+  /// index of the first cell of each layer, and the number of cells at the end
+  std::vector<int> fLayerOffsets;
+  std::vector<double> fValues;
+};
+#endif /*  !SLOTTHRESHOLDTABLE_H */
@@ -0,0 +1,52 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE SlotThresholdTable
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+#include "SlotThresholdTable.h"
+
+BOOST_AUTO_TEST_SUITE (SlotThresholdTableSuite)
+
+BOOST_AUTO_TEST_CASE (setAndGet)
+{
+  SlotThresholdTable table;
+  table.build(std::vector<int>{3, 2});
+  BOOST_REQUIRE_EQUAL(table.getNumberOfLayers(), 2);
+  BOOST_REQUIRE(!table.has(1, 1, 1));
+  BOOST_REQUIRE(table.set(1, 3, 4, 1.5));
+  BOOST_REQUIRE(table.set(2, 1, 1, -2.5));
+  BOOST_REQUIRE(table.set(2, 2, 4, 0.));
+  BOOST_REQUIRE(table.has(1, 3, 4));
+  BOOST_REQUIRE_EQUAL(table.get(1, 3, 4), 1.5);
+  BOOST_REQUIRE_EQUAL(table.get(2, 1, 1), -2.5);
+  BOOST_REQUIRE(table.has(2, 2, 4));
+  BOOST_REQUIRE(!table.has(2, 2, 3));
+
+  /// cells outside of the table
+  BOOST_REQUIRE(!table.set(2, 3, 1, 1.));
+  BOOST_REQUIRE(!table.set(3, 1, 1, 1.));
+  BOOST_REQUIRE(!table.set(1, 1, 5, 1.));
+  BOOST_REQUIRE(!table.set(1, 0, 1, 1.));
+  BOOST_REQUIRE(!table.has(0, 1, 1));
+  BOOST_REQUIRE(std::isnan(table.get(1, 4, 1)));
+}
+
+BOOST_AUTO_TEST_CASE (auxilliaryData)
+{
+  SlotThresholdTable table;
+  table.build(std::vector<int>{3, 2});
+  table.set(1, 2, 3, 0.25);
+  table.set(2, 2, 1, -1.);
+  JPetAuxilliaryData auxData;
+  table.saveToAuxilliaryData(auxData, "test table");
+
+  SlotThresholdTable loaded;
+  BOOST_REQUIRE(loaded.loadFromAuxilliaryData(auxData, "test table"));
+  BOOST_REQUIRE_EQUAL(loaded.getNumberOfLayers(), 2);
+  BOOST_REQUIRE_EQUAL(loaded.get(1, 2, 3), 0.25);
+  BOOST_REQUIRE_EQUAL(loaded.get(2, 2, 1), -1.);
+  BOOST_REQUIRE(!loaded.has(1, 1, 1));
+  BOOST_REQUIRE(!loaded.has(2, 2, 4));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,209 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file StreamingWindowJoin.h
+ */
+
+#ifndef STREAMINGWINDOWJOIN_H
+#define STREAMINGWINDOWJOIN_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <vector>
+
+/**
+ * @brief Pairs objects from two sides of a stream (e.g. signals from the sides A and B
+ * of a scintillator) which have the same key within the same time window
+ * and whose times differ by less than the given width.
+ *
+ * The objects must come ordered by the time window index, as they do in the files of
+ * the consecutive tasks. The objects of one window are buffered per key; when an object
+ * from another window arrives (or flush() is called) every key is matched with a sorted
+ * merge: both sides are sorted by time and every left object is compared only with
+ * the right objects within the width, so the cost is linear in the number of objects
+ * and pairs. The pairs are passed to the match callback ordered by key, then by
+ * the time of the left and of the right object.
+ *
+ * The pairs of objects on the same side with the same key and within the width are not
+ * matched, only counted (see getSameSidePairCount()).
+ *
+ * At most maxBufferedObjects are kept; if a window is larger, the buffered part
+ * is matched early and the pairs between the two parts are lost (see getOverflowCount()).
+ * The buffers are reused between the windows; only the keys which got objects since
+ * the last match are visited, so the cost does not grow with the number of keys ever seen.
+ *
+ * The times are double by default; with Time = IntegerTime::TimePs (integer ps) the sorting
+ * and the width checks are exact.
+ */
+template<class T, class Key = int, class Time = double>
+class StreamingWindowJoin
+{
+public:
+  typedef std::function<void(const T& left, const T& right)> MatchCallback;
+  typedef std::function<void(long long window)> WindowCallback;
+
+  /// width: maximal time difference of a pair; infinity pairs all the objects with the same key
+  StreamingWindowJoin(Time width, std::size_t maxBufferedObjects, MatchCallback onMatch):
+    fWidth(width),
+    fMaxBufferedObjects(maxBufferedObjects),
+    fOnMatch(onMatch)
+  {
+    /**/
+  }
+
+  /// Called after all the pairs of a window were passed to the match callback
+  void setWindowCallback(WindowCallback onWindowEnd)
+  {
+    fOnWindowEnd = onWindowEnd;
+  }
+
+  void add(long long window, const Key& key, bool left, Time time, const T& object)
+  {
+    if (fBuffered > 0 && window != fWindow) {
+      flush();
+    }
+    if (fBuffered >= fMaxBufferedObjects) {
+      fOverflowCount++;
+      match();
+    }
+    fWindow = window;
+    auto buffer = fBuffers.insert(std::make_pair(key, Sides())).first;
+    auto& sides = buffer->second;
+    if (!sides.fIsTouched) {
+      sides.fIsTouched = true;
+      fTouched.push_back(buffer);
+    }
+    (left ? sides.fLeft : sides.fRight).push_back(Entry{time, object});
+    fBuffered++;
+  }
+
+  /// Matches all the buffered objects and closes the current window
+  void flush()
+  {
+    if (fBuffered == 0) {
+      return;
+    }
+    match();
+    if (fOnWindowEnd) {
+      fOnWindowEnd(fWindow);
+    }
+  }
+
+  /// Drops all the buffered objects without matching them
+  void clear()
+  {
+    for (auto buffer : fTouched) {
+      buffer->second.fLeft.clear();
+      buffer->second.fRight.clear();
+      buffer->second.fIsTouched = false;
+    }
+    fTouched.clear();
+    fBuffered = 0;
+  }
+
+  std::size_t getBufferedCount() const
+  {
+    return fBuffered;
+  }
+  std::size_t getOverflowCount() const
+  {
+    return fOverflowCount;
+  }
+  /// Number of the pairs of objects on the same side, with the same key and within the width,
+  /// in all the windows matched so far
+  std::size_t getSameSidePairCount() const
+  {
+    return fSameSidePairCount;
+  }
+
+private:
+  struct Entry {
+    Time fTime;
+    T fObject;
+  };
+  struct Sides {
+    std::vector<Entry> fLeft;
+    std::vector<Entry> fRight;
+    bool fIsTouched = false;
+  };
+  typedef typename std::map<Key, Sides>::iterator BufferIterator;
+
+  static bool earlier(const Entry& first, const Entry& second)
+  {
+    return first.fTime < second.fTime;
+  }
+
+  static bool lowerKey(const BufferIterator& first, const BufferIterator& second)
+  {
+    return first->first < second->first;
+  }
+
+  /// Pairs within the width in one side sorted by time
+  std::size_t countSameSidePairs(const std::vector<Entry>& side) const
+  {
+    std::size_t count = 0;
+    std::size_t first = 0;
+    for (std::size_t i = 0; i < side.size(); i++) {
+      while (side[i].fTime - side[first].fTime >= fWidth) {
+        first++;
+      }
+      count += i - first;
+    }
+    return count;
+  }
+
+  void match()
+  {
+    std::sort(fTouched.begin(), fTouched.end(), lowerKey);
+    for (auto buffer : fTouched) {
+      auto& left = buffer->second.fLeft;
+      auto& right = buffer->second.fRight;
+      std::stable_sort(left.begin(), left.end(), earlier);
+      std::stable_sort(right.begin(), right.end(), earlier);
+      fSameSidePairCount += countSameSidePairs(left) + countSameSidePairs(right);
+      if (!left.empty() && !right.empty()) {
+        std::size_t first = 0;
+        for (const auto& l : left) {
+          /// right objects too early for this left object are too early for all the next ones
+          /// differences of the times, as the width may be the largest value of Time
+          while (first < right.size() && l.fTime - right[first].fTime >= fWidth) {
+            first++;
+          }
+          for (auto r = first; r < right.size() && right[r].fTime - l.fTime < fWidth; r++) {
+            fOnMatch(l.fObject, right[r].fObject);
+          }
+        }
+      }
+      left.clear();
+      right.clear();
+      buffer->second.fIsTouched = false;
+    }
+    fTouched.clear();
+    fBuffered = 0;
+  }
+
+  Time fWidth;
+  std::size_t fMaxBufferedObjects;
+  MatchCallback fOnMatch;
+  WindowCallback fOnWindowEnd;
+  /// std::map keeps the keys ordered, so the order of the pairs does not depend on the input order
+  std::map<Key, Sides> fBuffers;
+  /// keys with objects since the last match, flagged with Sides::fIsTouched
+  std::vector<BufferIterator> fTouched;
+  long long fWindow = 0;
+  std::size_t fBuffered = 0;
+  std::size_t fOverflowCount = 0;
+  std::size_t fSameSidePairCount = 0;
+};
+#endif /*  !STREAMINGWINDOWJOIN_H */
@@ -0,0 +1,162 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE StreamingWindowJoin
+#include <boost/test/unit_test.hpp>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "IntegerTime.h"
+#include "StreamingWindowJoin.h"
+
+typedef std::pair<int, int> Pair;
+
+BOOST_AUTO_TEST_SUITE (StreamingWindowJoinSuite)
+
+BOOST_AUTO_TEST_CASE (matchWithinWidth)
+{
+  std::vector<Pair> pairs;
+  std::vector<long long> windows;
+  StreamingWindowJoin<int> join(10., 1000, [&pairs](const int& left, const int& right) {
+    pairs.push_back(std::make_pair(left, right));
+  });
+  join.setWindowCallback([&windows](long long window) {
+    windows.push_back(window);
+  });
+  /// objects are their own times; keys 1 and 2
+  join.add(0, 1, true, 100., 100);
+  join.add(0, 1, false, 95., 95);
+  join.add(0, 1, false, 130., 130);
+  join.add(0, 1, true, 125., 125);
+  join.add(0, 1, false, 110., 110);
+  join.add(0, 2, true, 100., 100);
+  join.add(0, 3, false, 100., 100);
+  BOOST_REQUIRE(pairs.empty());
+  join.add(1, 1, true, 0., 0);
+  std::vector<Pair> expected = {{100, 95}, {125, 130}};
+  BOOST_REQUIRE(pairs == expected);
+  BOOST_REQUIRE_EQUAL(windows.size(), 1u);
+  BOOST_REQUIRE_EQUAL(windows.front(), 0);
+  join.add(1, 1, false, 9.99, 9);
+  join.add(1, 1, false, 10., 10);
+  join.flush();
+  BOOST_REQUIRE_EQUAL(pairs.size(), 3u);
+  BOOST_REQUIRE(pairs.back() == Pair(0, 9));
+  BOOST_REQUIRE_EQUAL(windows.back(), 1);
+  join.flush();
+  BOOST_REQUIRE_EQUAL(windows.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE (allPairsOrderedByKeyAndTime)
+{
+  std::vector<Pair> pairs;
+  StreamingWindowJoin<int> join(std::numeric_limits<double>::infinity(), 1000,
+  [&pairs](const int& left, const int& right) {
+    pairs.push_back(std::make_pair(left, right));
+  });
+  join.add(5, 7, false, 2., 72);
+  join.add(5, 3, true, 1., 31);
+  join.add(5, 7, true, 1., 71);
+  join.add(5, 3, false, 4., 34);
+  join.add(5, 3, false, 3., 33);
+  join.flush();
+  std::vector<Pair> expected = {{31, 33}, {31, 34}, {71, 72}};
+  BOOST_REQUIRE(pairs == expected);
+}
+
+BOOST_AUTO_TEST_CASE (keysOfEarlierWindowsAreReused)
+{
+  std::vector<Pair> pairs;
+  StreamingWindowJoin<int> join(std::numeric_limits<double>::infinity(), 1000,
+  [&pairs](const int& left, const int& right) {
+    pairs.push_back(std::make_pair(left, right));
+  });
+  join.add(0, 9, true, 1., 91);
+  join.add(0, 4, true, 1., 41);
+  join.add(0, 4, false, 2., 42);
+  join.add(1, 9, false, 2., 92);
+  join.add(1, 2, true, 1., 21);
+  join.add(1, 2, false, 2., 22);
+  join.flush();
+  /// the left object of key 9 in window 0 is not matched with the right one of window 1
+  std::vector<Pair> expected = {{41, 42}, {21, 22}};
+  BOOST_REQUIRE(pairs == expected);
+  join.add(2, 4, true, 1., 43);
+  join.clear();
+  join.add(3, 4, false, 2., 44);
+  join.add(3, 9, true, 1., 93);
+  join.add(3, 9, false, 2., 94);
+  join.flush();
+  expected.push_back(Pair(93, 94));
+  BOOST_REQUIRE(pairs == expected);
+}
+
+BOOST_AUTO_TEST_CASE (bufferIsBounded)
+{
+  std::size_t matched = 0;
+  StreamingWindowJoin<int> join(std::numeric_limits<double>::infinity(), 4,
+  [&matched](const int&, const int&) {
+    matched++;
+  });
+  for (int i = 0; i < 10; i++) {
+    join.add(0, 1, i % 2 == 0, i, i);
+    BOOST_REQUIRE(join.getBufferedCount() <= 4u);
+  }
+  join.flush();
+  BOOST_REQUIRE_EQUAL(join.getOverflowCount(), 2u);
+  /// 4 + 4 + 2 objects matched separately, each part with 2x2, 2x2 and 1x1 pairs
+  BOOST_REQUIRE_EQUAL(matched, 9u);
+  join.add(1, 1, true, 0., 0);
+  join.clear();
+  BOOST_REQUIRE_EQUAL(join.getBufferedCount(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE (integerTimes)
+{
+  std::vector<Pair> pairs;
+  StreamingWindowJoin<int, int, IntegerTime::TimePs> join(10000, 1000,
+  [&pairs](const int& left, const int& right) {
+    pairs.push_back(std::make_pair(left, right));
+  });
+  /// times in ps, far from zero as in the time windows
+  const IntegerTime::TimePs start = -999999000;
+  join.add(0, 1, true, start, 1);
+  join.add(0, 1, false, start + 9999, 2);
+  join.add(0, 1, false, start + 10000, 3);
+  join.add(0, 1, false, start - 10000, 4);
+  join.add(0, 1, false, start - 9999, 5);
+  join.flush();
+  std::vector<Pair> expected = {{1, 5}, {1, 2}};
+  BOOST_REQUIRE(pairs == expected);
+
+  pairs.clear();
+  StreamingWindowJoin<int, int, IntegerTime::TimePs> allPairs(std::numeric_limits<IntegerTime::TimePs>::max(), 1000,
+  [&pairs](const int& left, const int& right) {
+    pairs.push_back(std::make_pair(left, right));
+  });
+  allPairs.add(0, 1, true, start, 1);
+  allPairs.add(0, 1, false, -start, 2);
+  allPairs.flush();
+  BOOST_REQUIRE_EQUAL(pairs.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE (sameSidePairsCounted)
+{
+  std::size_t matched = 0;
+  StreamingWindowJoin<int> join(10., 1000, [&matched](const int&, const int&) {
+    matched++;
+  });
+  /// key 1: 3 left signals within the width, 2 right ones out of it
+  join.add(0, 1, true, 100., 0);
+  join.add(0, 1, true, 105., 0);
+  join.add(0, 1, true, 109., 0);
+  join.add(0, 1, false, 100., 0);
+  join.add(0, 1, false, 130., 0);
+  /// key 2: only the right side
+  join.add(0, 2, false, 0., 0);
+  join.add(0, 2, false, 1., 0);
+  join.flush();
+  BOOST_REQUIRE_EQUAL(matched, 3u);
+  BOOST_REQUIRE_EQUAL(join.getSameSidePairCount(), 3u + 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,100 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file TaskOptions.cpp
+ */
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include "TaskOptions.h"
+#include "JPetLoggerInclude.h"
+
+namespace
+{
+/// Finds the option; false if it is not given
+bool find(const TaskOptions::Options& opts, const std::string& key, std::string& text)
+{
+  auto option = opts.find(key);
+  if (option == opts.end()) {
+    return false;
+  }
+  text = option->second;
+  return true;
+}
+
+/// The whole text must be parsed, without a range error
+bool isParsed(const std::string& text, const char* end)
+{
+  return !text.empty() && end == text.c_str() + text.size() && errno != ERANGE;
+}
+
+void reportBadValue(const std::string& key, const std::string& text, const std::string& type, const std::string& defaultValue)
+{
+  ERROR("Wrong value \"" + text + "\" of the option " + key + ", " + type + " expected; the default "
+        + defaultValue + " is used");
+}
+}
+
+bool TaskOptions::read(const Options& opts, const std::string& key, std::size_t& value)
+{
+  std::string text;
+  if (!find(opts, key, text)) {
+    return false;
+  }
+  errno = 0;
+  char* end = nullptr;
+  /// strtoull accepts a sign and negates the value
+  const auto first = text.find_first_not_of(" \t");
+  const bool isNegative = (first != std::string::npos && text[first] == '-');
+  const unsigned long long parsed = std::strtoull(text.c_str(), &end, 10);
+  if (isNegative || !isParsed(text, end) || parsed > static_cast<unsigned long long>(static_cast<std::size_t>(-1))) {
+    reportBadValue(key, text, "an unsigned integer", std::to_string(value));
+    return false;
+  }
+  value = parsed;
+  return true;
+}
+
+bool TaskOptions::read(const Options& opts, const std::string& key, int& value)
+{
+  std::string text;
+  if (!find(opts, key, text)) {
+    return false;
+  }
+  errno = 0;
+  char* end = nullptr;
+  const long parsed = std::strtol(text.c_str(), &end, 10);
+  if (!isParsed(text, end) || parsed < INT_MIN || parsed > INT_MAX) {
+    reportBadValue(key, text, "an integer", std::to_string(value));
+    return false;
+  }
+  value = parsed;
+  return true;
+}
+
+bool TaskOptions::read(const Options& opts, const std::string& key, double& value)
+{
+  std::string text;
+  if (!find(opts, key, text)) {
+    return false;
+  }
+  errno = 0;
+  char* end = nullptr;
+  const double parsed = std::strtod(text.c_str(), &end);
+  if (!isParsed(text, end)) {
+    reportBadValue(key, text, "a number", std::to_string(value));
+    return false;
+  }
+  value = parsed;
+  return true;
+}
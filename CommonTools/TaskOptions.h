@@ -0,0 +1,40 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file TaskOptions.h
+ */
+
+#ifndef TASKOPTIONS_H
+#define TASKOPTIONS_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+/**
+ * @brief Checked reading of the numeric user options of the tasks.
+ *
+ * If the option is present, its whole value must be a number of the requested type
+ * (an unsigned one for std::size_t). A malformed or out of range value is reported
+ * as ERROR and the value keeps its default, instead of an exception ending the run.
+ * The functions return true if the value was read from the options.
+ */
+namespace TaskOptions
+{
+/// the same as JPetTaskInterface::Options
+typedef std::map<std::string, std::string> Options;
+
+bool read(const Options& opts, const std::string& key, std::size_t& value);
+bool read(const Options& opts, const std::string& key, int& value);
+bool read(const Options& opts, const std::string& key, double& value);
+}
+#endif /*  !TASKOPTIONS_H */
@@ -0,0 +1,57 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE TaskOptions
+#include <boost/test/unit_test.hpp>
+
+#include "TaskOptions.h"
+
+BOOST_AUTO_TEST_SUITE (TaskOptionsSuite)
+
+BOOST_AUTO_TEST_CASE (wellFormedValues)
+{
+  TaskOptions::Options opts = {{"Task_Size", "123"}, {"Task_Int", "-7"}, {"Task_Double", "2.5e3"}};
+  std::size_t size = 1;
+  int integer = 1;
+  double number = 1.;
+  BOOST_REQUIRE(TaskOptions::read(opts, "Task_Size", size));
+  BOOST_REQUIRE_EQUAL(size, 123u);
+  BOOST_REQUIRE(TaskOptions::read(opts, "Task_Int", integer));
+  BOOST_REQUIRE_EQUAL(integer, -7);
+  BOOST_REQUIRE(TaskOptions::read(opts, "Task_Double", number));
+  BOOST_REQUIRE_EQUAL(number, 2500.);
+}
+
+BOOST_AUTO_TEST_CASE (missingValuesKeepDefaults)
+{
+  TaskOptions::Options opts;
+  std::size_t size = 5;
+  double number = 0.5;
+  BOOST_REQUIRE(!TaskOptions::read(opts, "Task_Size", size));
+  BOOST_REQUIRE_EQUAL(size, 5u);
+  BOOST_REQUIRE(!TaskOptions::read(opts, "Task_Double", number));
+  BOOST_REQUIRE_EQUAL(number, 0.5);
+}
+
+BOOST_AUTO_TEST_CASE (malformedValuesKeepDefaults)
+{
+  TaskOptions::Options opts = {
+    {"Empty", ""}, {"Text", "four"}, {"Trailing", "12abc"}, {"Negative", "-3"},
+    {"Fraction", "1.5"}, {"TooLarge", "99999999999999999999999"}, {"NotNumber", "1e"}
+  };
+  for (const auto& key : {"Empty", "Text", "Trailing", "Negative", "Fraction", "TooLarge"}) {
+    std::size_t size = 5;
+    BOOST_CHECK(!TaskOptions::read(opts, key, size));
+    BOOST_CHECK_EQUAL(size, 5u);
+  }
+  for (const auto& key : {"Empty", "Text", "Trailing", "Fraction", "TooLarge"}) {
+    int integer = -2;
+    BOOST_CHECK(!TaskOptions::read(opts, key, integer));
+    BOOST_CHECK_EQUAL(integer, -2);
+  }
+  for (const auto& key : {"Empty", "Text", "Trailing", "NotNumber"}) {
+    double number = 0.5;
+    BOOST_CHECK(!TaskOptions::read(opts, key, number));
+    BOOST_CHECK_EQUAL(number, 0.5);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,126 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file TimeDeltaCodec.cpp
+ */
+
+#include <algorithm>
+#include <numeric>
+#include "TimeDeltaCodec.h"
+
+void TimeDeltaCodec::putVarint(std::vector<char>& buffer, std::uint64_t value)
+{
+  while (value >= 0x80) {
+    buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  buffer.push_back(static_cast<char>(value));
+}
+
+bool TimeDeltaCodec::getVarint(const char*& position, const char* end, std::uint64_t& value)
+{
+  value = 0;
+  for (int shift = 0; shift < 64 && position < end; shift += 7) {
+    auto byte = static_cast<unsigned char>(*position++);
+    value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void TimeDeltaCodec::encodeWindow(const PackedTimeWindow& window, std::vector<char>& buffer)
+{
+  const auto& sigChs = window.getSigChs();
+  std::vector<std::uint32_t> order(sigChs.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+  [&sigChs](std::uint32_t first, std::uint32_t second) {
+    if (sigChs[first].fChannel != sigChs[second].fChannel) {
+      return sigChs[first].fChannel < sigChs[second].fChannel;
+    }
+    return sigChs[first].fTime < sigChs[second].fTime;
+  });
+  bool sorted = true;
+  for (std::size_t i = 0; i < order.size() && sorted; i++) {
+    sorted = (order[i] == i);
+  }
+
+  putVarint(buffer, window.getIndex());
+  putVarint(buffer, sigChs.size());
+  buffer.push_back(sorted ? 1 : 0);
+  if (!sorted) {
+    for (auto position : order) {
+      putVarint(buffer, position);
+    }
+  }
+  std::int64_t previousChannel = 0;
+  IntegerTime::TimePs previousTime = 0;
+  for (auto position : order) {
+    const PackedSigCh& sigCh = sigChs[position];
+    putVarint(buffer, zigZagEncode(static_cast<std::int64_t>(sigCh.fChannel) - previousChannel));
+    buffer.push_back(static_cast<char>(sigCh.fEdge));
+    buffer.push_back(static_cast<char>(sigCh.fThresholdNumber));
+    /// the differences of the times of one window are far from overflowing
+    putVarint(buffer, zigZagEncode(sigCh.fTime - previousTime));
+    previousChannel = sigCh.fChannel;
+    previousTime = sigCh.fTime;
+  }
+}
+
+bool TimeDeltaCodec::decodeWindow(const char*& position, const char* end, PackedTimeWindow& window)
+{
+  std::uint64_t index = 0;
+  std::uint64_t size = 0;
+  if (!getVarint(position, end, index) || !getVarint(position, end, size)
+      || position >= end || size > static_cast<std::uint64_t>(end - position)) {
+    return false;
+  }
+  bool sorted = (*position++ != 0);
+  window.setIndex(index);
+  auto& sigChs = window.getSigChs();
+  sigChs.resize(size);
+  std::vector<std::uint64_t> order;
+  if (!sorted) {
+    order.resize(size);
+    /// the order must be a permutation, so that every SigCh of the window is filled once
+    std::vector<bool> filled(size, false);
+    for (auto& original : order) {
+      if (!getVarint(position, end, original) || original >= size || filled[original]) {
+        return false;
+      }
+      filled[original] = true;
+    }
+  }
+  std::int64_t channel = 0;
+  IntegerTime::TimePs time = 0;
+  for (std::uint64_t i = 0; i < size; i++) {
+    std::uint64_t channelDelta = 0;
+    std::uint64_t timeDelta = 0;
+    if (!getVarint(position, end, channelDelta) || end - position < 2) {
+      return false;
+    }
+    PackedSigCh sigCh;
+    sigCh.fEdge = static_cast<std::uint8_t>(*position++);
+    sigCh.fThresholdNumber = static_cast<std::uint8_t>(*position++);
+    if (!getVarint(position, end, timeDelta)) {
+      return false;
+    }
+    channel += zigZagDecode(channelDelta);
+    time += zigZagDecode(timeDelta);
+    sigCh.fChannel = static_cast<std::uint32_t>(channel);
+    sigCh.fTime = time;
+    sigChs[sorted ? i : order[i]] = sigCh;
+  }
+  return true;
+}
@@ -0,0 +1,59 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file TimeDeltaCodec.h
+ */
+
+#ifndef TIMEDELTACODEC_H
+#define TIMEDELTACODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "PackedTimeWindow.h"
+
+/**
+ * @brief Compact encoding of the signal channels of a time window.
+ *
+ * The signal channels are sorted by channel and time, and every record is stored as
+ * the differences of its channel and time from the previous record, zig-zag mapped
+ * (so small negative differences are small numbers too) and written as varints:
+ * 7 bits per byte, the highest bit set if more bytes follow. A channel with a few
+ * edges close in time then takes a few bytes per edge instead of 16.
+ * The original order of the records is restored on decoding; it costs one varint
+ * per record only if the window was not sorted already.
+ *
+ * Window layout: varint index, varint number of records N, byte sorted flag,
+ * [N varints: original position of every sorted record, if not sorted],
+ * N x {varint zig-zag channel delta, byte edge, byte threshold number, varint zig-zag time delta}.
+ */
+namespace TimeDeltaCodec
+{
+inline std::uint64_t zigZagEncode(std::int64_t value)
+{
+  return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+inline std::int64_t zigZagDecode(std::uint64_t value)
+{
+  return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+void putVarint(std::vector<char>& buffer, std::uint64_t value);
+/// Reads a varint at position and moves position past it; false if the data ends before it does
+bool getVarint(const char*& position, const char* end, std::uint64_t& value);
+
+/// Appends the encoded window to buffer
+void encodeWindow(const PackedTimeWindow& window, std::vector<char>& buffer);
+/// Decodes the window at position and moves position past it; false on corrupted data
+bool decodeWindow(const char*& position, const char* end, PackedTimeWindow& window);
+}
+#endif /*  !TIMEDELTACODEC_H */
@@ -0,0 +1,120 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE TimeDeltaCodec
+#include <boost/test/unit_test.hpp>
+#include <limits>
+#include <vector>
+
+#include "TimeDeltaCodec.h"
+
+namespace
+{
+void checkEqual(const PackedTimeWindow& window, const PackedTimeWindow& expected)
+{
+  BOOST_REQUIRE_EQUAL(window.getIndex(), expected.getIndex());
+  BOOST_REQUIRE_EQUAL(window.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); i++) {
+    BOOST_REQUIRE_EQUAL(window[i].fChannel, expected[i].fChannel);
+    BOOST_REQUIRE_EQUAL(window[i].fEdge, expected[i].fEdge);
+    BOOST_REQUIRE_EQUAL(window[i].fThresholdNumber, expected[i].fThresholdNumber);
+    BOOST_REQUIRE_EQUAL(window[i].fTime, expected[i].fTime);
+  }
+}
+}
+
+BOOST_AUTO_TEST_SUITE (TimeDeltaCodecSuite)
+
+BOOST_AUTO_TEST_CASE (zigZagAndVarints)
+{
+  for (std::int64_t value : {std::int64_t(0), std::int64_t(-1), std::int64_t(1), std::int64_t(-1000000000),
+                             std::numeric_limits<std::int64_t>::max(), std::numeric_limits<std::int64_t>::min()}) {
+    BOOST_REQUIRE_EQUAL(TimeDeltaCodec::zigZagDecode(TimeDeltaCodec::zigZagEncode(value)), value);
+  }
+  BOOST_REQUIRE_EQUAL(TimeDeltaCodec::zigZagEncode(-1), 1u);
+  BOOST_REQUIRE_EQUAL(TimeDeltaCodec::zigZagEncode(1), 2u);
+
+  std::vector<char> buffer;
+  TimeDeltaCodec::putVarint(buffer, 127);
+  BOOST_REQUIRE_EQUAL(buffer.size(), 1u);
+  TimeDeltaCodec::putVarint(buffer, 128);
+  BOOST_REQUIRE_EQUAL(buffer.size(), 3u);
+  TimeDeltaCodec::putVarint(buffer, std::numeric_limits<std::uint64_t>::max());
+  const char* position = buffer.data();
+  const char* end = buffer.data() + buffer.size();
+  std::uint64_t value = 0;
+  BOOST_REQUIRE(TimeDeltaCodec::getVarint(position, end, value));
+  BOOST_REQUIRE_EQUAL(value, 127u);
+  BOOST_REQUIRE(TimeDeltaCodec::getVarint(position, end, value));
+  BOOST_REQUIRE_EQUAL(value, 128u);
+  BOOST_REQUIRE(TimeDeltaCodec::getVarint(position, end, value));
+  BOOST_REQUIRE_EQUAL(value, std::numeric_limits<std::uint64_t>::max());
+  BOOST_REQUIRE(position == end);
+  BOOST_REQUIRE(!TimeDeltaCodec::getVarint(position, end, value));
+}
+
+BOOST_AUTO_TEST_CASE (windowsKeepTheirOrder)
+{
+  PackedTimeWindow sorted;
+  sorted.setIndex(12);
+  sorted.add(100, JPetSigCh::Leading, 1, -500000.);
+  sorted.add(100, JPetSigCh::Trailing, 1, -480000.);
+  sorted.add(101, JPetSigCh::Leading, 2, -500100.);
+  PackedTimeWindow unsorted;
+  unsorted.setIndex(13);
+  unsorted.add(2050, JPetSigCh::Trailing, 4, -999999999.);
+  unsorted.add(7, JPetSigCh::Leading, 1, 0.);
+  unsorted.add(2050, JPetSigCh::Leading, 4, -1000000000.);
+  unsorted.add(7, JPetSigCh::Leading, 1, 0.);
+  PackedTimeWindow empty;
+  empty.setIndex(14);
+
+  std::vector<char> buffer;
+  TimeDeltaCodec::encodeWindow(sorted, buffer);
+  std::size_t sortedSize = buffer.size();
+  TimeDeltaCodec::encodeWindow(unsorted, buffer);
+  TimeDeltaCodec::encodeWindow(empty, buffer);
+  /// index, size, flag and 3 x (channel, edge, threshold, time of at most 3 bytes)
+  BOOST_REQUIRE(sortedSize < 3 + 3 * 2 * sizeof(std::uint32_t));
+
+  const char* position = buffer.data();
+  const char* end = buffer.data() + buffer.size();
+  PackedTimeWindow window;
+  BOOST_REQUIRE(TimeDeltaCodec::decodeWindow(position, end, window));
+  checkEqual(window, sorted);
+  BOOST_REQUIRE(TimeDeltaCodec::decodeWindow(position, end, window));
+  checkEqual(window, unsorted);
+  BOOST_REQUIRE(TimeDeltaCodec::decodeWindow(position, end, window));
+  checkEqual(window, empty);
+  BOOST_REQUIRE(position == end);
+
+  /// truncated data
+  position = buffer.data();
+  BOOST_REQUIRE(!TimeDeltaCodec::decodeWindow(position, buffer.data() + sortedSize - 1, window));
+}
+
+BOOST_AUTO_TEST_CASE (orderMustBePermutation)
+{
+  /// unsorted window of 2 SigChs, both moved to the position 0
+  std::vector<char> buffer;
+  TimeDeltaCodec::putVarint(buffer, 5);
+  TimeDeltaCodec::putVarint(buffer, 2);
+  buffer.push_back(0);
+  TimeDeltaCodec::putVarint(buffer, 0);
+  TimeDeltaCodec::putVarint(buffer, 0);
+  for (int i = 0; i < 2; i++) {
+    TimeDeltaCodec::putVarint(buffer, 0);
+    buffer.push_back(JPetSigCh::Leading);
+    buffer.push_back(1);
+    TimeDeltaCodec::putVarint(buffer, 0);
+  }
+  const char* position = buffer.data();
+  PackedTimeWindow window;
+  BOOST_REQUIRE(!TimeDeltaCodec::decodeWindow(position, buffer.data() + buffer.size(), window));
+
+  /// the same window with the positions 1 and 0 is valid
+  buffer[4] = 1;
+  position = buffer.data();
+  BOOST_REQUIRE(TimeDeltaCodec::decodeWindow(position, buffer.data() + buffer.size(), window));
+  BOOST_REQUIRE_EQUAL(window.size(), 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,338 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file WaveformFile.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "WaveformFile.h"
+#include "JPetLoggerInclude.h"
+
+using namespace WaveformFile;
+
+namespace
+{
+const char kMagic[4] = {'J', 'P', 'W', 'F'};
+const char kEndMagic[4] = {'J', 'P', 'W', 'E'};
+const std::uint32_t kVersion = 3;
+/// read as 0x04030201 on a machine with the other byte order
+const std::uint32_t kByteOrderMark = 0x01020304;
+const std::size_t kFileHeaderSize = 16;
+const std::size_t kRecordHeaderSize = 48;
+const std::size_t kIndexEntrySize = 24;
+const std::size_t kTrailerSize = 16;
+const std::size_t kAlignment = 8;
+
+inline std::size_t padding(std::size_t size)
+{
+  return (kAlignment - size % kAlignment) % kAlignment;
+}
+
+template<class T>
+void append(std::vector<char>& buffer, const T& value)
+{
+  const char* bytes = reinterpret_cast<const char*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template<class T>
+T read(const char* data)
+{
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+}
+
+Writer::Writer(const std::string& fileName, int compressionLevel, std::size_t blockSize):
+  fFileName(fileName),
+  fCompressionLevel(compressionLevel),
+  fBlockSize(blockSize)
+{
+  fFile = std::fopen(fileName.c_str(), "wb");
+  if (!fFile) {
+    return;
+  }
+  const std::uint32_t reserved = 0;
+  writeBytes(kMagic, sizeof(kMagic));
+  writeBytes(&kVersion, sizeof(kVersion));
+  writeBytes(&kByteOrderMark, sizeof(kByteOrderMark));
+  writeBytes(&reserved, sizeof(reserved));
+  fOffset = kFileHeaderSize;
+  fBlock.reserve(fBlockSize + kRecordHeaderSize);
+}
+
+Writer::~Writer()
+{
+  close();
+}
+
+bool Writer::isOpen() const
+{
+  return fFile != nullptr && !fFailed;
+}
+
+void Writer::writeBytes(const void* data, std::size_t size)
+{
+  if (fFailed || size == 0) {
+    return;
+  }
+  if (std::fwrite(data, 1, size, fFile) != size) {
+    ERROR("Cannot write the waveform file " + fFileName);
+    fFailed = true;
+  }
+}
+
+void Writer::add(const WaveformView& waveform)
+{
+  if (!isOpen()) {
+    return;
+  }
+  append(fBlock, static_cast<std::uint32_t>(waveform.fSize));
+  append(fBlock, waveform.fPMID);
+  append(fBlock, waveform.fEvent);
+  append(fBlock, waveform.fTimeStart);
+  append(fBlock, waveform.fTimeStep);
+  append(fBlock, waveform.fGain);
+  append(fBlock, waveform.fZero);
+  const char* samples = reinterpret_cast<const char*>(waveform.fSamples);
+  fBlock.insert(fBlock.end(), samples, samples + waveform.fSize * sizeof(std::int16_t));
+  fBlock.resize(fBlock.size() + padding(fBlock.size()), 0);
+  fBlockWaveforms++;
+  fWaveformCount++;
+  if (fBlock.size() >= fBlockSize) {
+    flushBlock();
+  }
+}
+
+void Writer::add(std::uint64_t event, std::int32_t pmID, const double* times, const double* amplitudes,
+                 std::size_t n, double gain)
+{
+  WaveformView waveform;
+  waveform.fEvent = event;
+  waveform.fPMID = pmID;
+  waveform.fSize = n;
+  if (n > 0) {
+    waveform.fTimeStart = times[0];
+    waveform.fTimeStep = (n > 1) ? (times[n - 1] - times[0]) / (n - 1) : 0.;
+    auto range = std::minmax_element(amplitudes, amplitudes + n);
+    if (gain > 0.) {
+      waveform.fGain = gain;
+      waveform.fZero = 0.;
+    } else {
+      waveform.fZero = 0.5 * (*range.first + *range.second);
+      waveform.fGain = (*range.second - *range.first) / 65534.;
+      if (waveform.fGain <= 0.) {
+        waveform.fGain = 1.;
+      }
+    }
+    fQuantized.resize(n);
+    for (std::size_t i = 0; i < n; i++) {
+      double counts = std::round((amplitudes[i] - waveform.fZero) / waveform.fGain);
+      counts = std::max(-32767., std::min(32767., counts));
+      fQuantized[i] = static_cast<std::int16_t>(counts);
+    }
+    waveform.fSamples = fQuantized.data();
+  }
+  add(waveform);
+}
+
+void Writer::flushBlock()
+{
+  if (!isOpen() || fBlockWaveforms == 0) {
+    return;
+  }
+  const char* stored = fBlock.data();
+  std::uint32_t storedSize = fBlock.size();
+  std::uint32_t compressed = 0;
+  if (fCompressionLevel > 0) {
+    uLongf compressedSize = compressBound(fBlock.size());
+    fCompressed.resize(compressedSize);
+    if (compress2(reinterpret_cast<Bytef*>(fCompressed.data()), &compressedSize,
+                  reinterpret_cast<const Bytef*>(fBlock.data()), fBlock.size(), fCompressionLevel) == Z_OK
+        && compressedSize < fBlock.size()) {
+      stored = fCompressed.data();
+      storedSize = compressedSize;
+      compressed = 1;
+    }
+  }
+  writeBytes(stored, storedSize);
+  /// blocks start at aligned offsets, so the samples of uncompressed blocks are aligned in the mapping
+  const char zeros[kAlignment] = {0};
+  writeBytes(zeros, padding(storedSize));
+  append(fIndex, fOffset);
+  append(fIndex, storedSize);
+  append(fIndex, static_cast<std::uint32_t>(fBlock.size()));
+  append(fIndex, fBlockWaveforms);
+  append(fIndex, compressed);
+  fOffset += storedSize + padding(storedSize);
+  fBlockCount++;
+  fBlock.clear();
+  fBlockWaveforms = 0;
+}
+
+bool Writer::close()
+{
+  if (!fFile) {
+    return !fFailed;
+  }
+  flushBlock();
+  writeBytes(fIndex.data(), fIndex.size());
+  writeBytes(&fOffset, sizeof(fOffset));
+  writeBytes(&fBlockCount, sizeof(fBlockCount));
+  writeBytes(kEndMagic, sizeof(kEndMagic));
+  /// the buffered data are written only now, so the errors may show up here
+  if (std::fclose(fFile) != 0 && !fFailed) {
+    ERROR("Cannot write the waveform file " + fFileName);
+    fFailed = true;
+  }
+  fFile = nullptr;
+  return !fFailed;
+}
+
+Reader::Reader(const std::string& fileName)
+{
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat status;
+  if (fstat(fd, &status) == 0 && status.st_size > 0) {
+    void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      fData = static_cast<const char*>(data);
+      fSize = status.st_size;
+      madvise(data, fSize, MADV_SEQUENTIAL);
+    }
+  }
+  close(fd);
+  if (fData && !readIndex()) {
+    munmap(const_cast<char*>(fData), fSize);
+    fData = nullptr;
+    fBlocks.clear();
+  }
+}
+
+Reader::~Reader()
+{
+  if (fData) {
+    munmap(const_cast<char*>(fData), fSize);
+  }
+}
+
+bool Reader::isOpen() const
+{
+  return fData != nullptr;
+}
+
+std::size_t Reader::getWaveformCount() const
+{
+  std::size_t count = 0;
+  for (const auto& block : fBlocks) {
+    count += block.fWaveforms;
+  }
+  return count;
+}
+
+bool Reader::readIndex()
+{
+  if (fSize < kFileHeaderSize + kTrailerSize
+      || std::memcmp(fData, kMagic, sizeof(kMagic)) != 0
+      || read<std::uint32_t>(fData + sizeof(kMagic)) != kVersion
+      || read<std::uint32_t>(fData + sizeof(kMagic) + 4) != kByteOrderMark
+      || std::memcmp(fData + fSize - sizeof(kEndMagic), kEndMagic, sizeof(kEndMagic)) != 0) {
+    return false;
+  }
+  const char* trailer = fData + fSize - kTrailerSize;
+  auto indexOffset = read<std::uint64_t>(trailer);
+  auto blockCount = read<std::uint32_t>(trailer + 8);
+  if (indexOffset + blockCount * kIndexEntrySize + kTrailerSize != fSize) {
+    return false;
+  }
+  for (std::uint32_t i = 0; i < blockCount; i++) {
+    const char* entry = fData + indexOffset + i * kIndexEntrySize;
+    BlockInfo block;
+    block.fOffset = read<std::uint64_t>(entry);
+    block.fStoredSize = read<std::uint32_t>(entry + 8);
+    block.fRawSize = read<std::uint32_t>(entry + 12);
+    block.fWaveforms = read<std::uint32_t>(entry + 16);
+    block.fCompressed = read<std::uint32_t>(entry + 20);
+    if (block.fOffset + block.fStoredSize > indexOffset) {
+      return false;
+    }
+    fBlocks.push_back(block);
+  }
+  return true;
+}
+
+bool Reader::loadBlock(std::size_t index)
+{
+  const auto& block = fBlocks[index];
+  if (block.fCompressed) {
+    fBuffer.resize(block.fRawSize);
+    uLongf rawSize = block.fRawSize;
+    if (uncompress(reinterpret_cast<Bytef*>(fBuffer.data()), &rawSize,
+                   reinterpret_cast<const Bytef*>(fData + block.fOffset), block.fStoredSize) != Z_OK
+        || rawSize != block.fRawSize) {
+      return false;
+    }
+    fBlockData = fBuffer.data();
+  } else {
+    fBlockData = fData + block.fOffset;
+  }
+  fBlockSize = block.fRawSize;
+  fBlockPosition = 0;
+  return true;
+}
+
+bool Reader::next(WaveformView& waveform)
+{
+  if (!fData) {
+    return false;
+  }
+  while (!fBlockLoaded || fBlockPosition >= fBlockSize) {
+    if (fBlockLoaded) {
+      fCurrentBlock++;
+    }
+    if (fCurrentBlock >= fBlocks.size() || !loadBlock(fCurrentBlock)) {
+      fBlockLoaded = false;
+      fCurrentBlock = fBlocks.size();
+      return false;
+    }
+    fBlockLoaded = true;
+  }
+  if (fBlockPosition + kRecordHeaderSize > fBlockSize) {
+    return false;
+  }
+  const char* record = fBlockData + fBlockPosition;
+  waveform.fSize = read<std::uint32_t>(record);
+  waveform.fPMID = read<std::int32_t>(record + 4);
+  waveform.fEvent = read<std::uint64_t>(record + 8);
+  waveform.fTimeStart = read<double>(record + 16);
+  waveform.fTimeStep = read<double>(record + 24);
+  waveform.fGain = read<double>(record + 32);
+  waveform.fZero = read<double>(record + 40);
+  std::size_t samplesSize = waveform.fSize * sizeof(std::int16_t);
+  if (fBlockPosition + kRecordHeaderSize + samplesSize > fBlockSize) {
+    return false;
+  }
+  waveform.fSamples = reinterpret_cast<const std::int16_t*>(record + kRecordHeaderSize);
+  fBlockPosition += kRecordHeaderSize + samplesSize + padding(samplesSize);
+  return true;
+}
@@ -0,0 +1,158 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file WaveformFile.h
+ */
+
+#ifndef WAVEFORMFILE_H
+#define WAVEFORMFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Compact binary file with sampled waveforms (e.g. from an oscilloscope).
+ *
+ * Every waveform is stored as int16 samples with its own time base and gain:
+ * time(i) = timeStart + i * timeStep [ps], amplitude(i) = zero + gain * sample(i) [mV],
+ * together with the event and the photomultiplier it belongs to, so the reader
+ * can check that the waveforms match the signals they are assigned to.
+ * The waveforms are grouped in blocks, each compressed with zlib if it makes
+ * the block smaller. The index of the blocks is written at the end of the file.
+ *
+ * The numbers are stored in the byte order of the machine writing the file, so the samples
+ * can be used directly from the memory mapped file; the header records this order with
+ * the u32 value 0x01020304, and a file written with the other byte order is not opened
+ * by the reader.
+ * File layout:
+ * "JPWF" u32 version, u32 byte order mark, u32 reserved | blocks... | index: {u64 offset, u32 stored size, u32 raw size,
+ * u32 number of waveforms, u32 compressed} per block | u64 index offset, u32 number of blocks, "JPWE"
+ * Block content: for every waveform {u32 number of samples, i32 PM ID, u64 event, f64 timeStart,
+ * f64 timeStep, f64 gain, f64 zero, int16 samples, padding to 8 bytes}.
+ */
+namespace WaveformFile
+{
+/// Waveform with samples owned by somebody else (the reader or the caller)
+struct WaveformView {
+  std::uint64_t fEvent = 0;
+  std::int32_t fPMID = 0;
+  double fTimeStart = 0.; /// [ps]
+  double fTimeStep = 0.; /// [ps]
+  double fGain = 1.; /// [mV per count]
+  double fZero = 0.; /// [mV]
+  const std::int16_t* fSamples = nullptr;
+  std::size_t fSize = 0;
+
+  double getTime(std::size_t i) const
+  {
+    return fTimeStart + i * fTimeStep;
+  }
+  double getAmplitude(std::size_t i) const
+  {
+    return fZero + fGain * fSamples[i];
+  }
+};
+
+class Writer
+{
+public:
+  /// compressionLevel: 0 - no compression, 1-9 - zlib levels
+  explicit Writer(const std::string& fileName, int compressionLevel = 1, std::size_t blockSize = 1 << 20);
+  ~Writer();
+  /// False if the file could not be opened or a write failed (reported as ERROR)
+  bool isOpen() const;
+  /// Adds a waveform which is already quantized
+  void add(const WaveformView& waveform);
+  /// Quantizes and adds a waveform sampled with a constant time step. If gain is 0,
+  /// it is chosen so the full int16 range covers the amplitudes of this waveform.
+  /// The quantization error is at most gain/2.
+  void add(std::uint64_t event, std::int32_t pmID, const double* times, const double* amplitudes,
+           std::size_t n, double gain = 0.);
+  /// Writes the last block and the index. Called also by the destructor.
+  /// Returns false if any part of the file could not be written.
+  bool close();
+  std::size_t getWaveformCount() const
+  {
+    return fWaveformCount;
+  }
+
+private:
+  Writer(const Writer&);
+  void operator=(const Writer&);
+  void flushBlock();
+  void writeBytes(const void* data, std::size_t size);
+
+  std::string fFileName;
+  std::FILE* fFile = nullptr;
+  bool fFailed = false;
+  int fCompressionLevel;
+  std::size_t fBlockSize;
+  std::vector<char> fBlock;
+  std::vector<char> fCompressed;
+  std::vector<std::int16_t> fQuantized;
+  std::vector<char> fIndex;
+  std::uint32_t fBlockWaveforms = 0;
+  std::uint32_t fBlockCount = 0;
+  std::uint64_t fOffset = 0;
+  std::size_t fWaveformCount = 0;
+};
+
+/**
+ * @brief Reader of the waveform files.
+ *
+ * The file is memory mapped. The samples of uncompressed blocks are returned
+ * directly from the mapping; the compressed blocks are decompressed into
+ * a buffer reused for every block. The views returned by next() are valid
+ * until the next block is read.
+ */
+class Reader
+{
+public:
+  explicit Reader(const std::string& fileName);
+  ~Reader();
+  bool isOpen() const;
+  std::size_t getBlockCount() const
+  {
+    return fBlocks.size();
+  }
+  std::size_t getWaveformCount() const;
+  /// Sets the next waveform; returns false at the end of the file or on error
+  bool next(WaveformView& waveform);
+
+private:
+  struct BlockInfo {
+    std::uint64_t fOffset;
+    std::uint32_t fStoredSize;
+    std::uint32_t fRawSize;
+    std::uint32_t fWaveforms;
+    std::uint32_t fCompressed;
+  };
+  Reader(const Reader&);
+  void operator=(const Reader&);
+  bool readIndex();
+  bool loadBlock(std::size_t block);
+
+  const char* fData = nullptr;
+  std::size_t fSize = 0;
+  std::vector<BlockInfo> fBlocks;
+  std::vector<char> fBuffer;
+  const char* fBlockData = nullptr;
+  std::size_t fBlockSize = 0;
+  std::size_t fBlockPosition = 0;
+  std::size_t fCurrentBlock = 0;
+  bool fBlockLoaded = false;
+};
+}
+#endif /*  !WAVEFORMFILE_H */
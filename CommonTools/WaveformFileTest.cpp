@@ -0,0 +1,124 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE WaveformFile
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+
+#include "WaveformFile.h"
+
+BOOST_AUTO_TEST_SUITE (WaveformFileSuite)
+
+BOOST_AUTO_TEST_CASE (writeAndReadBack)
+{
+  const std::string fileName = "waveformFileTest.wfm";
+  const std::size_t nSamples = 1000;
+  std::vector<double> times(nSamples), amplitudes(nSamples);
+  for (int compression : {0, 6}) {
+    {
+      WaveformFile::Writer writer(fileName, compression, 4096);
+      BOOST_REQUIRE(writer.isOpen());
+      for (int w = 0; w < 20; w++) {
+        for (std::size_t i = 0; i < nSamples; i++) {
+          times[i] = -20000. + 100. * i;
+          amplitudes[i] = (i > 300 && i < 400) ? -150. * std::sin((i - 300) * M_PI / 100.) - w : 2.;
+        }
+        writer.add(w, 100 + w % 4, times.data(), amplitudes.data(), nSamples);
+      }
+      writer.add(20, 7, times.data(), amplitudes.data(), 0);
+      BOOST_REQUIRE_EQUAL(writer.getWaveformCount(), 21u);
+    }
+    WaveformFile::Reader reader(fileName);
+    BOOST_REQUIRE(reader.isOpen());
+    BOOST_REQUIRE(reader.getBlockCount() > 1);
+    BOOST_REQUIRE_EQUAL(reader.getWaveformCount(), 21u);
+    WaveformFile::WaveformView waveform;
+    for (int w = 0; w < 20; w++) {
+      BOOST_REQUIRE(reader.next(waveform));
+      BOOST_REQUIRE_EQUAL(waveform.fSize, nSamples);
+      BOOST_REQUIRE_EQUAL(waveform.fEvent, std::uint64_t(w));
+      BOOST_REQUIRE_EQUAL(waveform.fPMID, 100 + w % 4);
+      BOOST_REQUIRE_EQUAL(reinterpret_cast<std::uintptr_t>(waveform.fSamples) % alignof(std::int16_t), 0u);
+      BOOST_REQUIRE_CLOSE(waveform.getTime(nSamples - 1), times[nSamples - 1], 1.e-9);
+      for (std::size_t i = 0; i < nSamples; i++) {
+        double expected = (i > 300 && i < 400) ? -150. * std::sin((i - 300) * M_PI / 100.) - w : 2.;
+        BOOST_REQUIRE(std::fabs(waveform.getAmplitude(i) - expected) <= 0.5 * waveform.fGain + 1.e-9);
+      }
+    }
+    BOOST_REQUIRE(reader.next(waveform));
+    BOOST_REQUIRE_EQUAL(waveform.fSize, 0u);
+    BOOST_REQUIRE_EQUAL(waveform.fEvent, 20u);
+    BOOST_REQUIRE_EQUAL(waveform.fPMID, 7);
+    BOOST_REQUIRE(!reader.next(waveform));
+  }
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE (fixedGainAndWrongFile)
+{
+  const std::string fileName = "waveformFileTest2.wfm";
+  {
+    WaveformFile::Writer writer(fileName);
+    double times[3] = {0., 50., 100.};
+    double amplitudes[3] = {0.5, -1.5, 10.};
+    writer.add(0, 1, times, amplitudes, 3, 0.5);
+  }
+  {
+    WaveformFile::Reader reader(fileName);
+    WaveformFile::WaveformView waveform;
+    BOOST_REQUIRE(reader.next(waveform));
+    BOOST_REQUIRE_EQUAL(waveform.fSamples[0], 1);
+    BOOST_REQUIRE_EQUAL(waveform.fSamples[1], -3);
+    BOOST_REQUIRE_EQUAL(waveform.fSamples[2], 20);
+    BOOST_REQUIRE_EQUAL(waveform.fTimeStep, 50.);
+  }
+  std::remove(fileName.c_str());
+
+  WaveformFile::Reader reader("nonexisting_file.wfm");
+  BOOST_REQUIRE(!reader.isOpen());
+  WaveformFile::WaveformView waveform;
+  BOOST_REQUIRE(!reader.next(waveform));
+}
+
+BOOST_AUTO_TEST_CASE (otherByteOrderNotRead)
+{
+  const std::string fileName = "waveformFileTest3.wfm";
+  {
+    WaveformFile::Writer writer(fileName);
+    double times[2] = {0., 50.};
+    double amplitudes[2] = {1., 2.};
+    writer.add(0, 1, times, amplitudes, 2);
+    BOOST_REQUIRE(writer.close());
+  }
+  /// the byte order mark follows the magic and the version; reversed as the other order writes it
+  std::FILE* file = std::fopen(fileName.c_str(), "r+b");
+  unsigned char mark[4];
+  std::fseek(file, 8, SEEK_SET);
+  BOOST_REQUIRE_EQUAL(std::fread(mark, 1, 4, file), 4u);
+  std::swap(mark[0], mark[3]);
+  std::swap(mark[1], mark[2]);
+  std::fseek(file, 8, SEEK_SET);
+  std::fwrite(mark, 1, 4, file);
+  std::fclose(file);
+  WaveformFile::Reader reader(fileName);
+  BOOST_REQUIRE(!reader.isOpen());
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE (writeErrorsReported)
+{
+  /// every write to /dev/full fails with ENOSPC
+  WaveformFile::Writer writer("/dev/full", 0, 256);
+  std::vector<double> times(100), amplitudes(100);
+  for (std::size_t i = 0; i < times.size(); i++) {
+    times[i] = 100. * i;
+    amplitudes[i] = i % 7;
+  }
+  for (int w = 0; w < 100; w++) {
+    writer.add(w, 1, times.data(), amplitudes.data(), times.size());
+  }
+  BOOST_REQUIRE(!writer.close());
+  BOOST_REQUIRE(!writer.isOpen());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,490 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file WaveformKernels.cpp
+ */
+
+#include "WaveformKernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define WAVEFORM_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+/// Scalar implementations, used also for the tails of the vectorized loops
+
+double sumScalar(const double* values, std::size_t n)
+{
+  double sum = 0.;
+  for (std::size_t i = 0; i < n; i++) {
+    sum += values[i];
+  }
+  return sum;
+}
+
+double trapezoidScalar(const double* times, const double* values, std::size_t n, double offset)
+{
+  double sum = 0.;
+  for (std::size_t i = 0; i + 1 < n; i++) {
+    sum += (values[i] + values[i + 1] - 2. * offset) * (times[i + 1] - times[i]);
+  }
+  return sum;
+}
+
+typedef WaveformKernels::Extremum Extremum;
+
+/// Merges a candidate found in another lane or block, keeping the first occurrence on ties
+inline void takeMin(Extremum& min, double value, std::size_t index)
+{
+  if (value < min.value || (value == min.value && index < min.index)) {
+    min.value = value;
+    min.index = index;
+  }
+}
+
+inline void takeMax(Extremum& max, double value, std::size_t index)
+{
+  if (value > max.value || (value == max.value && index < max.index)) {
+    max.value = value;
+    max.index = index;
+  }
+}
+
+/// Scans values[first, n) on top of the extrema found so far, which all come from
+/// lower indices, so the strict comparisons keep the first occurrence
+template<class T>
+void minMaxTail(const T* values, std::size_t first, std::size_t n, Extremum& min, Extremum& max)
+{
+  for (std::size_t i = first; i < n; i++) {
+    if (values[i] < min.value) {
+      min.value = values[i];
+      min.index = i;
+    }
+    if (values[i] > max.value) {
+      max.value = values[i];
+      max.index = i;
+    }
+  }
+}
+
+void minMaxScalar(const double* values, std::size_t n, Extremum& min, Extremum& max)
+{
+  min.value = max.value = values[0];
+  min.index = max.index = 0;
+  minMaxTail(values, 1, n, min, max);
+}
+
+std::int64_t sumInt16Scalar(const std::int16_t* values, std::size_t n)
+{
+  std::int64_t sum = 0;
+  for (std::size_t i = 0; i < n; i++) {
+    sum += values[i];
+  }
+  return sum;
+}
+
+void minMaxInt16Scalar(const std::int16_t* values, std::size_t n, Extremum& min, Extremum& max)
+{
+  min.value = max.value = values[0];
+  min.index = max.index = 0;
+  minMaxTail(values, 1, n, min, max);
+}
+
+#ifdef WAVEFORM_KERNELS_X86
+
+/// The int16 sums are accumulated in int32 lanes, which are moved to int64
+/// before they can overflow: every step adds at most 2 * 32768 to a lane
+const std::size_t kInt32SafeSteps = 16384;
+
+/// The int16 min/max passes count their steps in int16 lanes, so the input is
+/// scanned in blocks of at most this many steps, merged after every block
+const std::int16_t kInt16MaxSteps = 32767;
+
+__attribute__((target("sse4.1")))
+std::int64_t sumInt16SSE41(const std::int16_t* values, std::size_t n)
+{
+  const __m128i ones = _mm_set1_epi16(1);
+  std::int64_t total = 0;
+  std::size_t i = 0;
+  while (i + 8 <= n) {
+    __m128i sum = _mm_setzero_si128();
+    for (std::size_t steps = 0; steps < kInt32SafeSteps && i + 8 <= n; steps++, i += 8) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(v, ones));
+    }
+    std::int32_t partial[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(partial), sum);
+    total += static_cast<std::int64_t>(partial[0]) + partial[1] + partial[2] + partial[3];
+  }
+  return total + sumInt16Scalar(values + i, n - i);
+}
+
+__attribute__((target("sse4.1")))
+void minMaxInt16SSE41(const std::int16_t* values, std::size_t n, Extremum& min, Extremum& max)
+{
+  min.value = max.value = values[0];
+  min.index = max.index = 0;
+  std::size_t i = 0;
+  while (i + 8 <= n) {
+    const std::size_t blockStart = i;
+    __m128i vmin = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+    __m128i vmax = vmin;
+    __m128i minSteps = _mm_setzero_si128();
+    __m128i maxSteps = minSteps;
+    i += 8;
+    for (std::int16_t step = 1; step < kInt16MaxSteps && i + 8 <= n; step++, i += 8) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+      __m128i vstep = _mm_set1_epi16(step);
+      minSteps = _mm_blendv_epi8(minSteps, vstep, _mm_cmpgt_epi16(vmin, v));
+      maxSteps = _mm_blendv_epi8(maxSteps, vstep, _mm_cmpgt_epi16(v, vmax));
+      vmin = _mm_min_epi16(vmin, v);
+      vmax = _mm_max_epi16(vmax, v);
+    }
+    std::int16_t mins[8], maxs[8], minStep[8], maxStep[8];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(mins), vmin);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(maxs), vmax);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(minStep), minSteps);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(maxStep), maxSteps);
+    for (int k = 0; k < 8; k++) {
+      takeMin(min, mins[k], blockStart + 8 * static_cast<std::size_t>(minStep[k]) + k);
+      takeMax(max, maxs[k], blockStart + 8 * static_cast<std::size_t>(maxStep[k]) + k);
+    }
+  }
+  minMaxTail(values, i, n, min, max);
+}
+
+__attribute__((target("avx2")))
+std::int64_t sumInt16AVX2(const std::int16_t* values, std::size_t n)
+{
+  const __m256i ones = _mm256_set1_epi16(1);
+  std::int64_t total = 0;
+  std::size_t i = 0;
+  while (i + 16 <= n) {
+    __m256i sum = _mm256_setzero_si256();
+    for (std::size_t steps = 0; steps < kInt32SafeSteps && i + 16 <= n; steps++, i += 16) {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+      sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v, ones));
+    }
+    std::int32_t partial[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(partial), sum);
+    for (int k = 0; k < 8; k++) {
+      total += partial[k];
+    }
+  }
+  return total + sumInt16Scalar(values + i, n - i);
+}
+
+__attribute__((target("avx2")))
+void minMaxInt16AVX2(const std::int16_t* values, std::size_t n, Extremum& min, Extremum& max)
+{
+  min.value = max.value = values[0];
+  min.index = max.index = 0;
+  std::size_t i = 0;
+  while (i + 16 <= n) {
+    const std::size_t blockStart = i;
+    __m256i vmin = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+    __m256i vmax = vmin;
+    __m256i minSteps = _mm256_setzero_si256();
+    __m256i maxSteps = minSteps;
+    i += 16;
+    for (std::int16_t step = 1; step < kInt16MaxSteps && i + 16 <= n; step++, i += 16) {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+      __m256i vstep = _mm256_set1_epi16(step);
+      minSteps = _mm256_blendv_epi8(minSteps, vstep, _mm256_cmpgt_epi16(vmin, v));
+      maxSteps = _mm256_blendv_epi8(maxSteps, vstep, _mm256_cmpgt_epi16(v, vmax));
+      vmin = _mm256_min_epi16(vmin, v);
+      vmax = _mm256_max_epi16(vmax, v);
+    }
+    std::int16_t mins[16], maxs[16], minStep[16], maxStep[16];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(mins), vmin);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(maxs), vmax);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(minStep), minSteps);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(maxStep), maxSteps);
+    for (int k = 0; k < 16; k++) {
+      takeMin(min, mins[k], blockStart + 16 * static_cast<std::size_t>(minStep[k]) + k);
+      takeMax(max, maxs[k], blockStart + 16 * static_cast<std::size_t>(maxStep[k]) + k);
+    }
+  }
+  minMaxTail(values, i, n, min, max);
+}
+
+__attribute__((target("sse4.1")))
+double sumSSE41(const double* values, std::size_t n)
+{
+  __m128d sum0 = _mm_setzero_pd();
+  __m128d sum1 = _mm_setzero_pd();
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    sum0 = _mm_add_pd(sum0, _mm_loadu_pd(values + i));
+    sum1 = _mm_add_pd(sum1, _mm_loadu_pd(values + i + 2));
+  }
+  double partial[2];
+  _mm_storeu_pd(partial, _mm_add_pd(sum0, sum1));
+  return partial[0] + partial[1] + sumScalar(values + i, n - i);
+}
+
+__attribute__((target("sse4.1")))
+double trapezoidSSE41(const double* times, const double* values, std::size_t n, double offset)
+{
+  if (n < 2) {
+    return 0.;
+  }
+  const __m128d twoOffset = _mm_set1_pd(2. * offset);
+  __m128d sum = _mm_setzero_pd();
+  std::size_t i = 0;
+  for (; i + 3 <= n; i += 2) {
+    __m128d heights = _mm_sub_pd(_mm_add_pd(_mm_loadu_pd(values + i), _mm_loadu_pd(values + i + 1)), twoOffset);
+    __m128d widths = _mm_sub_pd(_mm_loadu_pd(times + i + 1), _mm_loadu_pd(times + i));
+    sum = _mm_add_pd(sum, _mm_mul_pd(heights, widths));
+  }
+  double partial[2];
+  _mm_storeu_pd(partial, sum);
+  return partial[0] + partial[1] + trapezoidScalar(times + i, values + i, n - i, offset);
+}
+
+/// The double passes keep the index of every lane as a double, exact up to 2^53
+__attribute__((target("sse4.1")))
+void minMaxSSE41(const double* values, std::size_t n, Extremum& min, Extremum& max)
+{
+  if (n < 2) {
+    minMaxScalar(values, n, min, max);
+    return;
+  }
+  const __m128d two = _mm_set1_pd(2.);
+  __m128d vmin = _mm_loadu_pd(values);
+  __m128d vmax = vmin;
+  __m128d indices = _mm_set_pd(1., 0.);
+  __m128d minIndices = indices;
+  __m128d maxIndices = indices;
+  std::size_t i = 2;
+  for (; i + 2 <= n; i += 2) {
+    __m128d v = _mm_loadu_pd(values + i);
+    indices = _mm_add_pd(indices, two);
+    __m128d lower = _mm_cmplt_pd(v, vmin);
+    __m128d higher = _mm_cmpgt_pd(v, vmax);
+    vmin = _mm_blendv_pd(vmin, v, lower);
+    minIndices = _mm_blendv_pd(minIndices, indices, lower);
+    vmax = _mm_blendv_pd(vmax, v, higher);
+    maxIndices = _mm_blendv_pd(maxIndices, indices, higher);
+  }
+  double mins[2], maxs[2], minIndex[2], maxIndex[2];
+  _mm_storeu_pd(mins, vmin);
+  _mm_storeu_pd(maxs, vmax);
+  _mm_storeu_pd(minIndex, minIndices);
+  _mm_storeu_pd(maxIndex, maxIndices);
+  min.value = mins[0];
+  min.index = static_cast<std::size_t>(minIndex[0]);
+  max.value = maxs[0];
+  max.index = static_cast<std::size_t>(maxIndex[0]);
+  takeMin(min, mins[1], static_cast<std::size_t>(minIndex[1]));
+  takeMax(max, maxs[1], static_cast<std::size_t>(maxIndex[1]));
+  minMaxTail(values, i, n, min, max);
+}
+
+__attribute__((target("avx2")))
+double sumAVX2(const double* values, std::size_t n)
+{
+  __m256d sum0 = _mm256_setzero_pd();
+  __m256d sum1 = _mm256_setzero_pd();
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    sum0 = _mm256_add_pd(sum0, _mm256_loadu_pd(values + i));
+    sum1 = _mm256_add_pd(sum1, _mm256_loadu_pd(values + i + 4));
+  }
+  double partial[4];
+  _mm256_storeu_pd(partial, _mm256_add_pd(sum0, sum1));
+  return (partial[0] + partial[1]) + (partial[2] + partial[3]) + sumScalar(values + i, n - i);
+}
+
+__attribute__((target("avx2")))
+double trapezoidAVX2(const double* times, const double* values, std::size_t n, double offset)
+{
+  if (n < 2) {
+    return 0.;
+  }
+  const __m256d twoOffset = _mm256_set1_pd(2. * offset);
+  __m256d sum = _mm256_setzero_pd();
+  std::size_t i = 0;
+  for (; i + 5 <= n; i += 4) {
+    __m256d heights = _mm256_sub_pd(_mm256_add_pd(_mm256_loadu_pd(values + i), _mm256_loadu_pd(values + i + 1)), twoOffset);
+    __m256d widths = _mm256_sub_pd(_mm256_loadu_pd(times + i + 1), _mm256_loadu_pd(times + i));
+    sum = _mm256_add_pd(sum, _mm256_mul_pd(heights, widths));
+  }
+  double partial[4];
+  _mm256_storeu_pd(partial, sum);
+  return (partial[0] + partial[1]) + (partial[2] + partial[3]) + trapezoidScalar(times + i, values + i, n - i, offset);
+}
+
+__attribute__((target("avx2")))
+void minMaxAVX2(const double* values, std::size_t n, Extremum& min, Extremum& max)
+{
+  if (n < 4) {
+    minMaxScalar(values, n, min, max);
+    return;
+  }
+  const __m256d four = _mm256_set1_pd(4.);
+  __m256d vmin = _mm256_loadu_pd(values);
+  __m256d vmax = vmin;
+  __m256d indices = _mm256_set_pd(3., 2., 1., 0.);
+  __m256d minIndices = indices;
+  __m256d maxIndices = indices;
+  std::size_t i = 4;
+  for (; i + 4 <= n; i += 4) {
+    __m256d v = _mm256_loadu_pd(values + i);
+    indices = _mm256_add_pd(indices, four);
+    __m256d lower = _mm256_cmp_pd(v, vmin, _CMP_LT_OQ);
+    __m256d higher = _mm256_cmp_pd(v, vmax, _CMP_GT_OQ);
+    vmin = _mm256_blendv_pd(vmin, v, lower);
+    minIndices = _mm256_blendv_pd(minIndices, indices, lower);
+    vmax = _mm256_blendv_pd(vmax, v, higher);
+    maxIndices = _mm256_blendv_pd(maxIndices, indices, higher);
+  }
+  double mins[4], maxs[4], minIndex[4], maxIndex[4];
+  _mm256_storeu_pd(mins, vmin);
+  _mm256_storeu_pd(maxs, vmax);
+  _mm256_storeu_pd(minIndex, minIndices);
+  _mm256_storeu_pd(maxIndex, maxIndices);
+  min.value = mins[0];
+  min.index = static_cast<std::size_t>(minIndex[0]);
+  max.value = maxs[0];
+  max.index = static_cast<std::size_t>(maxIndex[0]);
+  for (int k = 1; k < 4; k++) {
+    takeMin(min, mins[k], static_cast<std::size_t>(minIndex[k]));
+    takeMax(max, maxs[k], static_cast<std::size_t>(maxIndex[k]));
+  }
+  minMaxTail(values, i, n, min, max);
+}
+
+#endif /* WAVEFORM_KERNELS_X86 */
+
+struct Implementation {
+  WaveformKernels::InstructionSet fSet;
+  double (*fSum)(const double*, std::size_t);
+  double (*fTrapezoid)(const double*, const double*, std::size_t, double);
+  void (*fMinMax)(const double*, std::size_t, Extremum&, Extremum&);
+  std::int64_t (*fSumInt16)(const std::int16_t*, std::size_t);
+  void (*fMinMaxInt16)(const std::int16_t*, std::size_t, Extremum&, Extremum&);
+};
+
+WaveformKernels::InstructionSet getBestSupported()
+{
+#ifdef WAVEFORM_KERNELS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return WaveformKernels::kAVX2;
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return WaveformKernels::kSSE41;
+  }
+#endif
+  return WaveformKernels::kScalar;
+}
+
+Implementation makeImplementation(WaveformKernels::InstructionSet set)
+{
+  if (set > getBestSupported()) {
+    set = getBestSupported();
+  }
+#ifdef WAVEFORM_KERNELS_X86
+  if (set == WaveformKernels::kAVX2) {
+    return {set, sumAVX2, trapezoidAVX2, minMaxAVX2, sumInt16AVX2, minMaxInt16AVX2};
+  }
+  if (set == WaveformKernels::kSSE41) {
+    return {set, sumSSE41, trapezoidSSE41, minMaxSSE41, sumInt16SSE41, minMaxInt16SSE41};
+  }
+#endif
+  return {WaveformKernels::kScalar, sumScalar, trapezoidScalar, minMaxScalar, sumInt16Scalar, minMaxInt16Scalar};
+}
+
+Implementation& getImplementation()
+{
+  static Implementation implementation = makeImplementation(getBestSupported());
+  return implementation;
+}
+
+}
+
+double WaveformKernels::mean(const double* values, std::size_t n)
+{
+  if (n == 0) {
+    return 0.;
+  }
+  return getImplementation().fSum(values, n) / n;
+}
+
+double WaveformKernels::trapezoid(const double* times, const double* values, std::size_t n, double offset)
+{
+  if (n < 2) {
+    return 0.;
+  }
+  return 0.5 * getImplementation().fTrapezoid(times, values, n, offset);
+}
+
+void WaveformKernels::minMax(const double* values, std::size_t n, Extremum& min, Extremum& max)
+{
+  if (n == 0) {
+    min = Extremum();
+    max = Extremum();
+    return;
+  }
+  getImplementation().fMinMax(values, n, min, max);
+}
+
+std::int64_t WaveformKernels::sum(const std::int16_t* values, std::size_t n)
+{
+  return getImplementation().fSumInt16(values, n);
+}
+
+double WaveformKernels::trapezoid(const std::int16_t* values, std::size_t n, double timeStep, double offset)
+{
+  if (n < 2) {
+    return 0.;
+  }
+  /// for a constant step the trapezoidal rule is the sum without half of the end points
+  const double sumWithoutHalfEnds = sum(values, n) - 0.5 * (values[0] + values[n - 1]);
+  return timeStep * (sumWithoutHalfEnds - offset * (n - 1));
+}
+
+void WaveformKernels::minMax(const std::int16_t* values, std::size_t n, Extremum& min, Extremum& max)
+{
+  if (n == 0) {
+    min = Extremum();
+    max = Extremum();
+    return;
+  }
+  getImplementation().fMinMaxInt16(values, n, min, max);
+}
+
+WaveformKernels::InstructionSet WaveformKernels::getInstructionSet()
+{
+  return getImplementation().fSet;
+}
+
+void WaveformKernels::setInstructionSet(InstructionSet set)
+{
+  getImplementation() = makeImplementation(set);
+}
+
+std::string WaveformKernels::getInstructionSetName(InstructionSet set)
+{
+  switch (set) {
+    case kAVX2:
+      return "AVX2";
+    case kSSE41:
+      return "SSE4.1";
+    default:
+      return "scalar";
+  }
+}
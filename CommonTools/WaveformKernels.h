@@ -0,0 +1,68 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file WaveformKernels.h
+ */
+
+#ifndef WAVEFORMKERNELS_H
+#define WAVEFORMKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Vectorized reductions over sampled waveforms.
+ *
+ * The samples are passed as plain arrays (structure of arrays), so the loops
+ * can be vectorized. The implementation is chosen once at runtime:
+ * AVX2 or SSE4.1 if the processor supports it, scalar code otherwise.
+ * The vectorized sums are accumulated in a different order than the scalar ones,
+ * so the results may differ in the last bits.
+ */
+class WaveformKernels
+{
+public:
+  enum InstructionSet { kScalar = 0, kSSE41 = 1, kAVX2 = 2 };
+
+  struct Extremum {
+    double value = 0.;
+    std::size_t index = 0;
+  };
+
+  /// Mean of the first n values, e.g. the baseline over the pre-trigger samples.
+  /// Returns 0 for n = 0.
+  static double mean(const double* values, std::size_t n);
+  /// Trapezoidal integral of (values - offset) over times, for n samples.
+  /// Returns 0 for n < 2.
+  static double trapezoid(const double* times, const double* values, std::size_t n, double offset);
+  /// Minimum and maximum of n > 0 values with the index of their first occurrence.
+  static void minMax(const double* values, std::size_t n, Extremum& min, Extremum& max);
+
+  /// Variants for the int16 samples of the compact waveform files (see WaveformFile.h),
+  /// working directly on the samples in counts
+  static std::int64_t sum(const std::int16_t* values, std::size_t n);
+  /// Trapezoidal integral of (values - offset) for a constant time step
+  static double trapezoid(const std::int16_t* values, std::size_t n, double timeStep, double offset);
+  static void minMax(const std::int16_t* values, std::size_t n, Extremum& min, Extremum& max);
+
+  static InstructionSet getInstructionSet();
+  /// Forces the given implementation, e.g. to compare it with the scalar one.
+  /// An instruction set not supported by the processor is replaced by the best supported one.
+  static void setInstructionSet(InstructionSet set);
+  static std::string getInstructionSetName(InstructionSet set);
+
+private:
+  WaveformKernels(const WaveformKernels&);
+  void operator=(const WaveformKernels&);
+};
+#endif /*  !WAVEFORMKERNELS_H */
@@ -0,0 +1,173 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE WaveformKernels
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "WaveformKernels.h"
+
+namespace
+{
+const std::vector<std::size_t> kSizes = {1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 1000, 1003};
+
+/// Negative pulse on a baseline with some ripple, sampled every 100 ps
+void makeWaveform(std::size_t n, std::vector<double>& times, std::vector<double>& values)
+{
+  times.resize(n);
+  values.resize(n);
+  for (std::size_t i = 0; i < n; i++) {
+    times[i] = 100. * i;
+    double pulse = -400. * std::exp(-std::pow((i - 0.4 * n) / 10., 2));
+    values[i] = 20. + 0.5 * std::sin(0.7 * i) + pulse;
+  }
+}
+
+std::vector<std::int16_t> makeCounts(std::size_t n)
+{
+  std::vector<std::int16_t> counts(n);
+  for (std::size_t i = 0; i < n; i++) {
+    counts[i] = static_cast<std::int16_t>(((i * 7919) % 2001) - 1000);
+  }
+  return counts;
+}
+
+std::vector<WaveformKernels::InstructionSet> getSupportedSets()
+{
+  std::vector<WaveformKernels::InstructionSet> sets;
+  for (auto set : {WaveformKernels::kScalar, WaveformKernels::kSSE41, WaveformKernels::kAVX2}) {
+    WaveformKernels::setInstructionSet(set);
+    if (WaveformKernels::getInstructionSet() == set) {
+      sets.push_back(set);
+    }
+  }
+  return sets;
+}
+
+/// The vectorized sums are accumulated in another order
+void checkClose(double value, double expected, double scale)
+{
+  BOOST_CHECK_SMALL(value - expected, 1e-12 * scale);
+}
+}
+
+BOOST_AUTO_TEST_SUITE (WaveformKernelsSuite)
+
+BOOST_AUTO_TEST_CASE (unsupportedSetReplaced)
+{
+  auto best = WaveformKernels::getInstructionSet();
+  WaveformKernels::setInstructionSet(WaveformKernels::kAVX2);
+  BOOST_REQUIRE(WaveformKernels::getInstructionSet() <= WaveformKernels::kAVX2);
+  WaveformKernels::setInstructionSet(WaveformKernels::kScalar);
+  BOOST_REQUIRE_EQUAL(WaveformKernels::getInstructionSet(), WaveformKernels::kScalar);
+  WaveformKernels::setInstructionSet(best);
+  BOOST_REQUIRE_EQUAL(WaveformKernels::getInstructionSetName(WaveformKernels::kSSE41), "SSE4.1");
+}
+
+BOOST_AUTO_TEST_CASE (doubleKernelsAgreeWithReference)
+{
+  auto best = WaveformKernels::getInstructionSet();
+  std::vector<double> times, values;
+  for (auto set : getSupportedSets()) {
+    WaveformKernels::setInstructionSet(set);
+    BOOST_TEST_MESSAGE("Instruction set: " + WaveformKernels::getInstructionSetName(set));
+    for (auto n : kSizes) {
+      makeWaveform(n, times, values);
+      double sum = 0.;
+      double area = 0.;
+      std::size_t minIndex = 0, maxIndex = 0;
+      for (std::size_t i = 0; i < n; i++) {
+        sum += values[i];
+        if (i + 1 < n) {
+          area += 0.5 * (values[i] + values[i + 1] - 2. * 20.) * (times[i + 1] - times[i]);
+        }
+        minIndex = values[i] < values[minIndex] ? i : minIndex;
+        maxIndex = values[i] > values[maxIndex] ? i : maxIndex;
+      }
+      checkClose(WaveformKernels::mean(values.data(), n), sum / n, 500.);
+      checkClose(WaveformKernels::trapezoid(times.data(), values.data(), n, 20.), area, 500. * 100. * n);
+      WaveformKernels::Extremum min, max;
+      WaveformKernels::minMax(values.data(), n, min, max);
+      BOOST_CHECK_EQUAL(min.value, values[minIndex]);
+      BOOST_CHECK_EQUAL(min.index, minIndex);
+      BOOST_CHECK_EQUAL(max.value, values[maxIndex]);
+      BOOST_CHECK_EQUAL(max.index, maxIndex);
+    }
+    BOOST_CHECK_EQUAL(WaveformKernels::mean(values.data(), 0), 0.);
+    BOOST_CHECK_EQUAL(WaveformKernels::trapezoid(times.data(), values.data(), 1, 0.), 0.);
+  }
+  WaveformKernels::setInstructionSet(best);
+}
+
+BOOST_AUTO_TEST_CASE (int16KernelsAgreeWithScalar)
+{
+  auto best = WaveformKernels::getInstructionSet();
+  for (auto n : kSizes) {
+    auto counts = makeCounts(n);
+    /// the first occurrence of a repeated extremum is reported
+    counts.push_back(counts[0]);
+    WaveformKernels::setInstructionSet(WaveformKernels::kScalar);
+    auto sum = WaveformKernels::sum(counts.data(), counts.size());
+    auto area = WaveformKernels::trapezoid(counts.data(), counts.size(), 100., 3.5);
+    WaveformKernels::Extremum min, max;
+    WaveformKernels::minMax(counts.data(), counts.size(), min, max);
+    std::int64_t expectedSum = 0;
+    for (auto count : counts) {
+      expectedSum += count;
+    }
+    BOOST_REQUIRE_EQUAL(sum, expectedSum);
+    for (auto set : getSupportedSets()) {
+      WaveformKernels::setInstructionSet(set);
+      BOOST_CHECK_EQUAL(WaveformKernels::sum(counts.data(), counts.size()), sum);
+      BOOST_CHECK_EQUAL(WaveformKernels::trapezoid(counts.data(), counts.size(), 100., 3.5), area);
+      WaveformKernels::Extremum setMin, setMax;
+      WaveformKernels::minMax(counts.data(), counts.size(), setMin, setMax);
+      BOOST_CHECK_EQUAL(setMin.value, min.value);
+      BOOST_CHECK_EQUAL(setMin.index, min.index);
+      BOOST_CHECK_EQUAL(setMax.value, max.value);
+      BOOST_CHECK_EQUAL(setMax.index, max.index);
+    }
+  }
+  WaveformKernels::setInstructionSet(best);
+}
+
+BOOST_AUTO_TEST_CASE (int16SumsDoNotOverflow)
+{
+  auto best = WaveformKernels::getInstructionSet();
+  /// more samples than the int32 lanes can hold before they are moved to int64
+  const std::size_t n = 16384 * 16 * 3 + 13;
+  std::vector<std::int16_t> highest(n, std::numeric_limits<std::int16_t>::max());
+  std::vector<std::int16_t> lowest(n, std::numeric_limits<std::int16_t>::min());
+  for (auto set : getSupportedSets()) {
+    WaveformKernels::setInstructionSet(set);
+    BOOST_CHECK_EQUAL(WaveformKernels::sum(highest.data(), n), std::int64_t(32767) * n);
+    BOOST_CHECK_EQUAL(WaveformKernels::sum(lowest.data(), n), std::int64_t(-32768) * n);
+  }
+  WaveformKernels::setInstructionSet(best);
+}
+
+BOOST_AUTO_TEST_CASE (int16IndicesBeyondStepBlocks)
+{
+  auto best = WaveformKernels::getInstructionSet();
+  /// the vectorized passes count their steps in int16 lanes, in blocks of 32767 steps
+  const std::size_t n = 32767 * 16 * 2 + 21;
+  std::vector<std::int16_t> counts(n, 0);
+  const std::size_t minIndex = 32767 * 16 + 35;
+  const std::size_t maxIndex = n - 40;
+  counts[minIndex] = -7;
+  counts[n - 3] = -7;
+  counts[maxIndex] = 9;
+  counts[n - 1] = 9;
+  for (auto set : getSupportedSets()) {
+    WaveformKernels::setInstructionSet(set);
+    WaveformKernels::Extremum min, max;
+    WaveformKernels::minMax(counts.data(), n, min, max);
+    BOOST_CHECK_EQUAL(min.value, -7.);
+    BOOST_CHECK_EQUAL(min.index, minIndex);
+    BOOST_CHECK_EQUAL(max.value, 9.);
+    BOOST_CHECK_EQUAL(max.index, maxIndex);
+  }
+  WaveformKernels::setInstructionSet(best);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
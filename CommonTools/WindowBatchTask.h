@@ -0,0 +1,267 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file WindowBatchTask.h
+ */
+
+#ifndef WINDOWBATCHTASK_H
+#define WINDOWBATCHTASK_H
+
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <JPetTask/JPetTask.h>
+#include "TaskOptions.h"
+
+#ifdef __CINT__
+//when cint is used instead of compiler, override word is not recognized
+//nevertheless it's needed for checking if the structure of project is correct
+#	define override
+#endif
+
+/// Result of the tasks which fill only histograms in processWindow()
+struct NoWindowResult {};
+
+/**
+ * @brief Base of the tasks which process their input objects (of type T) per time window.
+ *
+ * The input objects are collected until the time window index changes, and the complete
+ * window is passed to processWindow(), which returns a Result (e.g. the output objects).
+ * The Result is then passed to commitWindow(), which writes it and fills the histograms.
+ * The last window is processed in terminate(). The buffer of the objects keeps its
+ * capacity between the windows.
+ *
+ * With setMaxWindowObjects() at most that many objects are buffered: a larger window
+ * is passed to processWindow() in parts (see getSplitCount()), so the memory stays bounded.
+ *
+ * If the user option "<taskName>_Threads" is larger than 0 and the derived task declares
+ * with isParallelSafe() that its processWindow() uses nothing but its argument and
+ * constant members, the windows are processed by a pool of threads. commitWindow() is
+ * always called from the thread of the loader, in the order of the windows, and at most
+ * 2 * threads windows are waiting for the commit. The programs running such tasks must
+ * call ROOT::EnableThreadSafety() at the start of main(), before any task is created.
+ *
+ * The derived tasks calling their own init() or terminate() must call the ones of this class.
+ * terminate() stops the threads; they run processWindow() of the derived task, so they
+ * cannot be stopped in the destructor of this class, when the derived part is already gone.
+ */
+template<class T, class Result = NoWindowResult>
+class WindowBatchTask: public JPetTask
+{
+public:
+  WindowBatchTask(const char* name, const char* description):
+    JPetTask(name, description),
+    fTaskName(name)
+  {
+    /**/
+  }
+  virtual ~WindowBatchTask()
+  {
+    if (!fWorkers.empty()) {
+      ERROR(fTaskName + " destroyed with its threads running, terminate() was not called");
+    }
+    assert(fWorkers.empty());
+  }
+
+  virtual void init(const JPetTaskInterface::Options& opts) override
+  {
+    std::size_t threads = 0;
+    TaskOptions::read(opts, fTaskName + "_Threads", threads);
+    if (threads > 0 && !isParallelSafe()) {
+      WARNING(fTaskName + " processes the time windows in one thread only, " + fTaskName + "_Threads is ignored");
+      threads = 0;
+    }
+    if (threads > 0) {
+      fMaxPending = 2 * threads;
+      for (std::size_t i = 0; i < threads; i++) {
+        fWorkers.emplace_back(&WindowBatchTask::work, this);
+      }
+    }
+  }
+
+  virtual void exec() override
+  {
+    auto object = dynamic_cast<const T*>(getEvent());
+    if (!object || !accept(*object)) {
+      return;
+    }
+    long long window = getWindowIndex(*object);
+    if (window != fWindowIndex) {
+      if (!fBuffer.empty()) {
+        endWindow();
+      }
+    } else if (fBuffer.size() >= fMaxWindowObjects) {
+      endWindow();
+      fSplitCount++;
+    }
+    fWindowIndex = window;
+    fBuffer.push_back(*object);
+  }
+
+  virtual void terminate() override
+  {
+    if (!fBuffer.empty()) {
+      endWindow();
+    }
+    while (!fPending.empty()) {
+      commitOldest();
+    }
+    stopWorkers();
+  }
+
+protected:
+  /// Processes all the objects of one time window
+  virtual Result processWindow(const std::vector<T>& objects) = 0;
+  /// Writes the result of a window; called in the order of the windows
+  virtual void commitWindow(Result&) {}
+  /// True if processWindow() can be called from several threads at the same time
+  virtual bool isParallelSafe() const
+  {
+    return false;
+  }
+  /// Objects for which it returns false are skipped
+  virtual bool accept(const T&)
+  {
+    return true;
+  }
+  virtual long long getWindowIndex(const T& object) const
+  {
+    return object.getTimeWindowIndex();
+  }
+  /// Largest number of objects passed to processWindow() at once
+  void setMaxWindowObjects(std::size_t maxObjects)
+  {
+    fMaxWindowObjects = (maxObjects > 0) ? maxObjects : 1;
+  }
+  /// Number of times a window was passed to processWindow() before its end
+  std::size_t getSplitCount() const
+  {
+    return fSplitCount;
+  }
+
+  std::string fTaskName;
+
+private:
+  void endWindow()
+  {
+    if (fWorkers.empty()) {
+      Result result = processWindow(fBuffer);
+      fBuffer.clear();
+      commitWindow(result);
+      return;
+    }
+    auto objects = takeBuffer();
+    auto job = std::make_shared<std::packaged_task<Result()>>([this, objects]() {
+      Result result = processWindow(*objects);
+      recycle(objects);
+      return result;
+    });
+    fPending.push_back(job->get_future());
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fJobs.push_back([job]() {
+        (*job)();
+      });
+    }
+    fCondition.notify_one();
+    while (fPending.size() > fMaxPending) {
+      commitOldest();
+    }
+  }
+
+  void commitOldest()
+  {
+    Result result = fPending.front().get();
+    fPending.pop_front();
+    commitWindow(result);
+  }
+
+  /// Moves the objects of the window to a recycled vector, so the capacity is reused
+  std::shared_ptr<std::vector<T>> takeBuffer()
+  {
+    std::shared_ptr<std::vector<T>> objects;
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      if (!fFreeBuffers.empty()) {
+        objects = fFreeBuffers.back();
+        fFreeBuffers.pop_back();
+      }
+    }
+    if (!objects) {
+      objects = std::make_shared<std::vector<T>>();
+    }
+    objects->swap(fBuffer);
+    fBuffer.clear();
+    return objects;
+  }
+
+  void recycle(std::shared_ptr<std::vector<T>> objects)
+  {
+    objects->clear();
+    std::lock_guard<std::mutex> lock(fMutex);
+    fFreeBuffers.push_back(objects);
+  }
+
+  void work()
+  {
+    while (true) {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lock(fMutex);
+        fCondition.wait(lock, [this]() {
+          return fStop || !fJobs.empty();
+        });
+        if (fJobs.empty()) {
+          return;
+        }
+        job = std::move(fJobs.front());
+        fJobs.pop_front();
+      }
+      job();
+    }
+  }
+
+  void stopWorkers()
+  {
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStop = true;
+    }
+    fCondition.notify_all();
+    for (auto& worker : fWorkers) {
+      worker.join();
+    }
+    fWorkers.clear();
+  }
+
+  std::vector<T> fBuffer;
+  long long fWindowIndex = 0;
+  std::size_t fMaxWindowObjects = std::numeric_limits<std::size_t>::max();
+  std::size_t fSplitCount = 0;
+  std::vector<std::thread> fWorkers;
+  std::deque<std::function<void()>> fJobs;
+  std::deque<std::future<Result>> fPending;
+  std::vector<std::shared_ptr<std::vector<T>>> fFreeBuffers;
+  std::size_t fMaxPending = 0;
+  std::mutex fMutex;
+  std::condition_variable fCondition;
+  bool fStop = false;
+};
+#endif /*  !WINDOWBATCHTASK_H */
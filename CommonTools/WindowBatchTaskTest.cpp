@@ -0,0 +1,194 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE WindowBatchTask
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "WindowBatchTask.h"
+
+namespace
+{
+struct TestObject: public TObject {
+  TestObject(long long window, int value):
+    fWindow(window),
+    fValue(value)
+  {
+  }
+  long long getTimeWindowIndex() const
+  {
+    return fWindow;
+  }
+  long long fWindow;
+  int fValue;
+};
+
+typedef std::vector<int> Values;
+
+/// Returns the values of the objects of every window and keeps them in the order of the commits
+class TestTask: public WindowBatchTask<TestObject, Values>
+{
+public:
+  explicit TestTask(bool parallelSafe = false):
+    WindowBatchTask("TestTask", "test"),
+    fParallelSafe(parallelSafe)
+  {
+  }
+  void add(long long window, int value)
+  {
+    TestObject object(window, value);
+    setEvent(&object);
+    exec();
+  }
+  using WindowBatchTask::setMaxWindowObjects;
+  using WindowBatchTask::getSplitCount;
+
+  std::vector<Values> fCommitted;
+
+protected:
+  virtual Values processWindow(const std::vector<TestObject>& objects) override
+  {
+    Values values;
+    for (const auto& object : objects) {
+      values.push_back(object.fValue);
+    }
+    if (fParallelSafe) {
+      /// the earlier windows finish later
+      std::this_thread::sleep_for(std::chrono::microseconds(100 * (10 - objects.size() % 10)));
+    }
+    return values;
+  }
+  virtual void commitWindow(Values& values) override
+  {
+    fCommitted.push_back(values);
+  }
+  virtual bool isParallelSafe() const override
+  {
+    return fParallelSafe;
+  }
+
+  bool fParallelSafe;
+};
+
+/// Skips the odd values and uses the tens of the value as the window index
+class DecadeTask: public TestTask
+{
+protected:
+  virtual bool accept(const TestObject& object) override
+  {
+    return object.fValue % 2 == 0;
+  }
+  virtual long long getWindowIndex(const TestObject& object) const override
+  {
+    return object.fValue / 10;
+  }
+};
+}
+
+BOOST_AUTO_TEST_SUITE (WindowBatchTaskSuite)
+
+BOOST_AUTO_TEST_CASE (windowsSplitOnIndexChange)
+{
+  TestTask task;
+  task.init(JPetTaskInterface::Options());
+  task.add(0, 1);
+  task.add(0, 2);
+  task.add(1, 3);
+  task.add(1, 4);
+  task.add(1, 5);
+  BOOST_REQUIRE_EQUAL(task.fCommitted.size(), 1u);
+  task.add(3, 6);
+  std::vector<Values> expected = {{1, 2}, {3, 4, 5}};
+  BOOST_REQUIRE(task.fCommitted == expected);
+  /// the last window is processed in terminate()
+  task.terminate();
+  expected.push_back({6});
+  BOOST_REQUIRE(task.fCommitted == expected);
+  BOOST_REQUIRE_EQUAL(task.getSplitCount(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE (emptyInputCommitsNothing)
+{
+  TestTask task;
+  task.init(JPetTaskInterface::Options());
+  task.terminate();
+  BOOST_REQUIRE(task.fCommitted.empty());
+}
+
+BOOST_AUTO_TEST_CASE (largeWindowsProcessedInParts)
+{
+  TestTask task;
+  task.init(JPetTaskInterface::Options());
+  task.setMaxWindowObjects(2);
+  for (int i = 0; i < 5; i++) {
+    task.add(7, i);
+  }
+  /// a window of exactly the maximum size is not split
+  task.add(8, 5);
+  task.add(8, 6);
+  task.add(9, 7);
+  task.terminate();
+  std::vector<Values> expected = {{0, 1}, {2, 3}, {4}, {5, 6}, {7}};
+  BOOST_REQUIRE(task.fCommitted == expected);
+  BOOST_REQUIRE_EQUAL(task.getSplitCount(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE (threadsCommitInWindowOrder)
+{
+  TestTask task(true);
+  JPetTaskInterface::Options opts;
+  opts["TestTask_Threads"] = "4";
+  task.init(opts);
+  std::vector<Values> expected;
+  for (int window = 0; window < 100; window++) {
+    expected.push_back(Values());
+    for (int i = 0; i <= window % 10; i++) {
+      task.add(window, window);
+      expected.back().push_back(window);
+    }
+  }
+  task.terminate();
+  BOOST_REQUIRE(task.fCommitted == expected);
+}
+
+BOOST_AUTO_TEST_CASE (threadsIgnoredIfNotParallelSafe)
+{
+  TestTask task;
+  JPetTaskInterface::Options opts;
+  opts["TestTask_Threads"] = "4";
+  task.init(opts);
+  task.add(0, 1);
+  task.add(1, 2);
+  /// processed at once in the thread of the loader
+  BOOST_REQUIRE_EQUAL(task.fCommitted.size(), 1u);
+  task.terminate();
+  BOOST_REQUIRE_EQUAL(task.fCommitted.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE (malformedThreadsIgnored)
+{
+  TestTask task(true);
+  JPetTaskInterface::Options opts;
+  opts["TestTask_Threads"] = "four";
+  task.init(opts);
+  task.add(0, 1);
+  task.add(1, 2);
+  /// the default of no threads is kept
+  BOOST_REQUIRE_EQUAL(task.fCommitted.size(), 1u);
+  task.terminate();
+  BOOST_REQUIRE_EQUAL(task.fCommitted.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE (acceptAndWindowIndexOverridden)
+{
+  DecadeTask task;
+  task.init(JPetTaskInterface::Options());
+  for (int value : {1, 2, 4, 9, 12, 13, 18, 22}) {
+    task.add(0, value);
+  }
+  task.terminate();
+  std::vector<Values> expected = {{2, 4}, {12, 18}, {22}};
+  BOOST_REQUIRE(task.fCommitted == expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,159 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file CoincidenceStudy.cpp
+ */
+
+#include <cmath>
+#include "CoincidenceStudy.h"
+
+CoincidenceStudy::Hit::Hit(const JPetHit& hit, const HitThresholdTimes& times):
+  fSlotID(hit.getBarrelSlot().getID()),
+  fScinID(hit.getScintillator().getID()),
+  fTimes(times)
+{
+}
+
+void CoincidenceStudy::init(JPetStatistics& statistics, const JPetParamBank& paramBank,
+                            const LargeBarrelMapping& mapping, int oppositeTolerance)
+{
+  fBarrelMap = &mapping;
+  fSlotPairs.build(mapping, oppositeTolerance);
+  int n_histos = mapping.getNumberOfLayers() * kNumOfThresholds;
+  fDeltaIDHistos.assign(n_histos, nullptr);
+  fTOFvsDeltaIDHistos.assign(n_histos, nullptr);
+  fTOTvsTOTHistosA.assign(n_histos, nullptr);
+  fTOTvsTOTHistosB.assign(n_histos, nullptr);
+  for (auto const& layer : paramBank.getLayers()) {
+    int layer_number = mapping.getLayerNumber(*layer.second);
+    for (int thr = 1; thr <= kNumOfThresholds; thr++) {
+      int histo_index = getHistoIndex(layer_number, thr);
+      // create histograms of Delta ID
+      char* histo_name = Form("Delta_ID_for_coincidences_layer_%d_thr_%d", layer_number, thr);
+      char* histo_title = Form("%s;#Delta ID", histo_name);
+      int n_slots_in_half_layer = mapping.getNumberOfSlots(layer_number) / 2;
+      statistics.createHistogram(new TH1F(histo_name, histo_title,
+                                          n_slots_in_half_layer, 0.5, n_slots_in_half_layer + 0.5));
+      fDeltaIDHistos[histo_index] = &statistics.getHisto1D(histo_name);
+
+      // create histograms of TOF vs Delta ID
+      histo_name = Form("TOF_vs_Delta_ID_layer_%d_thr_%d", layer_number, thr);
+      histo_title = Form("%s;#Delta ID;TOF [ns]", histo_name);
+      statistics.createHistogram(new TH2F(histo_name, histo_title,
+                                          n_slots_in_half_layer, 0.5, n_slots_in_half_layer + 0.5,
+                                          100, 0., 15.));
+      fTOFvsDeltaIDHistos[histo_index] = &statistics.getHisto2D(histo_name);
+
+      // create histograms for TOT vs TOT
+      for (char side : {'A', 'B'}) {
+        histo_name = Form("TOT_vs_TOT_layer_%d_thr_%d_side_%c", layer_number, thr, side);
+        histo_title = Form("%s;TOT [ns];TOT [ns]", histo_name);
+        statistics.createHistogram(new TH2F(histo_name, histo_title, 120, 0., 120., 120, 0., 120.));
+        auto& histos = (side == 'A' ? fTOTvsTOTHistosA : fTOTvsTOTHistosB);
+        histos[histo_index] = &statistics.getHisto2D(histo_name);
+      }
+    }
+  }
+
+  // create dt histos for each strip
+  fDTOFHistos.clear();
+  for (auto const& scin : paramBank.getScintillators()) {
+    int slot_ID = scin.second->getBarrelSlot().getID();
+    if (static_cast<std::size_t>((slot_ID + 1) * kNumOfThresholds) > fDTOFHistos.size()) {
+      fDTOFHistos.resize((slot_ID + 1) * kNumOfThresholds, nullptr);
+    }
+    for (int thr = 1; thr <= kNumOfThresholds; thr++) {
+      const char* histo_name = formatUniqueSlotDescription(slot_ID, thr, "dTOF_");
+      statistics.createHistogram(new TH1F(histo_name, histo_name, 2000, -20., 20.));
+      fDTOFHistos[slot_ID * kNumOfThresholds + thr - 1] = &statistics.getHisto1D(histo_name);
+    }
+  }
+}
+
+void CoincidenceStudy::fillCoincidenceHistos(const std::vector<Hit>& hits)
+{
+  for (std::size_t i = 0; i < hits.size(); ++i) {
+    for (std::size_t j = i + 1; j < hits.size(); ++j) {
+      const Hit& hit1 = hits[i];
+      const Hit& hit2 = hits[j];
+      // Delta ID is -1 for the slots from different layers
+      int delta_ID = fSlotPairs.getDeltaID(hit1.fSlotID, hit2.fSlotID);
+      // if there are two hits from the same layer but different scintillators
+      if (delta_ID < 0 || hit1.fScinID == hit2.fScinID) {
+        continue;
+      }
+      int layer_number = fBarrelMap->getSlotLayerNumber(hit1.fSlotID);
+      // thresholds at which both hits have a good time difference
+      unsigned int good_thresholds = hit1.fGoodTimeDiffs & hit2.fGoodTimeDiffs;
+      // study the coincidences independently for each threshold
+      for (int thr = 1; thr <= kNumOfThresholds; thr++) {
+        if (!(good_thresholds & (1u << (thr - 1)))) {
+          continue;
+        }
+        double tof = std::fabs(hit1.fTimes.getTimeAtThr(thr) - hit2.fTimes.getTimeAtThr(thr));
+        tof /= 1000.; // [ns]
+        // check coincidence window
+        if (tof < 50.0) {
+          // study the coincidence and fill histograms
+          int histo_index = getHistoIndex(layer_number, thr);
+          fDeltaIDHistos[histo_index]->Fill(delta_ID);
+          fTOFvsDeltaIDHistos[histo_index]->Fill(delta_ID, tof);
+          if (delta_ID == 24) {
+            std::size_t dtof_index = hit1.fSlotID * kNumOfThresholds + thr - 1;
+            if (dtof_index < fDTOFHistos.size() && fDTOFHistos[dtof_index]) {
+              fDTOFHistos[dtof_index]->Fill(tof);
+            }
+          }
+          // fill TOT vs TOT histos
+          fillTOTvsTOThisto(thr, histo_index, hit1, hit2);
+        }
+      }
+    }
+  }
+}
+
+bool CoincidenceStudy::isGoodTimeDiff(const HitThresholdTimes& times, int thr, double meanTimeDiff)
+{
+  if (!times.hasTimeAtThr(thr)) {
+    return false;
+  }
+  double this_hit_timediff = times.getTimeDiffAtThr(thr) / 1000.; // [ns]
+  return std::fabs(this_hit_timediff - meanTimeDiff) < 1.0;
+}
+
+int CoincidenceStudy::getHistoIndex(int layer_number, int thr) const
+{
+  return (layer_number - 1) * kNumOfThresholds + thr - 1;
+}
+
+const char* CoincidenceStudy::formatUniqueSlotDescription(int slotID, int threshold, const char* prefix) const
+{
+  return Form("%slayer_%d_slot_%d_thr_%d",
+              prefix,
+              fBarrelMap->getSlotLayerNumber(slotID),
+              fBarrelMap->getSlotNumberByID(slotID),
+              threshold);
+}
+
+void CoincidenceStudy::fillTOTvsTOThisto(int thr, int histo_index, const Hit& hit1, const Hit& hit2)
+{
+  // skip non-opposite coincidences
+  if (!fSlotPairs.isNearOpposite(hit1.fSlotID, hit2.fSlotID)) return;
+  const HitThresholdTimes& times1 = hit1.fTimes;
+  const HitThresholdTimes& times2 = hit2.fTimes;
+  if (!times1.hasTOT(JPetPM::SideA, thr) || !times1.hasTOT(JPetPM::SideB, thr)
+      || !times2.hasTOT(JPetPM::SideA, thr) || !times2.hasTOT(JPetPM::SideB, thr)) return;
+  // fill side A
+  fTOTvsTOTHistosA[histo_index]->Fill(times1.getTOT(JPetPM::SideA, thr) / 1000., times2.getTOT(JPetPM::SideA, thr) / 1000.);
+  // fill side B
+  fTOTvsTOTHistosB[histo_index]->Fill(times1.getTOT(JPetPM::SideB, thr) / 1000., times2.getTOT(JPetPM::SideB, thr) / 1000.);
+}
@@ -0,0 +1,77 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file CoincidenceStudy.h
+ */
+
+#ifndef COINCIDENCESTUDY_H
+#define COINCIDENCESTUDY_H
+
+#include <vector>
+#include <JPetHit/JPetHit.h>
+#include <JPetParamBank/JPetParamBank.h>
+#include <JPetStatistics/JPetStatistics.h>
+#include "HitThresholdTimes.h"
+#include "LargeBarrelMapping.h"
+#include "SlotPairTable.h"
+
+/**
+ * @brief Study of the 2-strip coincidences among the hits of one time window.
+ *
+ * Fills the histograms of Delta ID, TOF vs Delta ID, TOT vs TOT of the opposite
+ * slots and TOF of each slot, separately for each threshold. The hits are passed
+ * as compact records, so the study can be run directly on JPetHit-s (TaskE) or on
+ * the records buffered by the fused calibration (TaskDE).
+ */
+class CoincidenceStudy
+{
+public:
+  static const int kNumOfThresholds = HitThresholdTimes::kNumOfThresholds;
+
+  /// Compact hit; trivially copyable, so it can be written to a file as it is
+  struct Hit {
+    int fSlotID = -1;
+    int fScinID = -1;
+    /// bit thr - 1 is set if the time difference A-B at the threshold is close to its mean
+    unsigned int fGoodTimeDiffs = 0;
+    HitThresholdTimes fTimes;
+
+    Hit() {}
+    Hit(const JPetHit& hit, const HitThresholdTimes& times);
+  };
+
+  /// Creates the histograms; the mapping must be kept by the caller
+  void init(JPetStatistics& statistics, const JPetParamBank& paramBank,
+            const LargeBarrelMapping& mapping, int oppositeTolerance);
+  /// Considers all possible 2-strip coincidences among the hits from a single time window
+  void fillCoincidenceHistos(const std::vector<Hit>& hits);
+
+  /// True if the time difference A-B at the threshold [ps] is within 1 ns of the mean [ns]
+  static bool isGoodTimeDiff(const HitThresholdTimes& times, int thr, double meanTimeDiff);
+
+private:
+  int getHistoIndex(int layer_number, int thr) const;
+  const char* formatUniqueSlotDescription(int slotID, int threshold, const char* prefix) const;
+  void fillTOTvsTOThisto(int thr, int histo_index, const Hit& hit1, const Hit& hit2);
+
+  const LargeBarrelMapping* fBarrelMap = nullptr;
+  // Delta ID and opposite slots of all pairs of slots, built once in init()
+  SlotPairTable fSlotPairs;
+  // histograms of every layer and threshold, indexed by getHistoIndex()
+  std::vector<TH1F*> fDeltaIDHistos;
+  std::vector<TH2F*> fTOFvsDeltaIDHistos;
+  std::vector<TH2F*> fTOTvsTOTHistosA;
+  std::vector<TH2F*> fTOTvsTOTHistosB;
+  // dTOF histograms indexed by slot ID * kNumOfThresholds + thr - 1
+  std::vector<TH1F*> fDTOFHistos;
+};
+#endif /*  !COINCIDENCESTUDY_H */
@@ -0,0 +1,40 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file HitThresholdTimes.cpp
+ */
+
+#include <RawSignalView.h>
+#include "HitThresholdTimes.h"
+
+HitThresholdTimes::HitThresholdTimes(const JPetHit& hit)
+{
+  RawSignalView viewA(hit.getSignalA().getRecoSignal().getRawSignal());
+  RawSignalView viewB(hit.getSignalB().getRecoSignal().getRawSignal());
+  const RawSignalView* views[4] = {&viewA, &viewA, &viewB, &viewB};
+  const JPetSigCh::EdgeType edges[4] = {JPetSigCh::Leading, JPetSigCh::Trailing, JPetSigCh::Leading, JPetSigCh::Trailing};
+  bool hasReference = false;
+  for (int row = 0; row < 4; row++) {
+    const double* times = views[row]->getTimes(edges[row]);
+    for (int thr = 1; thr <= kNumOfThresholds; thr++) {
+      if (!views[row]->hasTime(edges[row], thr)) {
+        continue;
+      }
+      if (!hasReference) {
+        fReference = times[thr - 1];
+        hasReference = true;
+      }
+      fOffsets[row][thr - 1] = times[thr - 1] - fReference;
+      fPresent |= 1u << (row * kNumOfThresholds + thr - 1);
+    }
+  }
+}
@@ -0,0 +1,96 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file HitThresholdTimes.h
+ */
+
+#ifndef HITTHRESHOLDTIMES_H
+#define HITTHRESHOLDTIMES_H
+
+#include <cstdint>
+#include <JPetHit/JPetHit.h>
+
+/**
+ * @brief Leading and trailing times of both signals of a hit at thresholds 1-4.
+ *
+ * Computed once when the hit enters a task, instead of building the maps of
+ * getTimesVsThresholdNumber() and getTOTsVsThresholdNumber() for every query.
+ * The times are stored as float offsets from a double reference time
+ * (the first time of the hit), which keeps them exact to well below 1 ps
+ * for signals up to microseconds long. A bit is set for every time that is present.
+ */
+class HitThresholdTimes
+{
+public:
+  static const int kNumOfThresholds = 4;
+
+  HitThresholdTimes() {}
+  explicit HitThresholdTimes(const JPetHit& hit);
+
+  bool hasLead(JPetPM::Side side, int thr) const
+  {
+    return isPresent(side == JPetPM::SideA ? kLeadA : kLeadB, thr);
+  }
+  bool hasTrail(JPetPM::Side side, int thr) const
+  {
+    return isPresent(side == JPetPM::SideA ? kTrailA : kTrailB, thr);
+  }
+  /// [ps]
+  double getLead(JPetPM::Side side, int thr) const
+  {
+    return fReference + fOffsets[side == JPetPM::SideA ? kLeadA : kLeadB][thr - 1];
+  }
+  double getTrail(JPetPM::Side side, int thr) const
+  {
+    return fReference + fOffsets[side == JPetPM::SideA ? kTrailA : kTrailB][thr - 1];
+  }
+  bool hasTOT(JPetPM::Side side, int thr) const
+  {
+    return hasLead(side, thr) && hasTrail(side, thr);
+  }
+  /// trailing - leading time of one side [ps], as getTOTsVsThresholdNumber()
+  double getTOT(JPetPM::Side side, int thr) const
+  {
+    int lead = side == JPetPM::SideA ? kLeadA : kLeadB;
+    return fOffsets[lead + 1][thr - 1] - fOffsets[lead][thr - 1];
+  }
+  /// true if there is a leading time at the threshold on both sides
+  bool hasTimeAtThr(int thr) const
+  {
+    return hasLead(JPetPM::SideA, thr) && hasLead(JPetPM::SideB, thr);
+  }
+  /// mean of the leading times of both sides [ps], as JPetHitUtils::getTimeAtThr
+  double getTimeAtThr(int thr) const
+  {
+    return fReference + 0.5 * (fOffsets[kLeadA][thr - 1] + fOffsets[kLeadB][thr - 1]);
+  }
+  /// side A - side B leading time [ps], as JPetHitUtils::getTimeDiffAtThr
+  double getTimeDiffAtThr(int thr) const
+  {
+    return fOffsets[kLeadA][thr - 1] - fOffsets[kLeadB][thr - 1];
+  }
+
+private:
+  /// rows of fOffsets, the trailing edge follows the leading edge of the same side
+  enum Row { kLeadA = 0, kTrailA = 1, kLeadB = 2, kTrailB = 3 };
+
+  bool isPresent(int row, int thr) const
+  {
+    return thr >= 1 && thr <= kNumOfThresholds
+           && (fPresent & (1u << (row * kNumOfThresholds + thr - 1)));
+  }
+
+  double fReference = 0.;
+  float fOffsets[4][kNumOfThresholds] = {};
+  std::uint16_t fPresent = 0;
+};
+#endif /*  !HITTHRESHOLDTIMES_H */
@@ -17,7 +17,21 @@
 #include "TaskA.h"
 TaskA::TaskA(const char * name, const char * description)
 :JPetTask(name, description),fCurrEventNumber(0){}
-void TaskA::init(const JPetTaskInterface::Options& ){
+void TaskA::init(const JPetTaskInterface::Options& opts){
+	if (opts.count("TaskA_PackedFile")) {
+		fPackedWriter.reset(new PackedTimeWindowFile::Writer(opts.at("TaskA_PackedFile")));
+		if (!fPackedWriter->isOpen()) {
+			ERROR(Form("Could not open the packed time window file %s", opts.at("TaskA_PackedFile").c_str()));
+			fPackedWriter.reset();
+		}
+	}
+	if (opts.count("TaskA_PackedOnly")) {
+		fPackedOnly = (opts.at("TaskA_PackedOnly") == "true");
+		if (fPackedOnly && !fPackedWriter) {
+			WARNING("No packed time window file is written, the signal channels are kept in the ROOT output");
+			fPackedOnly = false;
+		}
+	}
 	getStatistics().createHistogram( new TH1F("HitsPerEvtCh","Hits per channel in one event",50,-0.5,49.5) );
 	getStatistics().createHistogram( new TH1F("ChannelsPerEvt","Channels fired in one event",200,-0.5,199.5) );
 }
@@ -32,6 +46,8 @@ void TaskA::exec(){
 		getStatistics().getHisto1D("ChannelsPerEvt").Fill( ntdc );
 		JPetTimeWindow tslot;
 		tslot.setIndex(fCurrEventNumber);
+		fPackedWindow.clear();
+		fPackedWindow.setIndex(fCurrEventNumber);
 		auto tdcHits = evt->GetTDCChannelsArray();
 		for (int i = 0; i < ntdc; ++i) {
 			//const is commented because this class has inproper architecture:
@@ -62,6 +78,13 @@ void TaskA::exec(){
                           if( tdcChannel->GetTrailTime(j) > kMaxTime ||
                               tdcChannel->GetTrailTime(j) < kMinTime )continue;
 
+			  if( fPackedWriter ){
+			    int thr_number = tomb_channel.getLocalChannelNumber();
+			    fPackedWindow.add(tomb_number, JPetSigCh::Leading, thr_number, tdcChannel->GetLeadTime(j) * 1000.);
+			    fPackedWindow.add(tomb_number, JPetSigCh::Trailing, thr_number, tdcChannel->GetTrailTime(j) * 1000.);
+			    if( fPackedOnly ) continue;
+			  }
+
 			  JPetSigCh sigChTmpLead = generateSigCh(tomb_channel, JPetSigCh::Leading);
 			  JPetSigCh sigChTmpTrail = generateSigCh(tomb_channel, JPetSigCh::Trailing);
 
@@ -73,11 +96,18 @@ void TaskA::exec(){
 			}
 		}
 		saveTimeWindow(tslot);
+		if( fPackedWriter ){
+			fPackedWriter->write(fPackedWindow);
+		}
 		fCurrEventNumber++;
 	}
 }
 
-void TaskA::terminate(){}
+void TaskA::terminate(){
+	if( fPackedWriter ){
+		fPackedWriter->close();
+	}
+}
 void TaskA::saveTimeWindow( JPetTimeWindow slot){
 	assert(fWriter);
 	fWriter->write(slot);
@@ -16,18 +16,26 @@
 #ifndef TASKA_H
 #define TASKA_H
 
+#include <memory>
 #include <vector>
 #include <JPetTask/JPetTask.h>
 #include <JPetTimeWindow/JPetTimeWindow.h>
 #include <JPetParamBank/JPetParamBank.h>
 #include <JPetParamManager/JPetParamManager.h>
 #include <JPetTOMBChannel/JPetTOMBChannel.h>
+#include "PackedTimeWindowFile.h"
 class JPetWriter;
 #ifdef __CINT__
 //when cint is used instead of compiler, override word is not recognized
 //nevertheless it's needed for checking if the structure of project is correct
 #	define override
 #endif
+/**
+ * With the user option "TaskA_PackedFile" set to a file name, the windows are also written
+ * to this file as PackedTimeWindows (see CommonTools). With "TaskA_PackedOnly": "true"
+ * the windows in the ROOT output keep only their indices and TaskB1 reads the signal
+ * channels from the packed file given in "TaskB1_PackedInput".
+ */
 class TaskA: public JPetTask{
 public:
   TaskA(const char * name, const char * description);
@@ -46,5 +54,8 @@ protected:
   long long int fCurrEventNumber;
   const double kMaxTime = 0.;
   const double kMinTime = -1.e6;
+  std::unique_ptr<PackedTimeWindowFile::Writer> fPackedWriter;
+  PackedTimeWindow fPackedWindow;
+  bool fPackedOnly = false;
 };
 #endif /*  !TASKA_H */
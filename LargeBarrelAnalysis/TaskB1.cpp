@@ -13,6 +13,7 @@
  *  @file TaskB1.cpp
  */
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <JPetWriter/JPetWriter.h>
@@ -22,8 +23,15 @@ TaskB1::TaskB1(const char * name, const char * description):
 JPetTask(name, description){}
 TaskB1::~TaskB1(){}
 
-void TaskB1::init(const JPetTaskInterface::Options&){
-	fBarrelMap.buildMappings(getParamBank());
+void TaskB1::init(const JPetTaskInterface::Options& opts){
+	fBarrelMap.loadOrBuildMappings(getParamBank(), getAuxilliaryData());
+	if (opts.count("TaskB1_PackedInput")) {
+		fPackedReader.reset(new PackedTimeWindowFile::Reader(opts.at("TaskB1_PackedInput")));
+		if (!fPackedReader->isOpen()) {
+			ERROR(Form("Could not read the packed time window file %s", opts.at("TaskB1_PackedInput").c_str()));
+			fPackedReader.reset();
+		}
+	}
 	// create histograms for TOT - one for each DAQ channel
 	for(auto & tomb : getParamBank().getTOMBChannels()){
 		
@@ -47,64 +55,157 @@ void TaskB1::init(const JPetTaskInterface::Options&){
 		histo_title = Form("%s;PMT No.;No. hits", histo_name);
 		getStatistics().createHistogram( new TH1F(histo_name, histo_title, n_pmts, -0.5, n_pmts-0.5) );
 	}
+	buildChannelTable();
+}
+
+void TaskB1::buildChannelTable(){
+	// the PMs are stored in the order of their IDs, so that the signals can be written in this order
+	map<int, int> pm_indices;
+	fPMs.clear();
+	for(auto & pm : getParamBank().getPMs()){
+		pm_indices[pm.first] = fPMs.size();
+		fPMs.push_back(pm.second);
+	}
+	fSignals.assign(fPMs.size(), JPetRawSignal());
+	fSignalStamps.assign(fPMs.size(), 0);
+	// the TOT histogram and global PMT number of each DAQ channel are looked up here once,
+	// instead of formatting the histogram name for every edge
+	unsigned int max_channel = 0;
+	for(auto & tomb : getParamBank().getTOMBChannels()){
+		max_channel = std::max(max_channel, tomb.second->getChannel());
+	}
+	fChannels.assign(getParamBank().getTOMBChannels().empty() ? 0 : max_channel + 1, ChannelInfo());
+	fSlots.assign(fChannels.size(), ChannelSlot());
+	for(auto & tomb : getParamBank().getTOMBChannels()){
+		const JPetTOMBChannel & channel = *(tomb.second);
+		auto pm_index = pm_indices.find(channel.getPM().getID());
+		if( pm_index == pm_indices.end() ){
+			WARNING(Form("TOMB channel %d is not connected to any PM from the param bank", channel.getChannel()));
+			continue;
+		}
+		ChannelInfo & info = fChannels[channel.getChannel()];
+		info.fKnown = true;
+		info.fPMIndex = pm_index->second;
+		info.fPMTNumber = fBarrelMap.getGlobalPMNumber(channel.getPM());
+		info.fTOTHisto = &getStatistics().getHisto1D(formatUniqueChannelDescription(channel, "TOT_"));
+	}
+	fLeadHitsHistos.assign(kNumOfThresholds + 1, nullptr);
+	fTrailHitsHistos.assign(kNumOfThresholds + 1, nullptr);
+	for(int thr=1;thr<=kNumOfThresholds;thr++){
+		fLeadHitsHistos[thr] = &getStatistics().getHisto1D(Form("HitsLeadingEdge_thr%d", thr));
+		fTrailHitsHistos[thr] = &getStatistics().getHisto1D(Form("HitsTrailingEdge_thr%d", thr));
+	}
+	fEdgesHisto = &getStatistics().getHisto2D("was lead and trail edge?");
 }
 
 void TaskB1::exec(){
 	//getting the data from event in propriate format
 	if(auto timeWindow = dynamic_cast<const JPetTimeWindow*const>(getEvent())){
-		map<int,JPetSigCh> leadSigChs;
-		map<int,JPetSigCh> trailSigChs;
-		map<int, JPetRawSignal> signals; 
-		const unsigned int nSigChs = timeWindow->getNumberOfSigCh();
-		for (unsigned int i = 0; i < nSigChs; i++) {
-			JPetSigCh sigch = timeWindow->operator[](i);
-			int daq_channel = sigch.getChannel();
-			if( sigch.getType() == JPetSigCh::Leading )
-				leadSigChs[ daq_channel ] = sigch;
-			if( sigch.getType() == JPetSigCh::Trailing )
-				trailSigChs[ daq_channel ] = sigch;
-		}
-		// iterate over the leading-edge SigChs
-		for (auto & chSigPair : leadSigChs) {
-			int daq_channel = chSigPair.first;
-			if( trailSigChs.count(daq_channel) != 0 ){ 
-				getStatistics().getHisto2D("was lead and trail edge?").Fill(1.,1.);
-				JPetSigCh & leadSigCh = chSigPair.second;
-				JPetSigCh & trailSigCh = trailSigChs.at(daq_channel);
-				double tot = trailSigCh.getValue() - leadSigCh.getValue();
-				if( leadSigCh.getPM() != trailSigCh.getPM() ){
-					ERROR("Signals from same channel point to different PMTs! Check the setup mapping!!!");
-				}
-				const char * histo_name = formatUniqueChannelDescription(leadSigCh.getTOMBChannel(), "TOT_");
-				getStatistics().getHisto1D(histo_name).Fill( tot / 1000. );
-				int pmt_number = calcGlobalPMTNumber(leadSigCh.getPM());
-				getStatistics().getHisto1D(Form("HitsLeadingEdge_thr%d", leadSigCh.getThresholdNumber())).Fill(pmt_number);
-				double pmt_id = trailSigCh.getPM().getID();
-				signals[pmt_id].addPoint( leadSigCh );
-				signals[pmt_id].addPoint( trailSigCh );
+		if(fPackedReader){
+			// the signal channels of this window are in the packed file;
+			// the ones from channels missing in the param bank would be skipped by pairEdges anyway
+			fUnpackedWindow = JPetTimeWindow();
+			if(fPackedReader->readWindow(timeWindow->getIndex(), fPackedWindow)){
+				fPackedWindow.toTimeWindow(getParamBank(), fUnpackedWindow);
 			}else{
-				getStatistics().getHisto2D("was lead and trail edge?").Fill(0.,1.);
+				WARNING(Form("Time window %d not found in the packed time window file", static_cast<int>(timeWindow->getIndex())));
 			}
+			fUnpackedWindow.setIndex(timeWindow->getIndex());
+			timeWindow = &fUnpackedWindow;
 		}
-		// the above loop will not count cases where there was only trailing edge signal
-		// count this in a separate loop
-		for (const auto & chSigPair : trailSigChs) {
-			int daq_channel = chSigPair.first;
-			if( leadSigChs.count(daq_channel) == 0 )
-				getStatistics().getHisto2D("was lead and trail edge?").Fill(1.,0.);
-			int pmt_number = calcGlobalPMTNumber(chSigPair.second.getPM());
-			getStatistics().getHisto1D(Form("HitsTrailingEdge_thr%d", chSigPair.second.getThresholdNumber())).Fill(pmt_number);
-		}    
-		for(auto & pmSignalPair : signals){
-			auto & signal = pmSignalPair.second;
+		pairEdges(*timeWindow);
+		// write the signals in the order of the PM IDs
+		std::sort(fFiredPMs.begin(), fFiredPMs.end());
+		for(int pm_index : fFiredPMs){
+			auto & signal = fSignals[pm_index];
 			signal.setTimeWindowIndex( timeWindow->getIndex() );
-			const auto & pmt = getParamBank().getPM(pmSignalPair.first);
+			const auto & pmt = *fPMs[pm_index];
 			signal.setPM(pmt);
 			signal.setBarrelSlot(pmt.getBarrelSlot());
 			fWriter->write(signal);
 		}
 	}
 }
+
+void TaskB1::pairEdges(const JPetTimeWindow & timeWindow){
+	// the slots of all DAQ channels are kept between the windows; increasing the generation
+	// invalidates the edges of the previous window without clearing the slots
+	fGeneration++;
+	fLeadChannels.clear();
+	fTrailChannels.clear();
+	fFiredPMs.clear();
+	const unsigned int nSigChs = timeWindow.getNumberOfSigCh();
+	for (unsigned int i = 0; i < nSigChs; i++) {
+		const JPetSigCh & sigch = timeWindow[i];
+		unsigned int daq_channel = sigch.getChannel();
+		if( daq_channel >= fChannels.size() || !fChannels[daq_channel].fKnown ){
+			if( !fUnknownChannelReported ){
+				WARNING(Form("SigCh from DAQ channel %d not present in the param bank, such SigChs are skipped", daq_channel));
+				fUnknownChannelReported = true;
+			}
+			continue;
+		}
+		// as before, only the last edge of each type is kept for a channel
+		ChannelSlot & slot = fSlots[daq_channel];
+		if( sigch.getType() == JPetSigCh::Leading ){
+			if( slot.fLeadStamp != fGeneration ){
+				slot.fLeadStamp = fGeneration;
+				fLeadChannels.push_back(daq_channel);
+			}
+			slot.fLead = &sigch;
+		}
+		if( sigch.getType() == JPetSigCh::Trailing ){
+			if( slot.fTrailStamp != fGeneration ){
+				slot.fTrailStamp = fGeneration;
+				fTrailChannels.push_back(daq_channel);
+			}
+			slot.fTrail = &sigch;
+		}
+	}
+	// the channels are visited in increasing order, so the points of the signals are added in the same order as before
+	std::sort(fLeadChannels.begin(), fLeadChannels.end());
+	std::sort(fTrailChannels.begin(), fTrailChannels.end());
+	// iterate over the leading-edge SigChs
+	for (int daq_channel : fLeadChannels) {
+		const ChannelSlot & slot = fSlots[daq_channel];
+		const ChannelInfo & info = fChannels[daq_channel];
+		if( slot.fTrailStamp == fGeneration ){
+			fEdgesHisto->Fill(1.,1.);
+			const JPetSigCh & leadSigCh = *slot.fLead;
+			const JPetSigCh & trailSigCh = *slot.fTrail;
+			double tot = trailSigCh.getValue() - leadSigCh.getValue();
+			if( leadSigCh.getPM() != trailSigCh.getPM() ){
+				ERROR("Signals from same channel point to different PMTs! Check the setup mapping!!!");
+			}
+			info.fTOTHisto->Fill( tot / 1000. );
+			int thr = leadSigCh.getThresholdNumber();
+			if( thr > 0 && thr <= kNumOfThresholds ){
+				fLeadHitsHistos[thr]->Fill(info.fPMTNumber);
+			}
+			if( fSignalStamps[info.fPMIndex] != fGeneration ){
+				fSignalStamps[info.fPMIndex] = fGeneration;
+				fSignals[info.fPMIndex] = JPetRawSignal();
+				fFiredPMs.push_back(info.fPMIndex);
+			}
+			fSignals[info.fPMIndex].addPoint( leadSigCh );
+			fSignals[info.fPMIndex].addPoint( trailSigCh );
+		}else{
+			fEdgesHisto->Fill(0.,1.);
+		}
+	}
+	// the above loop will not count cases where there was only trailing edge signal
+	// count this in a separate loop
+	for (int daq_channel : fTrailChannels) {
+		const ChannelSlot & slot = fSlots[daq_channel];
+		if( slot.fLeadStamp != fGeneration )
+			fEdgesHisto->Fill(1.,0.);
+		int thr = slot.fTrail->getThresholdNumber();
+		if( thr > 0 && thr <= kNumOfThresholds ){
+			fTrailHitsHistos[thr]->Fill(fChannels[daq_channel].fPMTNumber);
+		}
+	}
+}
+
 void TaskB1::terminate(){}
 void TaskB1::saveRawSignal( JPetRawSignal sig){
 	assert(fWriter);
@@ -127,23 +228,6 @@ const char * TaskB1::formatUniqueChannelDescription(const JPetTOMBChannel & chan
 	);
 }
 
-int TaskB1::calcGlobalPMTNumber(const JPetPM & pmt) const {
-	
-	const int number_of_sides = 2;
-	
-	int layer_number = fBarrelMap.getLayerNumber(pmt.getBarrelSlot().getLayer());
-	int pmt_no = 0;
-	for(int l=1;l<layer_number;l++){
-		pmt_no += number_of_sides * fBarrelMap.getNumberOfSlots(l);
-	}
-	int slot_number = fBarrelMap.getSlotNumber(pmt.getBarrelSlot());
-	if( pmt.getSide() == JPetPM::SideB ){
-		pmt_no += fBarrelMap.getNumberOfSlots(layer_number);
-	}
-	pmt_no += slot_number - 1;
-	
-	return pmt_no;
-}
 void TaskB1::setWriter(JPetWriter* writer) {
 	fWriter = writer;
 }
@@ -16,6 +16,7 @@
 #ifndef TASKB1_H
 #define TASKB1_H
 
+#include <memory>
 #include <vector>
 #include <JPetTask/JPetTask.h>
 #include <JPetRawSignal/JPetRawSignal.h>
@@ -23,6 +24,7 @@
 #include <JPetParamBank/JPetParamBank.h>
 #include <JPetParamManager/JPetParamManager.h>
 #include "LargeBarrelMapping.h"
+#include "PackedTimeWindowFile.h"
 class JPetWriter;
 #ifdef __CINT__
 //when cint is used instead of compiler, override word is not recognized
@@ -43,10 +45,47 @@ public:
 protected:
   void saveRawSignal( JPetRawSignal sig);
   const char * formatUniqueChannelDescription(const JPetTOMBChannel & channel, const char * prefix) const;
-  int calcGlobalPMTNumber(const JPetPM & pmt) const;
+  void buildChannelTable();
+  void pairEdges(const JPetTimeWindow & timeWindow);
+  /// everything needed for one DAQ channel, found once in init()
+  struct ChannelInfo {
+    bool fKnown = false;
+    int fPMTNumber = -1;
+    int fPMIndex = -1;
+    TH1F* fTOTHisto = nullptr;
+  };
+  /// last edges of one DAQ channel in the current time window;
+  /// an edge is valid only if its stamp equals fGeneration
+  struct ChannelSlot {
+    unsigned int fLeadStamp = 0;
+    unsigned int fTrailStamp = 0;
+    const JPetSigCh* fLead = nullptr;
+    const JPetSigCh* fTrail = nullptr;
+  };
   JPetWriter* fWriter;
   JPetParamManager* fParamManager;
   LargeBarrelMapping fBarrelMap;
   const int kNumOfThresholds = 4;
+  /// indexed by DAQ channel
+  std::vector<ChannelInfo> fChannels;
+  std::vector<ChannelSlot> fSlots;
+  std::vector<int> fLeadChannels;
+  std::vector<int> fTrailChannels;
+  /// indexed by the position of the PM in the param bank, i.e. ordered by PM ID
+  std::vector<const JPetPM*> fPMs;
+  std::vector<JPetRawSignal> fSignals;
+  std::vector<unsigned int> fSignalStamps;
+  std::vector<int> fFiredPMs;
+  /// indexed by threshold number
+  std::vector<TH1F*> fLeadHitsHistos;
+  std::vector<TH1F*> fTrailHitsHistos;
+  TH2F* fEdgesHisto = nullptr;
+  /// set with the user option "TaskB1_PackedInput", when TaskA wrote the signal channels
+  /// only to a packed time window file
+  std::unique_ptr<PackedTimeWindowFile::Reader> fPackedReader;
+  PackedTimeWindow fPackedWindow;
+  JPetTimeWindow fUnpackedWindow;
+  unsigned int fGeneration = 0;
+  bool fUnknownChannelReported = false;
 };
 #endif /*  !TASKB1_H */
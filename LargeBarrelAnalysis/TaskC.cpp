@@ -14,18 +14,32 @@
  */
 
 #include <iostream>
+#include <limits>
 #include <JPetWriter/JPetWriter.h>
 #include <JPetAnalysisTools/JPetAnalysisTools.h>
+#include <RawSignalView.h>
 #include "TaskC.h"
 
 using namespace std;
 
 
-TaskC::TaskC(const char * name, const char * description):JPetTask(name, description){}
+TaskC::TaskC(const char * name, const char * description):WindowBatchTask(name, description){}
 TaskC::~TaskC(){}
 
-void TaskC::init(const JPetTaskInterface::Options&){
-  
+void TaskC::init(const JPetTaskInterface::Options& opts){
+  WindowBatchTask::init(opts);
+  TaskOptions::read(opts, "TaskC_MaxBufferedSignals", kMaxBufferedSignals);
+  setMaxWindowObjects(kMaxBufferedSignals);
+  fBarrelMap.loadOrBuildMappings(getParamBank(), getAuxilliaryData());
+  fSignalJoin.reset(new StreamingWindowJoin<JPetRawSignal>(
+    std::numeric_limits<double>::infinity(), kMaxBufferedSignals,
+    [this](const JPetRawSignal& signalA, const JPetRawSignal& signalB) {
+      JPetHit hit;
+      if (createHit(signalA, signalB, hit)) {
+        fHits.push_back(hit);
+      }
+    }));
+
   for(int i=1;i<=kNumOfThresholds;++i){
     getStatistics().createHistogram(new TH1F(Form("timeSepLarge_thr_%d", i),
 					     "time differences between subsequent hits; #Delta t [ns]",
@@ -46,114 +60,93 @@ void TaskC::init(const JPetTaskInterface::Options&){
   
 }
 
-void TaskC::exec(){
-	//getting the data from event in propriate format
-	if(auto currSignal = dynamic_cast<const JPetRawSignal*const>(getEvent())){
-		getStatistics().getCounter("No. initial signals")++;
-		if (fSignals.empty()) {
-			fSignals.push_back(*currSignal);
-		} else {
-			if (fSignals[0].getTimeWindowIndex() == currSignal->getTimeWindowIndex()) {
-				fSignals.push_back(*currSignal);
-			} else {
-
-			  vector<JPetHit> hits = createHits(fSignals);
-			  hits = JPetAnalysisTools::getHitsOrderedByTime(hits);
-			  // uncomment this in order to fill histograms
-			  // of time differences for subsequent hist
-			  studyTimeWindow(hits);
-			  
-			  saveHits(hits);
-			  
-			  fSignals.clear();
-			  fSignals.push_back(*currSignal);
-			}
+vector<JPetHit> TaskC::processWindow(const vector<JPetRawSignal>& signals){
+	getStatistics().getCounter("No. initial signals") += signals.size();
+	auto sameSidePairs = fSignalJoin->getSameSidePairCount();
+	for (const auto& signal : signals) {
+		int pm_ID = signal.getPM().getID();
+		bool known_pm = fBarrelMap.hasPM(pm_ID);
+		auto side = known_pm ? fBarrelMap.getPMSide(pm_ID) : signal.getPM().getSide();
+		if (side == JPetPM::SideA || side == JPetPM::SideB) {
+			int scin_ID = known_pm ? fBarrelMap.getPMScinID(pm_ID) : signal.getPM().getScin().getID();
+			fSignalJoin->add(signal.getTimeWindowIndex(), scin_ID,
+					 side == JPetPM::SideA, 0., signal);
 		}
 	}
+	fSignalJoin->flush();
+	// pairs of signals on the same side of a scintillator are not hits, they are only counted
+	getStatistics().getCounter("No. same side signal pairs") +=
+		fSignalJoin->getSameSidePairCount() - sameSidePairs;
+	vector<JPetHit> hits = JPetAnalysisTools::getHitsOrderedByTime(fHits);
+	fHits.clear();
+	return hits;
 }
-vector<JPetHit> TaskC::createHits(const vector<JPetRawSignal>&signals){
-	vector<JPetHit> hits;
-	for (auto i = signals.begin(); i != signals.end(); ++i) {
-		for (auto j = i; ++j != signals.end();) {
-			if (i->getPM().getScin() == j->getPM().getScin()) {
-				// found 2 signals from the same scintillator
-				// wrap the RawSignal objects into RecoSignal and PhysSignal
-				// for now this is just wrapping opne object into another
-				// in the future analyses it will involve more logic like
-				// reconstructing the signal's shape, charge, amplitude etc.
-				JPetRecoSignal recoSignalA;
-				JPetRecoSignal recoSignalB;
-				JPetPhysSignal physSignalA;
-				JPetPhysSignal physSignalB;
-				// assign sides A and B properly
-				if( 
-					(i->getPM().getSide() == JPetPM::SideA)
-					&&(j->getPM().getSide() == JPetPM::SideB)
-				){
-					recoSignalA.setRawSignal(*i);
-					recoSignalB.setRawSignal(*j);
-				} else if(
-					(j->getPM().getSide() == JPetPM::SideA)
-					&&(i->getPM().getSide() == JPetPM::SideB)
-				){
-					recoSignalA.setRawSignal(*j);
-					recoSignalB.setRawSignal(*i);
-				} else {
-					// if two hits on the same side, ignore
-					WARNING("TWO hits on the same scintillator side we ignore it");         
-					continue;
-				}
-				
-				if( recoSignalA.getRawSignal().getNumberOfPoints(JPetSigCh::Leading) < kNumOfThresholds ) continue;
-				if( recoSignalB.getRawSignal().getNumberOfPoints(JPetSigCh::Leading) < kNumOfThresholds ) continue;
-
-				bool thresholds_ok = true;
-				for(int i=1;i<=kNumOfThresholds;++i){
-				  if( recoSignalA.getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Leading).count(i) < 1 ){
-				    thresholds_ok = false;
-				  }
-				  if( recoSignalB.getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Leading).count(i) < 1 ){
-				    thresholds_ok = false;
-				  }
-				}
-				if(thresholds_ok == false){
-				  continue;
-				}
-				
-				physSignalA.setRecoSignal(recoSignalA);
-				physSignalB.setRecoSignal(recoSignalB);
-				auto leading_points_a = physSignalA.getRecoSignal().getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Leading);
-				auto leading_points_b = physSignalB.getRecoSignal().getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Leading);
-
-				physSignalA.setTime(leading_points_a.at(1));
-				physSignalB.setTime(leading_points_b.at(1));
-
-				
-				JPetHit hit;
-				hit.setSignalA(physSignalA);
-				hit.setSignalB(physSignalB);
-				hit.setScintillator(i->getPM().getScin());
-				hit.setBarrelSlot(i->getPM().getScin().getBarrelSlot());
-				
-				physSignalA.setTime(physSignalA.getRecoSignal().getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Leading).at(1));
-				physSignalB.setTime(physSignalB.getRecoSignal().getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Leading).at(1));
-
-				hit.setTime( 0.5 * ( hit.getSignalA().getTime() + hit.getSignalB().getTime()) );
-
-				hits.push_back(hit);
-				getStatistics().getCounter("No. found hits")++;
-			}
-		}
+
+void TaskC::commitWindow(vector<JPetHit>& hits){
+	// uncomment this in order to fill histograms
+	// of time differences for subsequent hist
+	studyTimeWindow(hits);
+
+	saveHits(hits);
+}
+
+bool TaskC::createHit(const JPetRawSignal& signalA, const JPetRawSignal& signalB, JPetHit& hit){
+	// found 2 signals from the same scintillator on the sides A and B
+	// wrap the RawSignal objects into RecoSignal and PhysSignal
+	// for now this is just wrapping opne object into another
+	// in the future analyses it will involve more logic like
+	// reconstructing the signal's shape, charge, amplitude etc.
+	JPetRecoSignal recoSignalA;
+	JPetRecoSignal recoSignalB;
+	JPetPhysSignal physSignalA;
+	JPetPhysSignal physSignalB;
+	recoSignalA.setRawSignal(signalA);
+	recoSignalB.setRawSignal(signalB);
+
+	// the views compute the times vs threshold number once for both checks and times
+	RawSignalView viewA(signalA);
+	RawSignalView viewB(signalB);
+	if( viewA.getNumberOfPoints(JPetSigCh::Leading) < static_cast<std::size_t>(kNumOfThresholds) ) return false;
+	if( viewB.getNumberOfPoints(JPetSigCh::Leading) < static_cast<std::size_t>(kNumOfThresholds) ) return false;
+
+	if( !viewA.hasThresholds(JPetSigCh::Leading, kNumOfThresholds)
+	    || !viewB.hasThresholds(JPetSigCh::Leading, kNumOfThresholds) ){
+	  return false;
 	}
-	return hits;
+
+	physSignalA.setRecoSignal(recoSignalA);
+	physSignalB.setRecoSignal(recoSignalB);
+
+	physSignalA.setTime(viewA.getTime(JPetSigCh::Leading, 1));
+	physSignalB.setTime(viewB.getTime(JPetSigCh::Leading, 1));
+
+	hit.setSignalA(physSignalA);
+	hit.setSignalB(physSignalB);
+	hit.setScintillator(signalA.getPM().getScin());
+	hit.setBarrelSlot(signalA.getPM().getScin().getBarrelSlot());
+
+	hit.setTime( 0.5 * ( hit.getSignalA().getTime() + hit.getSignalB().getTime()) );
+
+	getStatistics().getCounter("No. found hits")++;
+	return true;
 }
 
 void TaskC::terminate(){
-  //	saveHits(createHits(fSignals)); //if there is something left
+	WindowBatchTask::terminate(); //the last time window is processed here
 	INFO( Form("From %d initial signals %d hits were paired.", 
 		   static_cast<int>(getStatistics().getCounter("No. initial signals")),
 		   static_cast<int>(getStatistics().getCounter("No. found hits")) )
 	);
+	if (getStatistics().getCounter("No. same side signal pairs") > 0) {
+		WARNING( Form("%d pairs of signals on the same side of a scintillator were ignored.",
+			      static_cast<int>(getStatistics().getCounter("No. same side signal pairs")) )
+		);
+	}
+	if (getSplitCount() > 0) {
+		WARNING( Form("Time windows larger than %d signals were split %d times.",
+			      static_cast<int>(kMaxBufferedSignals), static_cast<int>(getSplitCount()) )
+		);
+	}
 }
 
 
@@ -162,11 +155,14 @@ void TaskC::terminate(){
 void TaskC::studyTimeWindow(const vector<JPetHit>&hits){
 
   // plot time differences for subsequent hits at each threshold separately
+  // hit times at all thresholds are computed once per hit
+  fHitTimes.clear();
+  for(const auto & hit : hits){
+    fHitTimes.push_back(HitThresholdTimes(hit));
+  }
   for(unsigned int i=1; i<hits.size(); ++i){
     for(int k=1;k<=kNumOfThresholds;++k){
-      double t2 = 0.5*(hits.at(i).getSignalA().getRecoSignal().getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Leading).at(k) + hits.at(i).getSignalB().getRecoSignal().getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Leading).at(k));
-      double t1 = 0.5*(hits.at(i-1).getSignalA().getRecoSignal().getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Leading).at(k) + hits.at(i-1).getSignalB().getRecoSignal().getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Leading).at(k));
-      double dt = t2 - t1;
+      double dt = fHitTimes[i].getTimeAtThr(k) - fHitTimes[i-1].getTimeAtThr(k);
       getStatistics().getHisto1D(Form("timeSepSmall_thr_%d", k)).Fill(dt / 1000.); // we fill the histo in [ns]
       getStatistics().getHisto1D(Form("timeSepLarge_thr_%d", k)).Fill(dt / 1000.); // we fill the histo in [ns]
     }
@@ -16,29 +16,42 @@
 #ifndef TASKC_H 
 #define TASKC_H 
 
-#include <JPetTask/JPetTask.h>
+#include <memory>
 #include <JPetHit/JPetHit.h>
 #include <JPetRawSignal/JPetRawSignal.h>
+#include <LargeBarrelMapping.h>
+#include <StreamingWindowJoin.h>
+#include <WindowBatchTask.h>
+#include "HitThresholdTimes.h"
 class JPetWriter;
 #ifdef __CINT__
 //when cint is used instead of compiler, override word is not recognized
 //nevertheless it's needed for checking if the structure of project is correct
 #	define override
 #endif
-class TaskC:public JPetTask {
+class TaskC:public WindowBatchTask<JPetRawSignal, std::vector<JPetHit>> {
 public:
   TaskC(const char * name, const char * description);
   virtual ~TaskC();
   virtual void init(const JPetTaskInterface::Options& opts)override;
-  virtual void exec()override;
   virtual void terminate()override;
   virtual void setWriter(JPetWriter* writer)override;
 protected:
-  std::vector<JPetHit> createHits(const std::vector<JPetRawSignal>& signals);
+  virtual std::vector<JPetHit> processWindow(const std::vector<JPetRawSignal>& signals)override;
+  virtual void commitWindow(std::vector<JPetHit>& hits)override;
+  bool createHit(const JPetRawSignal& signalA, const JPetRawSignal& signalB, JPetHit& hit);
   void saveHits(const std::vector<JPetHit>&hits);
   void studyTimeWindow(const std::vector<JPetHit>&hits);
-  std::vector<JPetRawSignal> fSignals;
+  /// signals of a time window keyed on scintillator ID, side A on the left;
+  /// all the pairs of sides A and B of a scintillator are matched
+  std::unique_ptr<StreamingWindowJoin<JPetRawSignal>> fSignalJoin;
+  std::vector<JPetHit> fHits;
+  std::vector<HitThresholdTimes> fHitTimes;
+  /// scintillator and side of the PMs by their IDs
+  LargeBarrelMapping fBarrelMap;
   JPetWriter* fWriter;
   const int kNumOfThresholds=4;
+  /// signals of a time window buffered at most, option "TaskC_MaxBufferedSignals"
+  std::size_t kMaxBufferedSignals = 100000;
 };
 #endif /*  !TASKD_H */
@@ -19,7 +19,7 @@
 
 TaskD::TaskD(const char * name, const char * description):JPetTask(name, description){}
 void TaskD::init(const JPetTaskInterface::Options&){
-	fBarrelMap.buildMappings(getParamBank());
+	fBarrelMap.loadOrBuildMappings(getParamBank(), getAuxilliaryData());
 	// create histograms for time differences at each slot and each threshold
 	for(auto & scin : getParamBank().getScintillators()){
 		for (int thr=1;thr<=4;thr++){
@@ -41,7 +41,7 @@ void TaskD::init(const JPetTaskInterface::Options&){
 void TaskD::exec(){
 	//getting the data from event in propriate format
 	if(auto hit =dynamic_cast<const JPetHit*const>(getEvent())){
-		fillHistosForHit(*hit);
+		fillHistosForHit(*hit, HitThresholdTimes(*hit));
 		fWriter->write(*hit);
 	}
 }
@@ -51,24 +51,25 @@ void TaskD::terminate(){
 	// save timeDiffAB mean values for each slot and each threshold in a JPetAuxilliaryData object
 	// so that they are available to the consecutive modules
 	getAuxilliaryData().createMap("timeDiffAB mean values");
+	// the same values are also saved as a numeric table, read by the next modules without string keys
+	fTimeDiffMeans.build(fBarrelMap);
 
 	for(auto & slot : getParamBank().getBarrelSlots()){
 		for (int thr=1;thr<=4;thr++){
 			const char * histo_name = formatUniqueSlotDescription(*(slot.second), thr, "timeDiffAB_");
 			double mean = getStatistics().getHisto1D(histo_name).GetMean();
 			getAuxilliaryData().setValue("timeDiffAB mean values", histo_name, mean);
+			fTimeDiffMeans.set(fBarrelMap.getLayerNumber(slot.second->getLayer()), fBarrelMap.getSlotNumber(*(slot.second)), thr, mean);
 		}
 	}
+	fTimeDiffMeans.saveToAuxilliaryData(getAuxilliaryData(), "timeDiffAB mean values table");
 	
 }
 
-void TaskD::fillHistosForHit(const JPetHit & hit){
-	auto lead_times_A = hit.getSignalA().getRecoSignal().getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Leading);
-	auto lead_times_B = hit.getSignalB().getRecoSignal().getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Leading);
-	for(auto & thr_time_pair : lead_times_A){
-		int thr = thr_time_pair.first;
-		if( lead_times_B.count(thr) > 0 ){ // if there was leading time at the same threshold at opposite side
-			double timeDiffAB = lead_times_A[thr] - lead_times_B[thr];
+void TaskD::fillHistosForHit(const JPetHit & hit, const HitThresholdTimes & times){
+	for(int thr=1;thr<=HitThresholdTimes::kNumOfThresholds;thr++){
+		if( times.hasTimeAtThr(thr) ){ // if there was leading time at the same threshold at both sides
+			double timeDiffAB = times.getTimeDiffAtThr(thr);
 			timeDiffAB /= 1000.; // we want the plots in ns instead of ps
 			// fill the appropriate histogram
 			const char * histo_name = formatUniqueSlotDescription(hit.getBarrelSlot(), thr, "timeDiffAB_");
@@ -19,7 +19,9 @@
 #include <JPetTask/JPetTask.h>
 #include <JPetHit/JPetHit.h>
 #include <JPetRawSignal/JPetRawSignal.h>
+#include "HitThresholdTimes.h"
 #include "LargeBarrelMapping.h"
+#include "SlotThresholdTable.h"
 class JPetWriter;
 #ifdef __CINT__
 //when cint is used instead of compiler, override word is not recognized
@@ -36,8 +38,10 @@ public:
 	virtual void setWriter(JPetWriter* writer)override;
 protected:
 	const char * formatUniqueSlotDescription(const JPetBarrelSlot & slot, int threshold,const char * prefix);
-	void fillHistosForHit(const JPetHit & hit);
+	void fillHistosForHit(const JPetHit & hit, const HitThresholdTimes & times);
 	JPetWriter* fWriter;
 	LargeBarrelMapping fBarrelMap;
+	// mean timeDiffAB [ns] of each slot and threshold, filled in terminate()
+	SlotThresholdTable fTimeDiffMeans;
 };
 #endif /*  !TASKD_H */
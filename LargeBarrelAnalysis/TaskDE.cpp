@@ -0,0 +1,123 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file TaskDE.cpp
+ */
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <JPetWriter/JPetWriter.h>
+#include <TaskOptions.h>
+#include "TaskDE.h"
+
+TaskDE::TaskDE(const char * name, const char * description):TaskD(name, description){}
+
+TaskDE::~TaskDE(){
+	if(fSpillFile){
+		std::fclose(fSpillFile);
+	}
+}
+
+void TaskDE::init(const JPetTaskInterface::Options& opts){
+	TaskD::init(opts);
+	TaskOptions::read(opts, "TaskDE_MaxBufferedHits", kMaxBufferedHits);
+	int opposite_tolerance = 0;
+	TaskOptions::read(opts, "TaskDE_OppositeTolerance", opposite_tolerance);
+	fCoincidenceStudy.init(getStatistics(), getParamBank(), fBarrelMap, opposite_tolerance);
+}
+
+void TaskDE::exec(){
+	//getting the data from event in propriate format
+	if(auto hit =dynamic_cast<const JPetHit*const>(getEvent())){
+		HitThresholdTimes times(*hit);
+		fillHistosForHit(*hit, times);
+		fWriter->write(*hit);
+		// the time differences can be checked only when their means are known
+		BufferedHit buffered;
+		buffered.fWindowIndex = hit->getSignalB().getTimeWindowIndex();
+		buffered.fHit = CoincidenceStudy::Hit(*hit, times);
+		fBuffer.push_back(buffered);
+		if(fBuffer.size() >= kMaxBufferedHits){
+			spill();
+		}
+	}
+}
+
+void TaskDE::terminate(){
+	// the means are computed and saved to the auxilliary data by TaskD
+	TaskD::terminate();
+	runCoincidenceStudy();
+	INFO(Form("Coincidences studied in %d hits, %d of them were buffered in a temporary file.",
+		  static_cast<int>(fSpilledHits + fBuffer.size()), static_cast<int>(fSpilledHits)));
+	fBuffer.clear();
+	if(fSpillFile){
+		std::fclose(fSpillFile);
+		fSpillFile = nullptr;
+	}
+}
+
+void TaskDE::spill(){
+	if(!fSpillFile){
+		fSpillFile = std::tmpfile();
+	}
+	if(!fSpillFile || std::fwrite(fBuffer.data(), sizeof(BufferedHit), fBuffer.size(), fSpillFile) != fBuffer.size()){
+		ERROR("Could not write the buffered hits to a temporary file, all of them will be kept in memory");
+		kMaxBufferedHits = std::numeric_limits<std::size_t>::max();
+		return;
+	}
+	fSpilledHits += fBuffer.size();
+	fBuffer.clear();
+}
+
+void TaskDE::runCoincidenceStudy(){
+	fWindowHits.clear();
+	if(fSpillFile){
+		// the hits from the file come first, they were buffered earlier
+		std::rewind(fSpillFile);
+		std::vector<BufferedHit> chunk(std::min<std::size_t>(fSpilledHits, 65536));
+		std::size_t n_read = 0;
+		while((n_read = std::fread(chunk.data(), sizeof(BufferedHit), chunk.size(), fSpillFile)) > 0){
+			for(std::size_t i = 0; i < n_read; i++){
+				studyHit(chunk[i]);
+			}
+		}
+	}
+	for(auto & hit : fBuffer){
+		studyHit(hit);
+	}
+	endWindow();
+}
+
+void TaskDE::studyHit(BufferedHit& hit){
+	if(!fWindowHits.empty() && hit.fWindowIndex != fWindowIndex){
+		endWindow();
+	}
+	fWindowIndex = hit.fWindowIndex;
+	auto & study_hit = hit.fHit;
+	int layer_number = fBarrelMap.getSlotLayerNumber(study_hit.fSlotID);
+	int slot_number = fBarrelMap.getSlotNumberByID(study_hit.fSlotID);
+	for(int thr=1;thr<=CoincidenceStudy::kNumOfThresholds;thr++){
+		if( fTimeDiffMeans.has(layer_number, slot_number, thr)
+		    && CoincidenceStudy::isGoodTimeDiff(study_hit.fTimes, thr, fTimeDiffMeans.get(layer_number, slot_number, thr)) ){
+			study_hit.fGoodTimeDiffs |= 1u << (thr - 1);
+		}
+	}
+	fWindowHits.push_back(study_hit);
+}
+
+void TaskDE::endWindow(){
+	if(!fWindowHits.empty()){
+		fCoincidenceStudy.fillCoincidenceHistos(fWindowHits);
+		fWindowHits.clear();
+	}
+}
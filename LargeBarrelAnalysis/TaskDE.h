@@ -0,0 +1,70 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file TaskDE.h
+ */
+
+#ifndef TASKDE_H
+#define TASKDE_H
+
+#include <cstdio>
+#include <vector>
+#include "CoincidenceStudy.h"
+#include "TaskD.h"
+#ifdef __CINT__
+//when cint is used instead of compiler, override word is not recognized
+//nevertheless it's needed for checking if the structure of project is correct
+#	define override
+#endif
+
+/**
+ * @brief TaskD and TaskE in a single pass over the hits.
+ *
+ * Fills the timeDiffAB histograms and writes the hits as TaskD does, and keeps
+ * a compact record of every hit (slot, scintillator, times at each threshold).
+ * In terminate() the mean timeDiffAB of each slot and threshold is taken from the
+ * histograms and the TaskE coincidence study is run over the records, instead of
+ * reading the whole hit file again.
+ *
+ * When more than TaskDE_MaxBufferedHits records are in memory, they are moved
+ * to a temporary file, which is read back in terminate().
+ * TaskDE_OppositeTolerance has the meaning of TaskE_OppositeTolerance.
+ */
+class TaskDE: public TaskD
+{
+public:
+  TaskDE(const char * name, const char * description);
+  virtual ~TaskDE();
+  virtual void init(const JPetTaskInterface::Options& opts)override;
+  virtual void exec()override;
+  virtual void terminate()override;
+protected:
+  /// trivially copyable, so it can be written to the temporary file as it is
+  struct BufferedHit {
+    long long fWindowIndex = 0;
+    CoincidenceStudy::Hit fHit;
+  };
+  void spill();
+  void runCoincidenceStudy();
+  void studyHit(BufferedHit& hit);
+  void endWindow();
+
+  CoincidenceStudy fCoincidenceStudy;
+  std::vector<BufferedHit> fBuffer;
+  std::size_t kMaxBufferedHits = 1000000;
+  std::FILE* fSpillFile = nullptr;
+  std::size_t fSpilledHits = 0;
+  /// hits of the window being studied
+  std::vector<CoincidenceStudy::Hit> fWindowHits;
+  long long fWindowIndex = 0;
+};
+#endif /*  !TASKDE_H */
@@ -14,34 +14,39 @@
  */
 #ifndef TASKE_H 
 #define TASKE_H 
-#include <JPetTask/JPetTask.h>
 #include <JPetHit/JPetHit.h>
 #include <JPetRawSignal/JPetRawSignal.h>
+#include <WindowBatchTask.h>
+#include "CoincidenceStudy.h"
 #include "LargeBarrelMapping.h"
+#include "SlotThresholdTable.h"
 class JPetWriter;
 #ifdef __CINT__
 //when cint is used instead of compiler, override word is not recognized
 //nevertheless it's needed for checking if the structure of project is correct
 #	define override
 #endif
-class TaskE:public JPetTask {
+class TaskE:public WindowBatchTask<JPetHit> {
 public:
 	TaskE(const char * name, const char * description);
 	virtual ~TaskE();
 	virtual void init(const JPetTaskInterface::Options& opts)override;
-	virtual void exec()override;
 	virtual void terminate()override;
 	virtual void setWriter(JPetWriter* writer)override;
 protected:
+	virtual long long getWindowIndex(const JPetHit& hit) const override;
+	virtual NoWindowResult processWindow(const std::vector<JPetHit>& hits) override;
 	const char * formatUniqueSlotDescription(const JPetBarrelSlot & slot, int threshold,const char * prefix);
-	void fillCoincidenceHistos(const std::vector<JPetHit>& hits);
-	void fillDeltaIDhisto(int delta_ID, int threshold, const JPetLayer & layer);
-	void fillTOFvsDeltaIDhisto(int delta_ID, int threshold, const JPetHit & hit1, const JPetHit & hit2);
-	bool isGoodTimeDiff(const JPetHit & hit, int thr);
-	void fillTOTvsTOThisto(int delta_ID, int thr, const JPetHit & hit1, const JPetHit & hit2);
+	bool isGoodTimeDiff(const JPetHit & hit, const HitThresholdTimes & times, int thr);
+	void loadTimeDiffMeans();
 private:
 	LargeBarrelMapping fBarrelMap;
-	std::vector<JPetHit> fHits;
+	CoincidenceStudy fCoincidenceStudy;
+	// mean timeDiffAB [ns] of each slot and threshold, read from the auxilliary data once
+	SlotThresholdTable fTimeDiffMeans;
+	bool fTimeDiffMeansLoaded = false;
+	// compact records of the hits of the current window
+	std::vector<CoincidenceStudy::Hit> fStudyHits;
 	JPetWriter* fWriter;
 };
 #endif /*  !TASKE_H */
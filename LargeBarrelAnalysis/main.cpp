@@ -13,6 +13,7 @@
  *  @file main.cpp
  */
 
+#include <TROOT.h>
 #include <DBHandler/HeaderFiles/DBHandler.h>
 #include <JPetManager/JPetManager.h>
 #include <JPetTaskLoader/JPetTaskLoader.h>
@@ -20,11 +21,15 @@
 #include "TaskB1.h"
 #include "TaskC.h"
 #include "TaskD.h"
+#include "TaskDE.h"
 #include "TaskE.h"
 
 using namespace std;
 
 int main(int argc, char* argv[]) {
+  // TaskC and TaskE are WindowBatchTasks, which may process the time windows
+  // in threads, so ROOT must be made thread-safe before any ROOT object exists
+  ROOT::EnableThreadSafety();
 	DB::SERVICES::DBHandler::createDBConnection("../DBConfig/configDB.cfg");
   JPetManager& manager = JPetManager::getManager();
   manager.parseCmdLine(argc, argv);
@@ -62,5 +67,12 @@ int main(int argc, char* argv[]) {
   // 					  "Pass only hits with time diffrerence close to the peak"));
   //   });
 
+  // instead of the modules D and E, both can be run in a single pass over the hits:
+  // manager.registerTask([](){
+  //     return new JPetTaskLoader("phys.hit", "phys.hit.means",
+  // 				new TaskDE("Module DE: Make histograms for hits and study coincidences",
+  // 					   "Produce mean timeDiff values and study the coincidences of hits close to the peak in one pass"));
+  //   });
+
   manager.run();
 }
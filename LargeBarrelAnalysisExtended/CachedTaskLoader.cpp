@@ -0,0 +1,152 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file CachedTaskLoader.cpp
+ */
+
+#include <boost/filesystem.hpp>
+#include "CachedTaskLoader.h"
+#include "StageCache.h"
+
+CachedTaskLoader::CachedTaskLoader(const char* inFileType,
+                                   const char* outFileType,
+                                   JPetTask* taskToExecute,
+                                   const std::string& taskName,
+                                   int taskVersion,
+                                   const std::vector<std::string>& dependencies,
+                                   const std::vector<std::string>& sideOutputOptions):
+  JPetTaskLoader(inFileType, outFileType, taskToExecute),
+  fStageInFileType(inFileType),
+  fStageOutFileType(outFileType),
+  fTaskName(taskName),
+  fTaskVersion(taskVersion),
+  fDependencies(dependencies),
+  fSideOutputOptions(sideOutputOptions)
+{
+  /**/
+}
+
+void CachedTaskLoader::init(const JPetOptions::Options& opts)
+{
+  if (opts.count(fCacheEnabledParamKey)) {
+    fCacheEnabled = (opts.at(fCacheEnabledParamKey) == "true");
+  }
+  auto cacheDir = std::string("stageCache");
+  if (opts.count(fCacheDirParamKey)) {
+    cacheDir = opts.at(fCacheDirParamKey);
+  }
+  /// the outputs of a parameter sweep (see ParameterSweepTask) are not stored in the cache,
+  /// so the stage must be executed to produce them
+  if (opts.count(fTaskName + "_Sweep")) {
+    fCacheEnabled = false;
+  }
+  fOutputFileName = getStageFileName(opts, fStageOutFileType);
+  auto taskOptions = StageCache::selectTaskOptions(opts, fTaskName);
+  fSideOutputs.clear();
+  for (const auto& option : fSideOutputOptions) {
+    if (opts.count(option)) {
+      /// the previous content of a side output must not change the key
+      taskOptions.erase(option);
+      fSideOutputs.push_back(std::make_pair(opts.at(option), std::string()));
+    }
+  }
+  boost::system::error_code error;
+  if (fCacheEnabled) {
+    auto inputFileName = getStageFileName(opts, fStageInFileType);
+    /// the key of the previous stage identifies its output, so only the first stage reads its input to hash it
+    std::string inputKey;
+    std::uint64_t inputHash = 0;
+    bool hasInputHash = StageCache::readStageKey(inputFileName, inputKey);
+    if (hasInputHash) {
+      inputHash = StageCache::hashString(inputKey);
+    } else {
+      hasInputHash = StageCache::hashFile(inputFileName, inputHash);
+    }
+    if (hasInputHash) {
+      fKey = StageCache::generateKey(inputHash,
+                                         fTaskName,
+                                         fTaskVersion,
+                                         fStageOutFileType,
+                                         taskOptions,
+                                         fDependencies);
+      fCachedFileName = StageCache::getCachedFileName(cacheDir, fKey, fStageOutFileType);
+      bool cached = boost::filesystem::is_regular_file(fCachedFileName);
+      for (std::size_t i = 0; i < fSideOutputs.size(); i++) {
+        fSideOutputs[i].second = (boost::filesystem::path(cacheDir) / (fKey + "." + std::to_string(i) + ".side")).string();
+        cached = cached && boost::filesystem::is_regular_file(fSideOutputs[i].second);
+      }
+      if (cached && StageCache::placeFile(fCachedFileName, fOutputFileName)) {
+        for (const auto& sideOutput : fSideOutputs) {
+          StageCache::placeFile(sideOutput.second, sideOutput.first);
+        }
+        StageCache::writeStageKey(fOutputFileName, fKey);
+        INFO("Stage cache: " + fTaskName + " skipped, output taken from " + fCachedFileName);
+        fCacheHit = true;
+        return;
+      }
+      boost::filesystem::create_directories(cacheDir, error);
+    } else {
+      WARNING("Stage cache: cannot read input file " + inputFileName + ", the cache is not used for " + fTaskName);
+      fCacheEnabled = false;
+    }
+  }
+  /// the output of the previous run may still be linked with the cache,
+  /// so it must not be overwritten in place
+  boost::filesystem::remove(fOutputFileName, error);
+  StageCache::removeStageKey(fOutputFileName);
+  for (const auto& sideOutput : fSideOutputs) {
+    boost::filesystem::remove(sideOutput.first, error);
+  }
+  JPetTaskLoader::init(opts);
+}
+
+void CachedTaskLoader::exec()
+{
+  if (fCacheHit) {
+    return;
+  }
+  JPetTaskLoader::exec();
+}
+
+void CachedTaskLoader::terminate()
+{
+  if (fCacheHit) {
+    return;
+  }
+  JPetTaskLoader::terminate();
+  if (!fCacheEnabled) {
+    return;
+  }
+  StageCache::writeStageKey(fOutputFileName, fKey);
+  /// the side outputs are stored first, the output marks a complete entry of the cache
+  for (const auto& sideOutput : fSideOutputs) {
+    if (!StageCache::placeFile(sideOutput.first, sideOutput.second)) {
+      return;
+    }
+  }
+  if (StageCache::placeFile(fOutputFileName, fCachedFileName)) {
+    INFO("Stage cache: output of " + fTaskName + " stored as " + fCachedFileName);
+  }
+}
+
+/// The same naming scheme as used by JPetTaskLoader:
+/// everything after the first dot of the file name is replaced by the file type.
+std::string CachedTaskLoader::getStageFileName(const JPetOptions::Options& opts, const std::string& fileType) const
+{
+  auto inputFile = boost::filesystem::path(opts.at("inputFile"));
+  auto baseName = inputFile.filename().string();
+  auto pos = baseName.find(".");
+  if (pos != std::string::npos) {
+    baseName.erase(pos);
+  }
+  return (inputFile.parent_path() / (baseName + "." + fileType + ".root")).string();
+}
@@ -0,0 +1,92 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file CachedTaskLoader.h
+ */
+
+#ifndef CACHEDTASKLOADER_H
+#define CACHEDTASKLOADER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <JPetTaskLoader/JPetTaskLoader.h>
+
+#ifdef __CINT__
+//when cint is used instead of compiler, override word is not recognized
+//nevertheless it's needed for checking if the structure of project is correct
+#	define override
+#endif
+
+/**
+ * @brief JPetTaskLoader which reuses the output of a previous run of the same stage.
+ *
+ * The output file is keyed on the content of the input file (or the key of the stage
+ * producing it), the task name and version, the task options (all options prefixed
+ * with "<taskName>_") and the additional files the task reads (see StageCache). If a file with a matching key is found in the cache
+ * directory, it is placed as the output of the stage and the task is not executed at all.
+ * Otherwise the task runs as usual and its output is stored in the cache afterwards.
+ *
+ * Changing e.g. EventFinder_EventTime reruns only EventFinder and the stages after it,
+ * since their inputs change as well.
+ *
+ * User options:
+ * "StageCache_Enabled": "true" or "false" (default "true")
+ * "StageCache_Dir": directory with the cached outputs (default "stageCache")
+ *
+ * The cache is not used for a stage with a parameter sweep defined ("<taskName>_Sweep").
+ *
+ * sideOutputOptions are the options naming the additional files written by the task
+ * (e.g. "TimeWindowCreator_PackedFile"). Their content is not part of the key; the files
+ * are stored in the cache and placed back together with the output.
+ *
+ * The version is the kVersion constant of the task class, which must be increased
+ * whenever the code of the task changes in a way that changes its output.
+ *
+ * The key of a stage is stored next to its output (see StageCache::writeStageKey()),
+ * so the next stage builds its key from it; only the first stage hashes the content
+ * of its input file.
+ */
+class CachedTaskLoader: public JPetTaskLoader
+{
+public:
+  CachedTaskLoader(const char* inFileType,
+                   const char* outFileType,
+                   JPetTask* taskToExecute,
+                   const std::string& taskName,
+                   int taskVersion,
+                   const std::vector<std::string>& dependencies = std::vector<std::string>(),
+                   const std::vector<std::string>& sideOutputOptions = std::vector<std::string>());
+  virtual void init(const JPetOptions::Options& opts) override;
+  virtual void exec() override;
+  virtual void terminate() override;
+
+protected:
+  std::string getStageFileName(const JPetOptions::Options& opts, const std::string& fileType) const;
+
+  const std::string fCacheEnabledParamKey = "StageCache_Enabled";
+  const std::string fCacheDirParamKey = "StageCache_Dir";
+  std::string fStageInFileType;
+  std::string fStageOutFileType;
+  std::string fTaskName;
+  int fTaskVersion = 0;
+  std::vector<std::string> fDependencies;
+  std::vector<std::string> fSideOutputOptions;
+  /// names of the side outputs of the stage and of their copies in the cache
+  std::vector<std::pair<std::string, std::string>> fSideOutputs;
+  bool fCacheEnabled = true;
+  bool fCacheHit = false;
+  std::string fKey;
+  std::string fCachedFileName;
+  std::string fOutputFileName;
+};
+#endif /*  !CACHEDTASKLOADER_H */
@@ -30,6 +30,9 @@ class JPetWriter;
 
 class EventCategorizer : public JPetTask{
 public:
+	/// version of the output for the stage cache (see CachedTaskLoader),
+	/// to be increased whenever a change of the task changes its output
+	static const int kVersion = 1;
 	EventCategorizer(const char * name, const char * description);
 	virtual ~EventCategorizer(){}
 	virtual void init(const JPetTaskInterface::Options& opts)override;
@@ -38,7 +41,7 @@ public:
 	virtual void setWriter(JPetWriter* writer)override;
 protected:
 	JPetWriter* fWriter;
-	void saveEvents(const std::vector<JPetEvent>& event);
+	virtual void saveEvents(const std::vector<JPetEvent>& event);
 	bool fSaveControlHistos = true;
 };
 #endif /*  !EVENTCATEGORIZER_H */
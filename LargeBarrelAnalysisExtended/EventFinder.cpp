@@ -19,9 +19,10 @@
 
 using namespace std;
 
-EventFinder::EventFinder(const char * name, const char * description):JPetTask(name, description){}
+EventFinder::EventFinder(const char * name, const char * description):WindowBatchTask(name, description){}
 
 void EventFinder::init(const JPetTaskInterface::Options& opts){
+	WindowBatchTask::init(opts);
 
 	INFO("Event finding started.");
 
@@ -34,29 +35,27 @@ void EventFinder::init(const JPetTaskInterface::Options& opts){
 		);
 }
 
-void EventFinder::exec(){
-
-	if(auto hit = dynamic_cast<const JPetHit*const>(getEvent())){
-		if(hit->isSignalASet() && hit->isSignalBSet()){
-			if(hit->getSignalA().getTimeWindowIndex() == hit->getSignalB().getTimeWindowIndex()){
-				if(kFirstTime){
-					kTimeSlotIndex = hit->getSignalA().getTimeWindowIndex();
-					fHitVector.push_back(*hit);
-					kFirstTime = false;
-				}else{
-					if(kTimeSlotIndex == hit->getSignalA().getTimeWindowIndex()){
-						fHitVector.push_back(*hit);
-					}else{
-						vector<JPetEvent> events = buildEvents(fHitVector);
-						saveEvents(events);
-						fHitVector.clear();
-						kTimeSlotIndex = hit->getSignalA().getTimeWindowIndex();
-						fHitVector.push_back(*hit);
-					}
-				}
-			}
+bool EventFinder::accept(const JPetHit& hit){
+	return hit.isSignalASet() && hit.isSignalBSet()
+		&& hit.getSignalA().getTimeWindowIndex() == hit.getSignalB().getTimeWindowIndex();
+}
+
+long long EventFinder::getWindowIndex(const JPetHit& hit) const{
+	return hit.getSignalA().getTimeWindowIndex();
+}
+
+vector<JPetEvent> EventFinder::processWindow(const vector<JPetHit>& hits){
+	return buildEvents(hits);
+}
+
+void EventFinder::commitWindow(vector<JPetEvent>& events){
+	//histograms are filled here, as processWindow may run in another thread
+	if (fSaveControlHistos) {
+		for (const auto & event : events) {
+			getStatistics().getHisto1D("hits_per_event").Fill(event.getHits().size());
 		}
 	}
+	saveEvents(events);
 }
 
 //sorting method
@@ -66,10 +65,11 @@ bool sortByTimeValue(JPetHit hit1, JPetHit hit2) {
 
 
 void EventFinder::terminate(){
+	WindowBatchTask::terminate();
 	INFO("Event fiding ended.");
 }
 
-vector<JPetEvent> EventFinder::buildEvents(vector<JPetHit> hitVec){
+vector<JPetEvent> EventFinder::buildEvents(vector<JPetHit> hitVec) const{
 
 	vector<JPetEvent> eventVec;
 	sort(hitVec.begin(), hitVec.end(), sortByTimeValue);
@@ -92,10 +92,6 @@ vector<JPetEvent> EventFinder::buildEvents(vector<JPetHit> hitVec){
 
 		hitVec.erase(hitVec.begin() + 0);
 
-		if (fSaveControlHistos) getStatistics()
-														.getHisto1D("hits_per_event")
-														.Fill(event.getHits().size());
-
 		eventVec.push_back(event);
 	}
 
@@ -18,9 +18,9 @@
 
 #include <vector>
 #include <map>
-#include <JPetTask/JPetTask.h>
 #include <JPetHit/JPetHit.h>
 #include <JPetEvent/JPetEvent.h>
+#include <WindowBatchTask.h>
 
 class JPetWriter;
 
@@ -28,23 +28,31 @@ class JPetWriter;
 #	define override
 #endif
 
-class EventFinder : public JPetTask{
+/**
+ * Groups the hits of every time window into events of hits within kEventTimeWindow.
+ * The time windows can be processed in parallel with the "EventFinder_Threads" option.
+ */
+class EventFinder : public WindowBatchTask<JPetHit, std::vector<JPetEvent>>{
 public:
+	/// version of the output for the stage cache (see CachedTaskLoader),
+	/// to be increased whenever a change of the task changes its output
+	static const int kVersion = 1;
 	EventFinder(const char * name, const char * description);
 	virtual ~EventFinder(){}
 	virtual void init(const JPetTaskInterface::Options& opts)override;
-	virtual void exec()override;
 	virtual void terminate()override;
 	virtual void setWriter(JPetWriter* writer)override;
 protected:
-  	int kTimeSlotIndex;
-  	bool kFirstTime = true;
   	double kEventTimeWindow = 5000.0; //ps
 	const std::string fEventTimeParamKey = "EventFinder_EventTime";
-    	std::vector<JPetHit> fHitVector;
   	bool fSaveControlHistos = true;
 	JPetWriter* fWriter;
-	void saveEvents(const std::vector<JPetEvent>& event);
-	std::vector<JPetEvent> buildEvents(std::vector<JPetHit> hitVec);
+	virtual bool accept(const JPetHit& hit)override;
+	virtual long long getWindowIndex(const JPetHit& hit) const override;
+	virtual std::vector<JPetEvent> processWindow(const std::vector<JPetHit>& hits)override;
+	virtual void commitWindow(std::vector<JPetEvent>& events)override;
+	virtual bool isParallelSafe() const override { return true; }
+	virtual void saveEvents(const std::vector<JPetEvent>& event);
+	std::vector<JPetEvent> buildEvents(std::vector<JPetHit> hitVec) const;
 };
 #endif /*  !EVENTFINDER_H */
@@ -21,12 +21,52 @@
 
 using namespace std;
 
-HitFinder::HitFinder(const char* name, const char* description): JPetTask(name, description) {}
+namespace
+{
+template<class Time>
+Time toJoinTime(double timePs);
+
+template<>
+double toJoinTime<double>(double timePs)
+{
+	return timePs;
+}
+
+template<>
+IntegerTime::TimePs toJoinTime<IntegerTime::TimePs>(double timePs)
+{
+	return IntegerTime::fromPs(timePs);
+}
+
+template<class Time>
+class TimedSignalJoin: public HitFinderSignalJoin
+{
+public:
+	TimedSignalJoin(double widthPs, std::size_t maxBufferedSignals,
+			StreamingWindowJoin<JPetPhysSignal>::MatchCallback onMatch):
+		fJoin(toJoinTime<Time>(widthPs), maxBufferedSignals, onMatch) {}
+	virtual void add(int scinID, bool sideA, const JPetPhysSignal& signal) override
+	{
+		fJoin.add(signal.getTimeWindowIndex(), scinID, sideA, toJoinTime<Time>(signal.getTime()), signal);
+	}
+	virtual void flush() override
+	{
+		fJoin.flush();
+	}
+
+private:
+	StreamingWindowJoin<JPetPhysSignal, int, Time> fJoin;
+};
+}
+
+HitFinder::HitFinder(const char* name, const char* description):
+	WindowBatchTask(name, description) {}
 
 HitFinder::~HitFinder() {}
 
 void HitFinder::init(const JPetTaskInterface::Options& opts)
 {
+	WindowBatchTask::init(opts);
 	INFO("Reading velocities.");
 	fVelocityMap = readVelocityFile();
 
@@ -56,42 +96,57 @@ void HitFinder::init(const JPetTaskInterface::Options& opts)
 	if (opts.count(fTimeWindowWidthParamKey )) {
 		kTimeWindowWidth = atof(opts.at(fTimeWindowWidthParamKey).c_str());
 	}
+	TaskOptions::read(opts, fMaxBufferedSignalsParamKey, kMaxBufferedSignals);
+	setMaxWindowObjects(kMaxBufferedSignals);
+	if (opts.count(fIntegerTimesParamKey)) {
+		fIntegerTimes = (opts.at(fIntegerTimesParamKey) == "true");
+	}
+	HitTools.setIntegerTimes(fIntegerTimes);
+
+	fBarrelMap.loadOrBuildMappings(getParamBank(), getAuxilliaryData());
+	HitTools.setBarrelMapping(&fBarrelMap);
+
+	auto onMatch = [this](const JPetPhysSignal& signalA, const JPetPhysSignal& signalB) {
+		fHits.push_back(HitTools.createHit(getStatistics(), signalA, signalB, fVelocityMap));
+	};
+	if (fIntegerTimes) {
+		fSignalJoin.reset(new TimedSignalJoin<IntegerTime::TimePs>(kTimeWindowWidth, kMaxBufferedSignals, onMatch));
+	} else {
+		fSignalJoin.reset(new TimedSignalJoin<double>(kTimeWindowWidth, kMaxBufferedSignals, onMatch));
+	}
 
 		INFO("Hit finding started.");
 }
 
-void HitFinder::exec()
+vector<JPetHit> HitFinder::processWindow(const vector<JPetPhysSignal>& signals)
 {
-
-	//getting the data from event in apropriate format
-	if (auto currSignal = dynamic_cast<const JPetPhysSignal* const>(getEvent())) {
-		if (kFirstTime) {
-			kTimeSlotIndex = currSignal->getTimeWindowIndex();
-			fillSignalsMap(*currSignal);
-			kFirstTime = false;
+	for (const auto& signal : signals) {
+		int pmID = signal.getPM().getID();
+		if (fBarrelMap.hasPM(pmID)) {
+			fSignalJoin->add(fBarrelMap.getPMScinID(pmID), fBarrelMap.getPMSide(pmID) == JPetPM::SideA, signal);
 		} else {
-			if (kTimeSlotIndex == currSignal->getTimeWindowIndex()) {
-				fillSignalsMap(*currSignal);
-			} else {
-        vector<JPetHit> hits = HitTools.createHits(
-          getStatistics(),
-          fAllSignalsInTimeWindow,
-          kTimeWindowWidth,
-          fVelocityMap);
-        saveHits(hits);
-        getStatistics().getHisto1D("hits_per_time_window").Fill(hits.size());
-        fAllSignalsInTimeWindow.clear();
-        kTimeSlotIndex = currSignal->getTimeWindowIndex();
-        fillSignalsMap(*currSignal);
-			}
+			fSignalJoin->add(signal.getPM().getScin().getID(), signal.getPM().getSide() == JPetPM::SideA, signal);
 		}
 	}
+	fSignalJoin->flush();
+	vector<JPetHit> hits;
+	hits.swap(fHits);
+	return hits;
 }
 
-
+void HitFinder::commitWindow(vector<JPetHit>& hits)
+{
+	saveHits(hits);
+	getStatistics().getHisto1D("hits_per_time_window").Fill(hits.size());
+}
 
 void HitFinder::terminate()
 {
+	WindowBatchTask::terminate();
+	if (getSplitCount() > 0) {
+		WARNING("Time windows larger than " + std::to_string(kMaxBufferedSignals)
+			+ " signals were split " + std::to_string(getSplitCount()) + " times.");
+	}
 	INFO("Hit finding ended.");
 }
 
@@ -111,30 +166,6 @@ void HitFinder::setWriter(JPetWriter* writer)
 	fWriter = writer;
 }
 
-void HitFinder::fillSignalsMap(JPetPhysSignal signal)
-{
-	auto scinId = signal.getPM().getScin().getID();
-	if (signal.getPM().getSide() == JPetPM::SideA) {
-		if (fAllSignalsInTimeWindow.find(scinId) != fAllSignalsInTimeWindow.end()) {
-			fAllSignalsInTimeWindow.at(scinId).first.push_back(signal);
-		} else {
-			std::vector<JPetPhysSignal> sideA = {signal};
-			std::vector<JPetPhysSignal> sideB;
-			fAllSignalsInTimeWindow.insert(std::make_pair(scinId,
-						std::make_pair(sideA, sideB)));
-		}
-	} else {
-		if (fAllSignalsInTimeWindow.find(scinId) != fAllSignalsInTimeWindow.end()) {
-			fAllSignalsInTimeWindow.at(scinId).second.push_back(signal);
-		} else {
-			std::vector<JPetPhysSignal> sideA;
-			std::vector<JPetPhysSignal> sideB = {signal};
-			fAllSignalsInTimeWindow.insert(std::make_pair(scinId,
-						std::make_pair(sideA, sideB)));
-		}
-	}
-}
-
 map<int, vector<double>> HitFinder::readVelocityFile(){
 
 	map<int, vector<double>> velocitiesMap;
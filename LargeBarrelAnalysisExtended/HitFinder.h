@@ -17,10 +17,13 @@
 #define HitFinder_H
 
 #include <map>
+#include <memory>
 #include <vector>
-#include <JPetTask/JPetTask.h>
 #include <JPetHit/JPetHit.h>
-#include <JPetRawSignal/JPetRawSignal.h>
+#include <JPetPhysSignal/JPetPhysSignal.h>
+#include <IntegerTime.h>
+#include <StreamingWindowJoin.h>
+#include <WindowBatchTask.h>
 #include "HitFinderTools.h"
 
 class JPetWriter;
@@ -31,42 +34,69 @@ class JPetWriter;
 #   define override
 #endif
 
+/// StreamingWindowJoin of the signals keyed on scintillator ID, with the times as double
+/// or, with the option "HitFinder_IntegerTimes", as integer ps (see HitFinder.cpp)
+class HitFinderSignalJoin
+{
+public:
+	virtual ~HitFinderSignalJoin() {}
+	virtual void add(int scinID, bool sideA, const JPetPhysSignal& signal) = 0;
+	virtual void flush() = 0;
+};
+
 /**
  * @brief      Module responsible for creating JPetHit from signals on oppositte photomultipliers
  *
  * This module takes all physical signals (JPetPhysSignal) within a single time window (JPetTimeWindow)
- * and creates special type of container - SignalsContainer.
- * For each scintillator with at least one signal this container stores two vectors
- * one for physical signals on photomultiplier on side A and second for signals on side B. Then
+ * and passes them to a StreamingWindowJoin keyed on the scintillator ID, with the signals
+ * on the side A on the left and on the side B on the right. Then
  * for each signal on side A it searches for corresponding signal on side B - that is time difference of arrival
- * of those two signals needs to be less then specified time difference (kTimeWindowWidth)
+ * of those two signals needs to be less then specified time difference (kTimeWindowWidth).
+ * The signals of both sides are sorted by time, so matching is linear in the number of signals.
+ *
+ * At most kMaxBufferedSignals signals (option "HitFinder_MaxBufferedSignals") are kept,
+ * by WindowBatchTask and by the join, so the memory stays bounded also for very large time windows.
+ *
+ * The scintillator and side of a signal and the slot of a hit are read from a LargeBarrelMapping
+ * (see CommonTools) by the ID of the PM.
  *
+ * With "HitFinder_IntegerTimes": "true" the signal times are rounded to integer ps
+ * (see IntegerTime.h in CommonTools) for the matching and for the hit times and
+ * time differences, so the hits do not depend on the order of the floating point operations.
  */
-class HitFinder: public JPetTask
+class HitFinder: public WindowBatchTask<JPetPhysSignal, std::vector<JPetHit>>
 {
 
 public:
+	/// version of the output for the stage cache (see CachedTaskLoader),
+	/// to be increased whenever a change of the task changes its output
+	static const int kVersion = 1;
 	HitFinder(const char* name, const char* description);
 	virtual ~HitFinder();
 	virtual void init(const JPetTaskInterface::Options& opts)override;
-	virtual void exec()override;
 	virtual void terminate()override;
 	virtual void setWriter(JPetWriter* writer)override;
 	std::map<int, std::vector<double>> fVelocityMap;
 
 protected:
 
-  	//Index that defines a given DAQ time window (defined at the hardware level)
-	int kTimeSlotIndex;
-	bool kFirstTime = true;
-	HitFinderTools::SignalsContainer fAllSignalsInTimeWindow;
+	//Signals of a DAQ time window (defined at the hardware level), keyed on scintillator ID
+	std::unique_ptr<HitFinderSignalJoin> fSignalJoin;
+	std::vector<JPetHit> fHits;
 	HitFinderTools HitTools;
+	/// scintillator, side and slot of the PMs by their IDs
+	LargeBarrelMapping fBarrelMap;
   	std::map<int, std::vector<double>> readVelocityFile();
-	void fillSignalsMap(JPetPhysSignal signal);
-	void saveHits(const std::vector<JPetHit>& hits);
+	virtual std::vector<JPetHit> processWindow(const std::vector<JPetPhysSignal>& signals) override;
+	virtual void commitWindow(std::vector<JPetHit>& hits) override;
+	virtual void saveHits(const std::vector<JPetHit>& hits);
 	JPetWriter* fWriter;
 	const std::string fTimeWindowWidthParamKey = "HitFinder_TimeWindowWidth";
+	const std::string fMaxBufferedSignalsParamKey = "HitFinder_MaxBufferedSignals";
+	const std::string fIntegerTimesParamKey = "HitFinder_IntegerTimes";
 	double kTimeWindowWidth = 50000; /// in ps -> 50ns. Maximal time difference between signals
+	std::size_t kMaxBufferedSignals = 100000;
+	bool fIntegerTimes = false;
 
 };
 
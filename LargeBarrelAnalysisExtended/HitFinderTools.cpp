@@ -55,42 +55,7 @@ vector<JPetHit> HitFinderTools::createHits(JPetStatistics& stats,
 					if (fabs(signalA.getTime() - signalB.getTime())
 								< timeDifferenceWindow) {
 
-						//Creating hit for successfully matched pair of Phys singlas
-						//Setting meaningless parameters of Energy, Position, quality
-						JPetHit hit;
-						hit.setSignalA(signalA);
-						hit.setSignalB(signalB);
-						hit.setTime((signalA.getTime()+signalB.getTime())/2.0);
-						hit.setQualityOfTime(-1.0);
-						hit.setTimeDiff(signalA.getTime()-signalB.getTime());
-						hit.setQualityOfTimeDiff(-1.0);
-						hit.setEnergy(-1.0);
-						hit.setQualityOfEnergy(-1.0);
-            hit.setScintillator(signalA.getPM().getScin());
-						hit.setBarrelSlot(signalA.getPM().getBarrelSlot());
-						hit.setPosX(hit.getBarrelSlot().getLayer().getRadius()
-												*cos(hit.getBarrelSlot().getTheta()));
-						hit.setPosY(hit.getBarrelSlot().getLayer().getRadius()
-												*sin(hit.getBarrelSlot().getTheta()));
-
-						auto search = velMap.find(hit.getBarrelSlot().getID());
-						if(search != velMap.end()){
-							double vel = search->second.at(0);
-							double position = vel*hit.getTimeDiff()/2000;
-							hit.setPosZ(position);
-						}else{
-							hit.setPosZ(-1000000.0);
-						}
-
-						hits.push_back(hit);
-
-            stats.getHisto2D("time_diff_per_scin")
-              .Fill(hit.getTimeDiff(),
-                (float) (hit.getScintillator().getID()));
-
-						stats.getHisto2D("hit_pos_per_scin")
-							.Fill(hit.getPosZ(),
-                (float) (hit.getScintillator().getID()));
+						hits.push_back(createHit(stats, signalA, signalB, velMap));
 					}
 				}
 			}
@@ -98,3 +63,59 @@ vector<JPetHit> HitFinderTools::createHits(JPetStatistics& stats,
 	}
 	return hits;
 }
+
+JPetHit HitFinderTools::createHit(JPetStatistics& stats,
+  const JPetPhysSignal& signalA,
+  const JPetPhysSignal& signalB,
+  const std::map<int, std::vector<double>>& velMap)
+{
+	//Creating hit for successfully matched pair of Phys singlas
+	//Setting meaningless parameters of Energy, Position, quality
+	JPetHit hit;
+	hit.setSignalA(signalA);
+	hit.setSignalB(signalB);
+	if (fIntegerTimes) {
+		IntegerTime::TimePs timeA = IntegerTime::fromPs(signalA.getTime());
+		IntegerTime::TimePs timeB = IntegerTime::fromPs(signalB.getTime());
+		hit.setTime(IntegerTime::toPs(timeA + timeB) / 2.0);
+		hit.setTimeDiff(IntegerTime::toPs(timeA - timeB));
+	} else {
+		hit.setTime((signalA.getTime()+signalB.getTime())/2.0);
+		hit.setTimeDiff(signalA.getTime()-signalB.getTime());
+	}
+	hit.setQualityOfTime(-1.0);
+	hit.setQualityOfTimeDiff(-1.0);
+	hit.setEnergy(-1.0);
+	hit.setQualityOfEnergy(-1.0);
+	hit.setScintillator(signalA.getPM().getScin());
+	hit.setBarrelSlot(signalA.getPM().getBarrelSlot());
+	const int slotID = hit.getBarrelSlot().getID();
+	if (fBarrelMap) {
+		hit.setPosX(fBarrelMap->getSlotX(slotID));
+		hit.setPosY(fBarrelMap->getSlotY(slotID));
+	} else {
+		hit.setPosX(hit.getBarrelSlot().getLayer().getRadius()
+								*cos(hit.getBarrelSlot().getTheta()));
+		hit.setPosY(hit.getBarrelSlot().getLayer().getRadius()
+								*sin(hit.getBarrelSlot().getTheta()));
+	}
+
+	auto search = velMap.find(slotID);
+	if(search != velMap.end()){
+		double vel = search->second.at(0);
+		double position = vel*hit.getTimeDiff()/2000;
+		hit.setPosZ(position);
+	}else{
+		hit.setPosZ(-1000000.0);
+	}
+
+	stats.getHisto2D("time_diff_per_scin")
+		.Fill(hit.getTimeDiff(),
+			(float) (hit.getScintillator().getID()));
+
+	stats.getHisto2D("hit_pos_per_scin")
+		.Fill(hit.getPosZ(),
+			(float) (hit.getScintillator().getID()));
+
+	return hit;
+}
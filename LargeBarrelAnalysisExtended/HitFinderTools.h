@@ -18,6 +18,8 @@
 
 #include <JPetHit/JPetHit.h>
 #include <JPetStatistics/JPetStatistics.h>
+#include <IntegerTime.h>
+#include <LargeBarrelMapping.h>
 
 #include <vector>
 
@@ -42,6 +44,34 @@ public:
 		const double timeDifferenceWindow,
 		const std::map<int, std::vector<double>> velMap);
 
+	/**
+	 * Creates the hit from a matched pair of signals on the sides A and B
+	 * of one scintillator and fills the time difference and position histograms.
+	 */
+	JPetHit createHit(
+		JPetStatistics& stats,
+		const JPetPhysSignal& signalA,
+		const JPetPhysSignal& signalB,
+		const std::map<int, std::vector<double>>& velMap);
+
+	/**
+	 * With a mapping the position of the hit in the XY plane is taken from its per-slot tables
+	 * instead of the layer and the angle of the slot. The mapping must outlive this object.
+	 */
+	void setBarrelMapping(const LargeBarrelMapping* barrelMap)
+	{
+		fBarrelMap = barrelMap;
+	}
+
+	/// The hit time and time difference are computed from the signal times rounded to integer ps
+	void setIntegerTimes(bool integerTimes)
+	{
+		fIntegerTimes = integerTimes;
+	}
+
+private:
+	const LargeBarrelMapping* fBarrelMap = nullptr;
+	bool fIntegerTimes = false;
 };
 
 #endif /*  !HITFINDERTOOLS_H */
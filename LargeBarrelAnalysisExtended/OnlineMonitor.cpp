@@ -0,0 +1,338 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file OnlineMonitor.cpp
+ */
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <csignal>
+#include <cstdio>
+#include <thread>
+#include <TFile.h>
+#include <TTree.h>
+#include <Unpacker2/Unpacker2/EventIII.h>
+#include <JPetAnalysisTools/JPetAnalysisTools.h>
+#include <JPetParamManager/JPetParamManager.h>
+#include "OnlineMonitor.h"
+#include "TimeWindowCreator.h"
+#include "TimeCalibLoader.h"
+#include "SignalFinder.h"
+#include "SignalTransformer.h"
+#include "HitFinder.h"
+#include "EventFinder.h"
+#include "EventCategorizer.h"
+
+using namespace std;
+
+namespace
+{
+volatile std::sig_atomic_t gStopRequested = 0;
+
+void requestStop(int)
+{
+  gStopRequested = 1;
+}
+
+/// Passes the output object of a task directly to the exec() of the next one
+void forward(JPetTask* next, const TObject& object)
+{
+  next->setEvent(const_cast<TObject*>(&object));
+  next->exec();
+}
+
+/// The tasks of the chain with their save methods redirected to the next task
+/// instead of the writer
+
+class OnlineTimeWindowCreator: public TimeWindowCreator
+{
+public:
+  explicit OnlineTimeWindowCreator(JPetTask* next):
+    TimeWindowCreator("TimeWindowCreator", "Online unpacked data to JPetTimeWindow"), fNext(next) {}
+protected:
+  virtual void saveTimeWindow(const JPetTimeWindow& window) override
+  {
+    forward(fNext, window);
+  }
+  JPetTask* fNext;
+};
+
+class OnlineTimeCalibLoader: public TimeCalibLoader
+{
+public:
+  explicit OnlineTimeCalibLoader(JPetTask* next):
+    TimeCalibLoader("TimeCalibLoader", "Online time calibration"), fNext(next) {}
+protected:
+  virtual void saveTimeWindow(const JPetTimeWindow& window) override
+  {
+    forward(fNext, window);
+  }
+  JPetTask* fNext;
+};
+
+class OnlineSignalFinder: public SignalFinder
+{
+public:
+  explicit OnlineSignalFinder(JPetTask* next):
+    SignalFinder("SignalFinder", "Online raw signal creation", true), fNext(next) {}
+protected:
+  virtual void saveRawSignals(const vector<JPetRawSignal>& signals) override
+  {
+    for (const auto& signal : signals) {
+      forward(fNext, signal);
+    }
+  }
+  JPetTask* fNext;
+};
+
+class OnlineSignalTransformer: public SignalTransformer
+{
+public:
+  explicit OnlineSignalTransformer(JPetTask* next):
+    SignalTransformer("SignalTransformer", "Online reco & phys signal creation"), fNext(next) {}
+protected:
+  virtual void savePhysSignal(JPetPhysSignal signal) override
+  {
+    forward(fNext, signal);
+  }
+  JPetTask* fNext;
+};
+
+class OnlineHitFinder: public HitFinder
+{
+public:
+  explicit OnlineHitFinder(JPetTask* next):
+    HitFinder("HitFinder", "Online hit creation"), fNext(next) {}
+protected:
+  virtual void saveHits(const vector<JPetHit>& hits) override
+  {
+    for (const auto& hit : JPetAnalysisTools::getHitsOrderedByTime(hits)) {
+      forward(fNext, hit);
+    }
+  }
+  JPetTask* fNext;
+};
+
+class OnlineEventFinder: public EventFinder
+{
+public:
+  OnlineEventFinder(JPetTask* next, OnlineMonitor* monitor):
+    EventFinder("EventFinder", "Online event creation"), fNext(next), fMonitor(monitor) {}
+protected:
+  virtual void saveEvents(const vector<JPetEvent>& events) override
+  {
+    for (const auto& event : events) {
+      forward(fNext, event);
+    }
+    /// saveEvents is called once per time window
+    if (!events.empty() && !events.front().getHits().empty()) {
+      fMonitor->windowProcessed(events.front().getHits().front().getSignalA().getTimeWindowIndex());
+    }
+  }
+  JPetTask* fNext;
+  OnlineMonitor* fMonitor;
+};
+
+class OnlineEventCategorizer: public EventCategorizer
+{
+public:
+  OnlineEventCategorizer(): EventCategorizer("EventCategorizer", "Online event categorization") {}
+protected:
+  /// only the control histograms are needed online
+  virtual void saveEvents(const vector<JPetEvent>&) override {}
+};
+}
+
+OnlineMonitor::OnlineMonitor(const string& inputFile, JPetParamManager* paramManager,
+                             const JPetTaskInterface::Options& opts):
+  fInputFile(inputFile),
+  fParamManager(paramManager),
+  fOptions(opts)
+{
+  fPollInterval = chrono::milliseconds(static_cast<long long>(getOption("Online_PollInterval", 200.)));
+  fPublishInterval = chrono::milliseconds(static_cast<long long>(getOption("Online_PublishInterval", 2000.)));
+  fIdleTimeout = chrono::seconds(static_cast<long long>(getOption("Online_IdleTimeout", 60.)));
+  fMaxEntriesPerPoll = static_cast<long long>(getOption("Online_MaxEntriesPerPoll", 1000.));
+  if (fMaxEntriesPerPoll < 1) {
+    fMaxEntriesPerPoll = 1;
+  }
+  if (fOptions.count("Online_OutputFile")) {
+    fOutputFile = fOptions.at("Online_OutputFile");
+  }
+  fOptions["inputFile"] = fInputFile;
+  /// the histograms must not be attached to the input file, which is closed and reopened
+  TH1::AddDirectory(false);
+  fStatistics.createHistogram(
+    new TH1F("online_latency",
+             "Time from the arrival of a time window to the update of its histograms [ms]",
+             1000, 0., getOption("Online_MaxLatency", 10000.))
+  );
+}
+
+OnlineMonitor::~OnlineMonitor()
+{
+  fChain.clear();
+  fTree = nullptr;
+  fFile.reset();
+  delete fEvent;
+}
+
+int OnlineMonitor::run()
+{
+  buildChain();
+  std::signal(SIGINT, requestStop);
+  auto lastData = Clock::now();
+  auto lastPublish = Clock::now();
+  while (!gStopRequested) {
+    long long processed = 0;
+    if (fTree || openInput()) {
+      fTree->Refresh();
+      processed = processNewEntries(Clock::now());
+    }
+    auto now = Clock::now();
+    if (processed > 0) {
+      lastData = now;
+    }
+    if (now - lastPublish >= fPublishInterval) {
+      publish();
+      lastPublish = now;
+    }
+    if (processed < fMaxEntriesPerPoll) {
+      if (fIdleTimeout.count() > 0 && now - lastData > fIdleTimeout) {
+        INFO("Online mode: no new data in " + fInputFile + ", stopping");
+        break;
+      }
+      this_thread::sleep_for(fPollInterval);
+    }
+  }
+  terminateChain();
+  publish();
+  INFO("Online mode: " + to_string(fProcessedWindows) + " time windows processed");
+  return 0;
+}
+
+void OnlineMonitor::buildChain()
+{
+  std::unique_ptr<JPetTask> categorizer(new OnlineEventCategorizer());
+  std::unique_ptr<JPetTask> eventFinder(new OnlineEventFinder(categorizer.get(), this));
+  std::unique_ptr<JPetTask> hitFinder(new OnlineHitFinder(eventFinder.get()));
+  std::unique_ptr<JPetTask> transformer(new OnlineSignalTransformer(hitFinder.get()));
+  std::unique_ptr<JPetTask> signalFinder(new OnlineSignalFinder(transformer.get()));
+  std::unique_ptr<JPetTask> calibLoader(new OnlineTimeCalibLoader(signalFinder.get()));
+  std::unique_ptr<JPetTask> windowCreator(new OnlineTimeWindowCreator(calibLoader.get()));
+  fChain.push_back(std::move(windowCreator));
+  fChain.push_back(std::move(calibLoader));
+  fChain.push_back(std::move(signalFinder));
+  fChain.push_back(std::move(transformer));
+  fChain.push_back(std::move(hitFinder));
+  fChain.push_back(std::move(eventFinder));
+  fChain.push_back(std::move(categorizer));
+  for (auto& task : fChain) {
+    task->setStatistics(&fStatistics);
+    task->setParamManager(fParamManager);
+    task->init(fOptions);
+  }
+}
+
+bool OnlineMonitor::openInput()
+{
+  /// the unpacker may not have created the file or written the tree header yet
+  std::unique_ptr<TFile> file(TFile::Open(fInputFile.c_str(), "READ"));
+  if (!file || file->IsZombie()) {
+    return false;
+  }
+  auto tree = dynamic_cast<TTree*>(file->Get("T"));
+  if (!tree) {
+    return false;
+  }
+  tree->SetBranchAddress("event", &fEvent);
+  fFile = std::move(file);
+  fTree = tree;
+  INFO("Online mode: reading " + fInputFile);
+  return true;
+}
+
+long long OnlineMonitor::processNewEntries(Clock::time_point arrivalTime)
+{
+  auto lastEntry = min(fTree->GetEntries(), fNextEntry + fMaxEntriesPerPoll);
+  auto processed = lastEntry - fNextEntry;
+  for (; fNextEntry < lastEntry; fNextEntry++) {
+    fTree->GetEntry(fNextEntry);
+    /// TimeWindowCreator numbers the windows in the order of reading
+    fArrivalTimes[fProcessedWindows] = arrivalTime;
+    fChain.front()->setEvent(fEvent);
+    fChain.front()->exec();
+    fProcessedWindows++;
+  }
+  return processed;
+}
+
+void OnlineMonitor::windowProcessed(long long windowIndex)
+{
+  auto arrival = fArrivalTimes.find(windowIndex);
+  if (arrival == fArrivalTimes.end()) {
+    return;
+  }
+  auto latency = chrono::duration<double, milli>(Clock::now() - arrival->second).count();
+  fStatistics.getHisto1D("online_latency").Fill(latency);
+  /// the windows before this one produced no events
+  fArrivalTimes.erase(fArrivalTimes.begin(), ++arrival);
+}
+
+void OnlineMonitor::publish()
+{
+  auto temporaryFile = fOutputFile + ".tmp";
+  {
+    TFile file(temporaryFile.c_str(), "RECREATE");
+    if (file.IsZombie()) {
+      ERROR("Online mode: cannot write " + temporaryFile);
+      return;
+    }
+    file.cd();
+    fStatistics.getHistogramsTable()->Write();
+    file.Close();
+  }
+  if (std::rename(temporaryFile.c_str(), fOutputFile.c_str()) != 0) {
+    ERROR("Online mode: cannot rename " + temporaryFile + " to " + fOutputFile);
+  }
+}
+
+void OnlineMonitor::terminateChain()
+{
+  for (auto& task : fChain) {
+    task->terminate();
+  }
+}
+
+double OnlineMonitor::getOption(const string& key, double defaultValue) const
+{
+  if (fOptions.count(key)) {
+    return atof(fOptions.at(key).c_str());
+  }
+  return defaultValue;
+}
+
+JPetTaskInterface::Options OnlineMonitor::readUserOptions(const string& fileName)
+{
+  JPetTaskInterface::Options opts;
+  boost::property_tree::ptree tree;
+  try {
+    boost::property_tree::read_json(fileName, tree);
+  } catch (const boost::property_tree::json_parser_error& error) {
+    ERROR("Cannot read user options from " + fileName + ": " + error.what());
+    return opts;
+  }
+  for (const auto& option : tree) {
+    opts[option.first] = option.second.data();
+  }
+  return opts;
+}
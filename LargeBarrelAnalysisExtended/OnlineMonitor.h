@@ -0,0 +1,107 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file OnlineMonitor.h
+ */
+
+#ifndef ONLINEMONITOR_H
+#define ONLINEMONITOR_H
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <JPetTask/JPetTask.h>
+#include <JPetStatistics/JPetStatistics.h>
+
+class JPetParamManager;
+class TFile;
+class TTree;
+class EventIII;
+
+/**
+ * @brief Online mode of the analysis: the full chain of tasks run in memory
+ * on an unpacked file which is still being written by the DAQ.
+ *
+ * The tree "T" of the unpacked file is refreshed every poll interval and every new
+ * entry (time window) is passed through TimeWindowCreator, TimeCalibLoader, SignalFinder,
+ * SignalTransformer, HitFinder, EventFinder and EventCategorizer without writing
+ * any intermediate files. All the tasks fill one common set of histograms, which
+ * is published periodically to the output file. The file is written under
+ * a temporary name and renamed, so a reader never sees an incomplete file.
+ *
+ * The latency is measured for every time window as the time from the poll
+ * which found the window in the input to the moment its events reached EventCategorizer,
+ * and stored in the "online_latency" histogram [ms]. Note that HitFinder and EventFinder
+ * close a time window when the next one arrives, so a window is processed
+ * at the latest one window later. The published histograms are behind by at most
+ * the publish interval.
+ *
+ * User options:
+ * "Online_PollInterval": time between checks of the input for new entries [ms] (default 200)
+ * "Online_PublishInterval": time between writes of the output file [ms] (default 2000)
+ * "Online_MaxEntriesPerPoll": maximal number of entries processed before checking
+ *  whether the histograms should be published (default 1000)
+ * "Online_IdleTimeout": the monitor stops if no new entries appear for this time [s],
+ *  0 means it runs until interrupted (default 60)
+ * "Online_OutputFile": name of the published file (default "online.root")
+ * "Online_MaxLatency": upper limit of the latency histogram [ms] (default 10000)
+ */
+class OnlineMonitor
+{
+public:
+  typedef std::chrono::steady_clock Clock;
+
+  OnlineMonitor(const std::string& inputFile, JPetParamManager* paramManager,
+                const JPetTaskInterface::Options& opts);
+  ~OnlineMonitor();
+  /// Runs until the idle timeout or SIGINT. Returns 0 on success.
+  int run();
+
+  /// Reads a flat json file with the user options.
+  static JPetTaskInterface::Options readUserOptions(const std::string& fileName);
+
+  /// Called by the chain when the events of the given time window reached EventCategorizer.
+  void windowProcessed(long long windowIndex);
+
+private:
+  OnlineMonitor(const OnlineMonitor&);
+  void operator=(const OnlineMonitor&);
+
+  void buildChain();
+  bool openInput();
+  long long processNewEntries(Clock::time_point arrivalTime);
+  void publish();
+  void terminateChain();
+  double getOption(const std::string& key, double defaultValue) const;
+
+  std::string fInputFile;
+  JPetParamManager* fParamManager = nullptr;
+  JPetTaskInterface::Options fOptions;
+  std::string fOutputFile = "online.root";
+  std::chrono::milliseconds fPollInterval;
+  std::chrono::milliseconds fPublishInterval;
+  std::chrono::seconds fIdleTimeout;
+  long long fMaxEntriesPerPoll = 1000;
+
+  JPetStatistics fStatistics;
+  std::vector<std::unique_ptr<JPetTask>> fChain;
+  std::unique_ptr<TFile> fFile;
+  TTree* fTree = nullptr;
+  EventIII* fEvent = nullptr;
+  long long fNextEntry = 0;
+  long long fProcessedWindows = 0;
+  /// arrival time of the windows which have not reached the end of the chain yet
+  std::map<long long, Clock::time_point> fArrivalTimes;
+};
+#endif /*  !ONLINEMONITOR_H */
@@ -0,0 +1,209 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file ParameterSweepTask.cpp
+ */
+
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <JPetWriter/JPetWriter.h>
+#include <TCollection.h>
+#include <TDirectory.h>
+#include <TNamed.h>
+#include <TH1.h>
+#include "ParameterSweepTask.h"
+
+using namespace std;
+
+namespace
+{
+/// Scans with more steps are most likely a typo in the step value
+const std::size_t kMaxScanSize = 1000;
+
+bool expandScan(const string& key, const string& value, ParameterSweepTask::OptionSets& sets)
+{
+  vector<string> limits;
+  boost::split(limits, value, boost::is_any_of(":"));
+  if (limits.size() != 3) {
+    return false;
+  }
+  double first = 0., last = 0., step = 0.;
+  try {
+    first = boost::lexical_cast<double>(limits[0]);
+    last = boost::lexical_cast<double>(limits[1]);
+    step = boost::lexical_cast<double>(limits[2]);
+  } catch (const boost::bad_lexical_cast&) {
+    return false;
+  }
+  if (step <= 0. || last < first || (last - first) / step >= kMaxScanSize) {
+    return false;
+  }
+  /// the number of steps is computed once, so the last point is not lost on rounding
+  auto nSteps = static_cast<std::size_t>((last - first) / step + 1e-9);
+  for (std::size_t i = 0; i <= nSteps; i++) {
+    sets.push_back({{key, boost::lexical_cast<string>(first + i * step)}});
+  }
+  return true;
+}
+}
+
+ParameterSweepTask::ParameterSweepTask(const char* name, const char* description, TaskGenerator generator):
+  JPetTask(name, description),
+  fTaskName(name),
+  fGenerator(generator)
+{
+  /**/
+}
+
+ParameterSweepTask::~ParameterSweepTask() {}
+
+void ParameterSweepTask::init(const JPetTaskInterface::Options& opts)
+{
+  fNominalTask.reset(fGenerator());
+  fNominalTask->setStatistics(&getStatistics());
+  fNominalTask->setParamManager(fParamManager);
+  fNominalTask->setWriter(fWriter);
+  fNominalTask->init(opts);
+
+  auto sweepKey = fTaskName + "_Sweep";
+  if (!opts.count(sweepKey)) {
+    return;
+  }
+  auto sets = parseOptionSets(opts.at(sweepKey));
+  if (!opts.count("outputFile")) {
+    ERROR("No output file given, the parameter sweep of " + fTaskName + " is disabled");
+    return;
+  }
+  auto outputFile = opts.at("outputFile");
+  /// Opening a JPetWriter changes gDirectory under the running task, and the histograms
+  /// of every instance have the same names, so they are kept out of the directories
+  /// (the statistics own them) and renamed only when written.
+  TDirectory* currentDirectory = gDirectory;
+  bool addDirectory = TH1::AddDirectoryStatus();
+  TH1::AddDirectory(false);
+  for (std::size_t i = 0; i < sets.size(); i++) {
+    auto instanceOpts = opts;
+    for (const auto& opt : sets[i]) {
+      instanceOpts[opt.first] = opt.second;
+    }
+    SweepInstance instance;
+    instance.fDescription = describeOptionSet(sets[i]);
+    instance.fTask.reset(fGenerator());
+    instance.fStatistics.reset(new JPetStatistics());
+    instance.fWriter.reset(new JPetWriter(getSweepFileName(outputFile, i).c_str()));
+    currentDirectory->cd();
+    instance.fTask->setStatistics(instance.fStatistics.get());
+    instance.fTask->setParamManager(fParamManager);
+    instance.fTask->setWriter(instance.fWriter.get());
+    instance.fTask->init(instanceOpts);
+    INFO("Parameter sweep of " + fTaskName + ", set " + to_string(i) + ": " + instance.fDescription);
+    fSweepInstances.push_back(std::move(instance));
+  }
+  TH1::AddDirectory(addDirectory);
+}
+
+void ParameterSweepTask::exec()
+{
+  /// all the instances consume the same object, so the input is read only once
+  fNominalTask->setEvent(getEvent());
+  fNominalTask->exec();
+  for (auto& instance : fSweepInstances) {
+    instance.fTask->setEvent(getEvent());
+    instance.fTask->exec();
+  }
+}
+
+void ParameterSweepTask::terminate()
+{
+  fNominalTask->terminate();
+  for (std::size_t i = 0; i < fSweepInstances.size(); i++) {
+    auto& instance = fSweepInstances[i];
+    instance.fTask->terminate();
+    /// the task is done with its histograms, so they can get the set prefix
+    auto prefix = "sweep_" + to_string(i) + "_";
+    TIter next(instance.fStatistics->getHistogramsTable());
+    while (auto histogram = dynamic_cast<TNamed*>(next())) {
+      histogram->SetName((prefix + histogram->GetName()).c_str());
+    }
+    TNamed parameters("SweepParameters", instance.fDescription.c_str());
+    instance.fWriter->writeObject(&parameters, "SweepParameters");
+    instance.fWriter->writeObject(instance.fStatistics->getHistogramsTable(), "Stats");
+    instance.fWriter->closeFile();
+  }
+}
+
+void ParameterSweepTask::setWriter(JPetWriter* writer)
+{
+  fWriter = writer;
+}
+
+void ParameterSweepTask::setParamManager(JPetParamManager* paramManager)
+{
+  JPetTask::setParamManager(paramManager);
+  fParamManager = paramManager;
+}
+
+ParameterSweepTask::OptionSets ParameterSweepTask::parseOptionSets(const string& sweep)
+{
+  OptionSets sets;
+  vector<string> setStrings;
+  boost::split(setStrings, sweep, boost::is_any_of(";"));
+  for (auto& setString : setStrings) {
+    boost::trim(setString);
+    if (setString.empty()) {
+      continue;
+    }
+    vector<string> assignments;
+    boost::split(assignments, setString, boost::is_any_of(","));
+    JPetTaskInterface::Options set;
+    for (auto& assignment : assignments) {
+      auto pos = assignment.find("=");
+      auto key = boost::trim_copy(assignment.substr(0, pos));
+      if (pos == string::npos || key.empty()) {
+        ERROR("Wrong parameter sweep assignment: " + assignment);
+        continue;
+      }
+      set[key] = boost::trim_copy(assignment.substr(pos + 1));
+    }
+    if (set.size() == 1 && set.begin()->second.find(":") != string::npos) {
+      if (!expandScan(set.begin()->first, set.begin()->second, sets)) {
+        ERROR("Wrong parameter sweep scan: " + setString);
+      }
+      continue;
+    }
+    if (!set.empty()) {
+      sets.push_back(set);
+    }
+  }
+  return sets;
+}
+
+string ParameterSweepTask::describeOptionSet(const JPetTaskInterface::Options& set)
+{
+  string description;
+  for (const auto& opt : set) {
+    if (!description.empty()) {
+      description += ",";
+    }
+    description += opt.first + "=" + opt.second;
+  }
+  return description;
+}
+
+string ParameterSweepTask::getSweepFileName(const string& outputFile, std::size_t setNumber) const
+{
+  auto baseName = outputFile;
+  if (boost::algorithm::ends_with(baseName, ".root")) {
+    baseName.erase(baseName.size() - 5);
+  }
+  return baseName + ".sweep_" + to_string(setNumber) + ".root";
+}
@@ -0,0 +1,87 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file ParameterSweepTask.h
+ */
+
+#ifndef PARAMETERSWEEPTASK_H
+#define PARAMETERSWEEPTASK_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <JPetTask/JPetTask.h>
+#include <JPetStatistics/JPetStatistics.h>
+
+class JPetWriter;
+
+#ifdef __CINT__
+//when cint is used instead of compiler, override word is not recognized
+//nevertheless it's needed for checking if the structure of project is correct
+#	define override
+#endif
+
+/**
+ * @brief Task running several instances of another task, each with a different set of options,
+ * over a single pass of the input.
+ *
+ * The nominal instance uses the options from the user file and writes to the regular output
+ * of the stage, so the rest of the chain is not affected.
+ * The sweep is defined by the user option "<taskName>_Sweep", where taskName is the name
+ * given to this task (e.g. "HitFinder_Sweep"). Its value is a list of option sets separated
+ * by ';', each set being a list of key=value assignments separated by ',':
+ * "SignalFinder_EdgeMaxTime=10000,SignalFinder_LeadTrailMaxTime=200000;SignalFinder_EdgeMaxTime=30000"
+ * A set with a single assignment of the form key=first:last:step is expanded into a scan:
+ * "HitFinder_TimeWindowWidth=5000:100000:5000"
+ * Every set overrides the nominal options and gets its own instance of the task,
+ * which consumes the same input objects as the nominal one. The output and the statistics
+ * of the i-th set are written to <outputFile>.sweep_<i>.root, together with
+ * a "SweepParameters" object describing the set. Its histograms are prefixed with "sweep_<i>_".
+ */
+class ParameterSweepTask: public JPetTask
+{
+public:
+  typedef std::function<JPetTask*()> TaskGenerator;
+  typedef std::vector<JPetTaskInterface::Options> OptionSets;
+
+  ParameterSweepTask(const char* name, const char* description, TaskGenerator generator);
+  virtual ~ParameterSweepTask();
+  virtual void init(const JPetTaskInterface::Options& opts) override;
+  virtual void exec() override;
+  virtual void terminate() override;
+  virtual void setWriter(JPetWriter* writer) override;
+  virtual void setParamManager(JPetParamManager* paramManager) override;
+
+  /// Method parses the value of the "<taskName>_Sweep" option into option sets.
+  /// Malformed assignments are skipped with an error.
+  static OptionSets parseOptionSets(const std::string& sweep);
+  /// Method returns a human readable description of the set, e.g. "HitFinder_TimeWindowWidth=5000".
+  static std::string describeOptionSet(const JPetTaskInterface::Options& set);
+
+protected:
+  struct SweepInstance {
+    std::unique_ptr<JPetTask> fTask;
+    std::unique_ptr<JPetStatistics> fStatistics;
+    std::unique_ptr<JPetWriter> fWriter;
+    std::string fDescription;
+  };
+  std::string getSweepFileName(const std::string& outputFile, std::size_t setNumber) const;
+
+  std::string fTaskName;
+  TaskGenerator fGenerator;
+  std::unique_ptr<JPetTask> fNominalTask;
+  std::vector<SweepInstance> fSweepInstances;
+  JPetWriter* fWriter = nullptr;
+  JPetParamManager* fParamManager = nullptr;
+};
+#endif /*  !PARAMETERSWEEPTASK_H */
@@ -0,0 +1,43 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ParameterSweepTask
+#include <boost/test/unit_test.hpp>
+
+#include "ParameterSweepTask.h"
+
+BOOST_AUTO_TEST_SUITE (ParameterSweepTaskSuite)
+
+BOOST_AUTO_TEST_CASE (parseListOfSets)
+{
+  auto sets = ParameterSweepTask::parseOptionSets(
+    "SignalFinder_EdgeMaxTime=10000, SignalFinder_LeadTrailMaxTime=200000;SignalFinder_EdgeMaxTime=30000;"
+  );
+  BOOST_REQUIRE_EQUAL(sets.size(), 2u);
+  BOOST_REQUIRE_EQUAL(sets[0].size(), 2u);
+  BOOST_REQUIRE_EQUAL(sets[0].at("SignalFinder_EdgeMaxTime"), "10000");
+  BOOST_REQUIRE_EQUAL(sets[0].at("SignalFinder_LeadTrailMaxTime"), "200000");
+  BOOST_REQUIRE_EQUAL(sets[1].size(), 1u);
+  BOOST_REQUIRE_EQUAL(sets[1].at("SignalFinder_EdgeMaxTime"), "30000");
+  BOOST_REQUIRE_EQUAL(ParameterSweepTask::describeOptionSet(sets[0]),
+                      "SignalFinder_EdgeMaxTime=10000,SignalFinder_LeadTrailMaxTime=200000");
+}
+
+BOOST_AUTO_TEST_CASE (parseScan)
+{
+  auto sets = ParameterSweepTask::parseOptionSets("HitFinder_TimeWindowWidth=5000:100000:5000");
+  BOOST_REQUIRE_EQUAL(sets.size(), 20u);
+  BOOST_REQUIRE_EQUAL(sets.front().at("HitFinder_TimeWindowWidth"), "5000");
+  BOOST_REQUIRE_EQUAL(sets.back().at("HitFinder_TimeWindowWidth"), "100000");
+}
+
+BOOST_AUTO_TEST_CASE (parseWrongInput)
+{
+  BOOST_REQUIRE(ParameterSweepTask::parseOptionSets("").empty());
+  BOOST_REQUIRE(ParameterSweepTask::parseOptionSets("HitFinder_TimeWindowWidth").empty());
+  BOOST_REQUIRE(ParameterSweepTask::parseOptionSets("HitFinder_TimeWindowWidth=5000:1000:5000").empty());
+  BOOST_REQUIRE(ParameterSweepTask::parseOptionSets("HitFinder_TimeWindowWidth=1:2:0").empty());
+  auto sets = ParameterSweepTask::parseOptionSets("=5;EventFinder_EventTime=7000");
+  BOOST_REQUIRE_EQUAL(sets.size(), 1u);
+  BOOST_REQUIRE_EQUAL(sets[0].at("EventFinder_EventTime"), "7000");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
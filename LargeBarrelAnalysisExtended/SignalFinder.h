@@ -30,6 +30,9 @@ class JPetWriter;
 class SignalFinder: public JPetTask
 {
 public:
+  /// version of the output for the stage cache (see CachedTaskLoader),
+  /// to be increased whenever a change of the task changes its output
+  static const int kVersion = 1;
   SignalFinder(const char* name, const char* description, bool printStats);
   virtual ~SignalFinder();
   virtual void init(const JPetTaskInterface::Options& opts) override;
@@ -40,7 +43,7 @@ public:
 
 protected:
   JPetWriter* fWriter;
-  void saveRawSignals(const std::vector<JPetRawSignal>& sigChVec);
+  virtual void saveRawSignals(const std::vector<JPetRawSignal>& sigChVec);
   const std::string fEdgeMaxTimeParamKey = "SignalFinder_EdgeMaxTime"; 
   const std::string fLeadTrailMaxTimeParamKey = "SignalFinder_LeadTrailMaxTime";
   Float_t kSigChEdgeMaxTime = 20000; //[ps]
@@ -15,6 +15,7 @@
 
 #include "SignalTransformer.h"
 #include "JPetWriter/JPetWriter.h"
+#include "RawSignalView.h"
 
 SignalTransformer::SignalTransformer(const char* name, const char* description):
 	JPetTask(name, description) { }
@@ -48,17 +49,14 @@ JPetRecoSignal SignalTransformer::createRecoSignal(JPetRawSignal& rawSignal)
 
 	//reading threshold times by threshold number
 	//from Leading and Trailing edge
-	std::map<int,double> leadingPoints = rawSignal.getTimesVsThresholdNumber(JPetSigCh::Leading);
-	std::map<int,double> trailingPoints = rawSignal.getTimesVsThresholdNumber(JPetSigCh::Trailing);
+	RawSignalView view(rawSignal);
 
 	//finding TOT for every threshold 1-4
 	std::vector<double> tots;
 	for(int i=1;i<5;i++){
-		auto leadSearch = leadingPoints.find(i);
-		auto trailSearch = trailingPoints.find(i);
-		if (leadSearch != leadingPoints.end()
-			&& trailSearch != trailingPoints.end())
-				tots.push_back(trailSearch->second - leadSearch->second);
+		if (view.hasTime(JPetSigCh::Leading, i)
+			&& view.hasTime(JPetSigCh::Trailing, i))
+				tots.push_back(view.getTime(JPetSigCh::Trailing, i) - view.getTime(JPetSigCh::Leading, i));
 	}
 
 	//setting charge of Reco Signal equal to TOT on first threshold
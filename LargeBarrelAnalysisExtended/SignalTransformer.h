@@ -29,6 +29,9 @@ class SignalTransformer: public JPetTask
 {
 
 public:
+	/// version of the output for the stage cache (see CachedTaskLoader),
+	/// to be increased whenever a change of the task changes its output
+	static const int kVersion = 1;
 	SignalTransformer(const char* name, const char* description);
 	virtual void init(const JPetTaskInterface::Options& opts)override;
 	virtual void exec()override;
@@ -40,7 +43,7 @@ public:
 protected:
 	JPetRecoSignal createRecoSignal(JPetRawSignal& rawSignal);
 	JPetPhysSignal createPhysSignal(JPetRecoSignal& signals);
-	void savePhysSignal( JPetPhysSignal signal);
+	virtual void savePhysSignal( JPetPhysSignal signal);
 	JPetWriter* fWriter;
 };
 #endif /*  !SIGNALTRANSFORMER_H */
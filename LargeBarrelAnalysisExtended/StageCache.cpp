@@ -0,0 +1,186 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file StageCache.cpp
+ */
+
+#include <boost/algorithm/string/predicate.hpp> /// for starts_with
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include "StageCache.h"
+#include "JPetLoggerInclude.h"
+
+const std::vector<std::string> StageCache::kGlobalOptionKeys = {
+  "runId", "firstEvent", "lastEvent", "localDB"
+};
+
+namespace
+{
+const std::uint64_t kFNVPrime = 1099511628211ULL;
+
+inline std::uint64_t fnv1a(const char* data, std::size_t size, std::uint64_t hash)
+{
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= kFNVPrime;
+  }
+  return hash;
+}
+}
+
+std::uint64_t StageCache::hashString(const std::string& input, std::uint64_t seed)
+{
+  /// the terminating zero separates consecutive strings in the hash
+  return fnv1a(input.c_str(), input.size() + 1, seed);
+}
+
+bool StageCache::hashFile(const std::string& fileName, std::uint64_t& outHash, std::uint64_t seed)
+{
+  std::ifstream input(fileName, std::ios::binary);
+  if (!input.is_open()) {
+    return false;
+  }
+  std::vector<char> buffer(1 << 20);
+  auto hash = seed;
+  while (input) {
+    input.read(buffer.data(), buffer.size());
+    hash = fnv1a(buffer.data(), static_cast<std::size_t>(input.gcount()), hash);
+  }
+  outHash = hash;
+  return true;
+}
+
+StageCache::Options StageCache::selectTaskOptions(const Options& opts, const std::string& taskName)
+{
+  Options selected;
+  const auto prefix = taskName + "_";
+  for (const auto& opt : opts) {
+    if (boost::algorithm::starts_with(opt.first, prefix)) {
+      selected.insert(opt);
+    }
+  }
+  for (const auto& key : kGlobalOptionKeys) {
+    if (opts.count(key)) {
+      selected[key] = opts.at(key);
+    }
+  }
+  return selected;
+}
+
+std::string StageCache::generateKey(std::uint64_t inputHash,
+                                    const std::string& taskName,
+                                    int taskVersion,
+                                    const std::string& outFileType,
+                                    const Options& taskOptions,
+                                    const std::vector<std::string>& dependencies)
+{
+  auto hash = hashString(std::to_string(inputHash));
+  hash = hashString(taskName, hash);
+  hash = hashString(std::to_string(taskVersion), hash);
+  hash = hashString(outFileType, hash);
+  /// std::map keeps the options sorted, so the key does not depend on the order in the json file
+  for (const auto& opt : taskOptions) {
+    hash = hashString(opt.first, hash);
+    hash = hashString(opt.second, hash);
+    if (boost::filesystem::is_regular_file(opt.second)) {
+      hashFile(opt.second, hash, hash);
+    }
+  }
+  for (const auto& dependency : dependencies) {
+    hash = hashString(dependency, hash);
+    if (!hashFile(dependency, hash, hash)) {
+      WARNING("Stage cache: dependency " + dependency + " cannot be read, only its name is used in the key");
+    }
+  }
+  char key[17];
+  std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+  return std::string(key);
+}
+
+std::string StageCache::getCachedFileName(const std::string& cacheDir, const std::string& key, const std::string& outFileType)
+{
+  return (boost::filesystem::path(cacheDir) / (key + "." + outFileType + ".root")).string();
+}
+
+namespace
+{
+std::string getStageKeyFileName(const std::string& fileName)
+{
+  return fileName + ".key";
+}
+
+bool getFileStamp(const std::string& fileName, std::uintmax_t& size, std::time_t& time)
+{
+  boost::system::error_code error;
+  size = boost::filesystem::file_size(fileName, error);
+  if (error) {
+    return false;
+  }
+  time = boost::filesystem::last_write_time(fileName, error);
+  return !error;
+}
+}
+
+bool StageCache::writeStageKey(const std::string& fileName, const std::string& key)
+{
+  std::uintmax_t size = 0;
+  std::time_t time = 0;
+  if (!getFileStamp(fileName, size, time)) {
+    return false;
+  }
+  std::ofstream out(getStageKeyFileName(fileName));
+  out << key << " " << size << " " << static_cast<long long>(time) << "\n";
+  return out.good();
+}
+
+bool StageCache::readStageKey(const std::string& fileName, std::string& key)
+{
+  std::ifstream in(getStageKeyFileName(fileName));
+  std::string storedKey;
+  std::uintmax_t storedSize = 0;
+  long long storedTime = 0;
+  if (!(in >> storedKey >> storedSize >> storedTime)) {
+    return false;
+  }
+  std::uintmax_t size = 0;
+  std::time_t time = 0;
+  if (!getFileStamp(fileName, size, time) || size != storedSize || static_cast<long long>(time) != storedTime) {
+    return false;
+  }
+  key = storedKey;
+  return true;
+}
+
+void StageCache::removeStageKey(const std::string& fileName)
+{
+  boost::system::error_code error;
+  boost::filesystem::remove(getStageKeyFileName(fileName), error);
+}
+
+bool StageCache::placeFile(const std::string& source, const std::string& target)
+{
+  boost::system::error_code error;
+  boost::filesystem::remove(target, error);
+  boost::filesystem::create_hard_link(source, target, error);
+  if (!error) {
+    return true;
+  }
+  /// e.g. cache directory on a different file system
+  boost::filesystem::copy_file(source, target, error);
+  if (error) {
+    ERROR("Stage cache: cannot place " + source + " as " + target + ": " + error.message());
+    return false;
+  }
+  return true;
+}
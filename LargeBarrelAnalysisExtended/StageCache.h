@@ -0,0 +1,81 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file StageCache.h
+ *  @brief Set of helper tools to build content-addressed keys for stage outputs.
+ */
+
+#ifndef STAGECACHE_H
+#define STAGECACHE_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/// Output of a stage is fully determined by the content of its input file,
+/// the identity and version of the task, the options the task reads and
+/// the content of any auxiliary files it loads.
+/// The methods below fold all of them into a single key, so that an output
+/// produced once can be reused as long as none of the ingredients changed.
+class StageCache
+{
+public:
+  typedef std::map<std::string, std::string> Options;
+
+  static const std::uint64_t kHashSeed = 14695981039346656037ULL;
+
+  /// Method returns FNV-1a hash of the given string, continued from seed.
+  static std::uint64_t hashString(const std::string& input, std::uint64_t seed = kHashSeed);
+  /// Method returns FNV-1a hash of the file content, continued from seed.
+  /// If the file cannot be read, false is returned and outHash is not changed.
+  static bool hashFile(const std::string& fileName, std::uint64_t& outHash, std::uint64_t seed = kHashSeed);
+
+  /// Method selects the options which influence the output of a task:
+  /// all options prefixed with "<taskName>_" (the convention used by the tasks
+  /// to name their parameters, e.g. SignalFinder_EdgeMaxTime) and the global
+  /// options which change the processed data range or the setup (run number, event range, local DB).
+  static Options selectTaskOptions(const Options& opts, const std::string& taskName);
+
+  /// Method generates the cache key (16 hex digits).
+  /// If an option value is a name of an existing file, its content is hashed as well.
+  /// dependencies contains names of additional files read by the task.
+  /// If any of the dependencies cannot be read, its name only is used.
+  static std::string generateKey(std::uint64_t inputHash,
+                                 const std::string& taskName,
+                                 int taskVersion,
+                                 const std::string& outFileType,
+                                 const Options& taskOptions,
+                                 const std::vector<std::string>& dependencies);
+
+  /// Method returns the location of the cached output for the given key.
+  static std::string getCachedFileName(const std::string& cacheDir, const std::string& key, const std::string& outFileType);
+
+  /// Method stores the key of the stage which produced the file next to it, in "<fileName>.key",
+  /// with the size and modification time of the file. The next stage uses this key
+  /// as its input hash instead of reading the whole file again.
+  static bool writeStageKey(const std::string& fileName, const std::string& key);
+  /// Method returns false if there is no key of the file or the file changed after the key was written.
+  static bool readStageKey(const std::string& fileName, std::string& key);
+  static void removeStageKey(const std::string& fileName);
+
+  /// Method replaces target by a link to source (or by a copy if linking is not possible).
+  /// The target is always removed first, so that a file shared with the cache is never overwritten in place.
+  static bool placeFile(const std::string& source, const std::string& target);
+
+  static const std::vector<std::string> kGlobalOptionKeys;
+
+private:
+  StageCache(const StageCache&);
+  void operator=(const StageCache&);
+};
+#endif /*  !STAGECACHE_H */
@@ -0,0 +1,100 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE StageCache
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "StageCache.h"
+
+BOOST_AUTO_TEST_SUITE (StageCacheSuite)
+
+BOOST_AUTO_TEST_CASE (selectTaskOptions)
+{
+  StageCache::Options opts = {
+    {"SignalFinder_EdgeMaxTime", "20000"},
+    {"SignalFinder_LeadTrailMaxTime", "300000"},
+    {"HitFinder_TimeWindowWidth", "50000"},
+    {"runId", "43"},
+    {"outputFile", "xxx.root"}
+  };
+  auto selected = StageCache::selectTaskOptions(opts, "SignalFinder");
+  BOOST_REQUIRE_EQUAL(selected.size(), 3u);
+  BOOST_REQUIRE(selected.count("SignalFinder_EdgeMaxTime"));
+  BOOST_REQUIRE(selected.count("SignalFinder_LeadTrailMaxTime"));
+  BOOST_REQUIRE(selected.count("runId"));
+  /// Only the full "<taskName>_" prefix counts
+  BOOST_REQUIRE_EQUAL(StageCache::selectTaskOptions(opts, "Signal").size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE (generateKey)
+{
+  StageCache::Options opts = {{"EventFinder_EventTime", "5000"}};
+  std::vector<std::string> noDependencies;
+  auto key = StageCache::generateKey(1234, "EventFinder", 1, "unk.evt", opts, noDependencies);
+  BOOST_REQUIRE_EQUAL(key.size(), 16u);
+  BOOST_REQUIRE_EQUAL(key, StageCache::generateKey(1234, "EventFinder", 1, "unk.evt", opts, noDependencies));
+
+  /// Every ingredient must change the key
+  BOOST_REQUIRE(key != StageCache::generateKey(1235, "EventFinder", 1, "unk.evt", opts, noDependencies));
+  BOOST_REQUIRE(key != StageCache::generateKey(1234, "HitFinder", 1, "unk.evt", opts, noDependencies));
+  BOOST_REQUIRE(key != StageCache::generateKey(1234, "EventFinder", 2, "unk.evt", opts, noDependencies));
+  BOOST_REQUIRE(key != StageCache::generateKey(1234, "EventFinder", 1, "cat.evt", opts, noDependencies));
+  StageCache::Options otherOpts = {{"EventFinder_EventTime", "6000"}};
+  BOOST_REQUIRE(key != StageCache::generateKey(1234, "EventFinder", 1, "unk.evt", otherOpts, noDependencies));
+}
+
+BOOST_AUTO_TEST_CASE (hashFileAndDependencies)
+{
+  const std::string fileName = "stageCacheTest_dependency.txt";
+  {
+    std::ofstream out(fileName);
+    out << "1 2.5 0.1\n";
+  }
+  std::uint64_t hash1 = 0;
+  BOOST_REQUIRE(StageCache::hashFile(fileName, hash1));
+  StageCache::Options opts;
+  auto key1 = StageCache::generateKey(1, "HitFinder", 1, "hits", opts, {fileName});
+  {
+    std::ofstream out(fileName);
+    out << "1 2.6 0.1\n";
+  }
+  std::uint64_t hash2 = 0;
+  BOOST_REQUIRE(StageCache::hashFile(fileName, hash2));
+  BOOST_REQUIRE(hash1 != hash2);
+  BOOST_REQUIRE(key1 != StageCache::generateKey(1, "HitFinder", 1, "hits", opts, {fileName}));
+  boost::filesystem::remove(fileName);
+
+  std::uint64_t unchanged = 7;
+  BOOST_REQUIRE(!StageCache::hashFile("nonexisting_file.root", unchanged));
+  BOOST_REQUIRE_EQUAL(unchanged, 7u);
+}
+
+BOOST_AUTO_TEST_CASE (stageKeys)
+{
+  const std::string fileName = "stageCacheTest_output.root";
+  std::string key;
+  BOOST_REQUIRE(!StageCache::writeStageKey(fileName, "0123456789abcdef"));
+  {
+    std::ofstream out(fileName);
+    out << "output";
+  }
+  BOOST_REQUIRE(!StageCache::readStageKey(fileName, key));
+  BOOST_REQUIRE(StageCache::writeStageKey(fileName, "0123456789abcdef"));
+  BOOST_REQUIRE(StageCache::readStageKey(fileName, key));
+  BOOST_REQUIRE_EQUAL(key, "0123456789abcdef");
+
+  /// a file changed after its key was written has no valid key
+  {
+    std::ofstream out(fileName, std::ios::app);
+    out << " changed";
+  }
+  key.clear();
+  BOOST_REQUIRE(!StageCache::readStageKey(fileName, key));
+  BOOST_REQUIRE(key.empty());
+
+  StageCache::removeStageKey(fileName);
+  BOOST_REQUIRE(!boost::filesystem::exists(fileName + ".key"));
+  boost::filesystem::remove(fileName);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -39,16 +39,42 @@ void TimeCalibLoader::init(const JPetTaskInterface::Options& opts)
   if (fTimeCalibration.empty()) {
     ERROR("Time calibration seems to be empty");
   }
+  if (opts.count(fIntegerTimesParamKey)) {
+    fIntegerTimes = (opts.at(fIntegerTimesParamKey) == "true");
+  }
+  if (opts.count(fPackedInputParamKey)) {
+    fPackedReader.reset(new PackedTimeWindowFile::Reader(opts.at(fPackedInputParamKey)));
+    if (!fPackedReader->isOpen()) {
+      ERROR(Form("Could not read the packed time window file %s", opts.at(fPackedInputParamKey).c_str()));
+      fPackedReader.reset();
+    }
+  }
 }
 
 void TimeCalibLoader::exec()
 {
   if (auto oldTimeWindow = dynamic_cast<const JPetTimeWindow* const>(getEvent())) {
     JPetTimeWindow correctedWindow;
+    if (fPackedReader) {
+      // the signal channels of this window are in the packed file
+      if (fPackedReader->readWindow(oldTimeWindow->getIndex(), fPackedWindow)) {
+        fSkippedSigChs += fPackedWindow.toTimeWindow(fParamManager->getParamBank(), fUnpackedWindow);
+      } else {
+        WARNING(Form("Time window %d not found in the packed time window file", static_cast<int>(oldTimeWindow->getIndex())));
+        fUnpackedWindow = JPetTimeWindow();
+        fUnpackedWindow.setIndex(oldTimeWindow->getIndex());
+      }
+      oldTimeWindow = &fUnpackedWindow;
+    }
     auto newSigChs = oldTimeWindow->getSigChVect();
     for (auto & sigCh : newSigChs) {
       /// Calibration time is ns so we should change it to ps, cause all the time is in ps.
-      sigCh.setValue(sigCh.getValue() - 1000. * TimeCalibTools::getTimeCalibCorrection(fTimeCalibration, sigCh.getTOMBChannel().getChannel()));
+      double correction = TimeCalibTools::getTimeCalibCorrection(fTimeCalibration, sigCh.getTOMBChannel().getChannel());
+      if (fIntegerTimes) {
+        sigCh.setValue(IntegerTime::toPs(IntegerTime::fromPs(sigCh.getValue()) - IntegerTime::fromNs(correction)));
+      } else {
+        sigCh.setValue(sigCh.getValue() - 1000. * correction);
+      }
       correctedWindow.addCh(sigCh);
     }
     correctedWindow.setIndex(oldTimeWindow->getIndex());
@@ -64,6 +90,10 @@ void TimeCalibLoader::saveTimeWindow(const JPetTimeWindow& window)
 
 void TimeCalibLoader::terminate()
 {
+  if (fSkippedSigChs > 0) {
+    WARNING(Form("%d signal channels from the packed time window file were skipped, their DAQ channels are not in the param bank",
+                 static_cast<int>(fSkippedSigChs)));
+  }
 }
 
 void TimeCalibLoader::setWriter(JPetWriter* writer)
@@ -24,6 +24,9 @@
 
 #include <JPetTask/JPetTask.h>
 #include <map>
+#include <memory>
+#include "IntegerTime.h"
+#include "PackedTimeWindowFile.h"
 
 /**
  * @brief module to apply the time calibration in J-PET. It takes
@@ -41,10 +44,21 @@
  * Also, info to log will be sent if DEBUG level is activated.
  * The calibration is applied based on the TOMB identifier.
  *
+ * If the signal channels were written by TimeWindowCreator to a packed time window file
+ * only, its name must be given in the user option "TimeCalibLoader_PackedInput".
+ * The signal channels of each window are then read from this file, and the calibrated
+ * windows are saved with all their parameter objects as usual.
+ *
+ * With "TimeCalibLoader_IntegerTimes": "true" the times and the corrections are rounded
+ * to integer ps before the correction is applied (see IntegerTime.h in CommonTools),
+ * so the calibrated times are integer ps as well.
  */
 class TimeCalibLoader : public JPetTask
 {
 public:
+  /// version of the output for the stage cache (see CachedTaskLoader),
+  /// to be increased whenever a change of the task changes its output
+  static const int kVersion = 1;
   TimeCalibLoader(const char* name, const char* description);
   virtual ~TimeCalibLoader();
   virtual void init(const JPetTaskInterface::Options& opts) override;
@@ -53,11 +67,18 @@ public:
   virtual void setWriter(JPetWriter* writer) override;
   virtual void setParamManager(JPetParamManager* paramManager) override;
 protected:
-  void saveTimeWindow(const JPetTimeWindow& window);
+  virtual void saveTimeWindow(const JPetTimeWindow& window);
 
   const std::string fConfigFileParamKey = "TimeCalibLoader_ConfigFile";  ///Name of the option for which the value would correspond to the time calibration file name.
+  const std::string fPackedInputParamKey = "TimeCalibLoader_PackedInput";
+  const std::string fIntegerTimesParamKey = "TimeCalibLoader_IntegerTimes";
   JPetWriter* fWriter = nullptr;
   JPetParamManager* fParamManager = nullptr;
   std::map<unsigned int, double> fTimeCalibration;
+  std::unique_ptr<PackedTimeWindowFile::Reader> fPackedReader;
+  PackedTimeWindow fPackedWindow;
+  JPetTimeWindow fUnpackedWindow;
+  std::size_t fSkippedSigChs = 0;
+  bool fIntegerTimes = false;
 };
 #endif /*  !TIMECALIBLOADER_H */
@@ -28,6 +28,23 @@ void TimeWindowCreator::init(const JPetTaskInterface::Options& opts)
   if (opts.count(kMinTimeParamKey)) {
     fMinTime = std::atof(opts.at(kMinTimeParamKey).c_str());
   }
+  if (opts.count(kIntegerTimesParamKey)) {
+    fIntegerTimes = (opts.at(kIntegerTimesParamKey) == "true");
+  }
+  if (opts.count(kPackedFileParamKey)) {
+    fPackedWriter.reset(new PackedTimeWindowFile::Writer(opts.at(kPackedFileParamKey)));
+    if (!fPackedWriter->isOpen()) {
+      ERROR(Form("Could not open the packed time window file %s", opts.at(kPackedFileParamKey).c_str()));
+      fPackedWriter.reset();
+    }
+  }
+  if (opts.count(kPackedOnlyParamKey)) {
+    fPackedOnly = (opts.at(kPackedOnlyParamKey) == "true");
+    if (fPackedOnly && !fPackedWriter) {
+      WARNING("No packed time window file is written, the signal channels are kept in the ROOT output");
+      fPackedOnly = false;
+    }
+  }
   getStatistics().createHistogram( new TH1F("HitsPerEvtCh", "Hits per channel in one event", 50, -0.5, 49.5) );
   getStatistics().createHistogram( new TH1F("ChannelsPerEvt", "Channels fired in one event", 200, -0.5, 199.5) );
 }
@@ -44,6 +61,8 @@ void TimeWindowCreator::exec()
     getStatistics().getHisto1D("ChannelsPerEvt").Fill( ntdc );
     JPetTimeWindow tslot;
     tslot.setIndex(fCurrEventNumber);
+    fPackedWindow.clear();
+    fPackedWindow.setIndex(fCurrEventNumber);
     auto tdcHits = evt->GetTDCChannelsArray();
     for (int i = 0; i < ntdc; ++i) {
       //const is commented because this class has inproper architecture:
@@ -74,22 +93,50 @@ void TimeWindowCreator::exec()
         if ( tdcChannel->GetTrailTime(j) > fMaxTime ||
              tdcChannel->GetTrailTime(j) < fMinTime )continue;
 
+        // times in ps [raw times are in ns]
+        double lead_time = tdcChannel->GetLeadTime(j) * 1000.;
+        double trail_time = tdcChannel->GetTrailTime(j) * 1000.;
+        if (fIntegerTimes) {
+          lead_time = IntegerTime::toPs(IntegerTime::fromNs(tdcChannel->GetLeadTime(j)));
+          trail_time = IntegerTime::toPs(IntegerTime::fromNs(tdcChannel->GetTrailTime(j)));
+        }
+
+        if (fPackedWriter) {
+          // only the DAQ channel number is kept, the parameter objects are found by it when needed
+          int thr_number = tomb_channel.getLocalChannelNumber();
+          fPackedWindow.add(tomb_number, JPetSigCh::Leading, thr_number, lead_time);
+          fPackedWindow.add(tomb_number, JPetSigCh::Trailing, thr_number, trail_time);
+          if (fPackedOnly) {
+            continue;
+          }
+        }
+
         JPetSigCh sigChTmpLead = generateSigCh(tomb_channel, JPetSigCh::Leading);
         JPetSigCh sigChTmpTrail = generateSigCh(tomb_channel, JPetSigCh::Trailing);
 
-        // finally, set the times in ps [raw times are in ns]
-        sigChTmpLead.setValue(tdcChannel->GetLeadTime(j) * 1000.);
-        sigChTmpTrail.setValue(tdcChannel->GetTrailTime(j) * 1000.);
+        // finally, set the times
+        sigChTmpLead.setValue(lead_time);
+        sigChTmpTrail.setValue(trail_time);
         tslot.addCh(sigChTmpLead);
         tslot.addCh(sigChTmpTrail);
       }
     }
     saveTimeWindow(tslot);
+    if (fPackedWriter) {
+      fPackedWriter->write(fPackedWindow);
+    }
     fCurrEventNumber++;
   }
 }
 
-void TimeWindowCreator::terminate() {}
+void TimeWindowCreator::terminate()
+{
+  if (fPackedWriter) {
+    if (fPackedWriter->close()) {
+      INFO(Form("%d time windows written to the packed time window file", static_cast<int>(fPackedWriter->getWindowCount())));
+    }
+  }
+}
 
 void TimeWindowCreator::saveTimeWindow(const JPetTimeWindow& slot)
 {
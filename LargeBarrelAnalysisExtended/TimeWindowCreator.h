@@ -21,6 +21,9 @@
 #include <JPetParamBank/JPetParamBank.h>
 #include <JPetParamManager/JPetParamManager.h>
 #include <JPetTOMBChannel/JPetTOMBChannel.h>
+#include <memory>
+#include "IntegerTime.h"
+#include "PackedTimeWindowFile.h"
 
 class JPetWriter;
 
@@ -32,10 +35,22 @@ class JPetWriter;
 
 /// Task to translate EventIII Unpacker data to JPetTimeWindow.
 /// Also, some basic filtering can be done
+///
+/// With the user option "TimeWindowCreator_PackedFile" set to a file name, the windows
+/// are also written to this file as PackedTimeWindows (see CommonTools), 16 bytes per
+/// signal channel. With "TimeWindowCreator_PackedOnly": "true" the windows in the ROOT
+/// output keep only their indices, and the signal channels are read from the packed file
+/// by the next task (see "TimeCalibLoader_PackedInput").
+///
+/// With "TimeWindowCreator_IntegerTimes": "true" the times of the signal channels
+/// are rounded to integer ps (see IntegerTime.h in CommonTools).
 
 class TimeWindowCreator: public JPetTask
 {
 public:
+  /// version of the output for the stage cache (see CachedTaskLoader),
+  /// to be increased whenever a change of the task changes its output
+  static const int kVersion = 2;
   TimeWindowCreator(const char* name, const char* description);
   virtual ~TimeWindowCreator();
   virtual void init(const JPetTaskInterface::Options& opts) override;
@@ -46,15 +61,22 @@ public:
   const JPetParamBank& getParamBank() const;
 
 protected:
-  void saveTimeWindow(const JPetTimeWindow& slot);
+  virtual void saveTimeWindow(const JPetTimeWindow& slot);
   JPetSigCh generateSigCh(const JPetTOMBChannel& channel, JPetSigCh::EdgeType edge) const;
   JPetWriter* fWriter = nullptr;
   JPetParamManager* fParamManager = nullptr;
   long long int fCurrEventNumber = 0;
   const std::string kMaxTimeParamKey = "TimeWindowCreator_MaxTime";
   const std::string kMinTimeParamKey = "TimeWindowCreator_MinTime";
+  const std::string kPackedFileParamKey = "TimeWindowCreator_PackedFile";
+  const std::string kPackedOnlyParamKey = "TimeWindowCreator_PackedOnly";
+  const std::string kIntegerTimesParamKey = "TimeWindowCreator_IntegerTimes";
   double fMaxTime = 0.;
   double fMinTime = -1.e6;
+  std::unique_ptr<PackedTimeWindowFile::Writer> fPackedWriter;
+  PackedTimeWindow fPackedWindow;
+  bool fPackedOnly = false;
+  bool fIntegerTimes = false;
 };
 
 #endif /*  !TimeWindowCreator_H */
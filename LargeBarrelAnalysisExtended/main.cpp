@@ -13,9 +13,14 @@
  *  @file main.cpp
  */
 
+#include <TROOT.h>
 #include <DBHandler/HeaderFiles/DBHandler.h>
 #include <JPetManager/JPetManager.h>
 #include <JPetTaskLoader/JPetTaskLoader.h>
+#include <JPetParamManager/JPetParamManager.h>
+#include <JPetParamGetterAscii/JPetParamGetterAscii.h>
+#include "CachedTaskLoader.h"
+#include "ParameterSweepTask.h"
 #include "TimeWindowCreator.h"
 #include "TimeCalibLoader.h"
 #include "SignalFinder.h"
@@ -23,86 +28,136 @@
 #include "HitFinder.h"
 #include "EventFinder.h"
 #include "EventCategorizer.h"
+#include "OnlineMonitor.h"
 
 using namespace std;
 
 int main(int argc, char* argv[])
 {
+  //EventFinder can process the time windows in threads (see WindowBatchTask.h),
+  //so ROOT must be made thread-safe before any ROOT object exists
+  ROOT::EnableThreadSafety();
 
   //Connection to the remote database disabled for the moment
   //DB::SERVICES::DBHandler::createDBConnection("../DBConfig/configDB.cfg");
 
+  //Online mode, see OnlineMonitor.h:
+  //LargeBarrelAnalysisExtended.x --online <unpacked ROOT file being written> <setup json> <runId> [<user options json>]
+  if (argc > 1 && string(argv[1]) == "--online") {
+    if (argc < 5) {
+      cerr << "Usage: " << argv[0] << " --online <unpacked file> <setup json> <runId> [<user options json>]" << endl;
+      return 1;
+    }
+    JPetParamManager paramManager(new JPetParamGetterAscii(argv[3]));
+    paramManager.fillParameterBank(atoi(argv[4]));
+    auto opts = (argc > 5) ? OnlineMonitor::readUserOptions(argv[5]) : JPetTaskInterface::Options();
+    opts["runId"] = argv[4];
+    OnlineMonitor monitor(argv[2], &paramManager, opts);
+    return monitor.run();
+  }
+
   JPetManager& manager = JPetManager::getManager();
   manager.parseCmdLine(argc, argv);
 
+  //Every stage is run through CachedTaskLoader, so the stages whose input
+  //and options did not change since the previous run are skipped
+  //(see CachedTaskLoader.h for the StageCache_* user options)
+  //SignalFinder, HitFinder and EventFinder can be run with several sets of options
+  //in one pass over their input (see ParameterSweepTask.h for the *_Sweep user options)
+
   //First task - unpacking
   manager.registerTask([]() {
-    return new JPetTaskLoader("hld", "tslot.raw",
+    return new CachedTaskLoader("hld", "tslot.raw",
       new TimeWindowCreator(
         "TimeWindowCreator",
         "Process unpacked HLD file into a tree of JPetTimeWindow objects"
-      )
+      ),
+      "TimeWindowCreator", TimeWindowCreator::kVersion, {}, {"TimeWindowCreator_PackedFile"}
     );
   });
 
   //Second task - Signal Channel calibration
   manager.registerTask([]() {
-    return new JPetTaskLoader("tslot.raw", "tslot.calib",
+    return new CachedTaskLoader("tslot.raw", "tslot.calib",
       new TimeCalibLoader(
         "TimeCalibLoader",
         "Apply time corrections from prepared calibrations"
-      )
+      ),
+      "TimeCalibLoader", TimeCalibLoader::kVersion, {"timeCalib.txt"}
     );
   });
 
   //Third task - Raw Signal Creation
   manager.registerTask([]() {
-    return new JPetTaskLoader("tslot.calib", "raw.sig",
-      new SignalFinder(
+    return new CachedTaskLoader("tslot.calib", "raw.sig",
+      new ParameterSweepTask(
         "SignalFinder",
-        "Create Raw Signals, optional - draw control histograms",
-        true
-      )
+        "Parameter sweep of SignalFinder",
+        []() {
+          return new SignalFinder(
+            "SignalFinder",
+            "Create Raw Signals, optional - draw control histograms",
+            true
+          );
+        }
+      ),
+      "SignalFinder", SignalFinder::kVersion
     );
   });
 
   ////Fourth task - Reco & Phys signal creation
   manager.registerTask([]() {
-    return new JPetTaskLoader("raw.sig", "phys.sig",
+    return new CachedTaskLoader("raw.sig", "phys.sig",
       new SignalTransformer(
         "SignalTransformer",
         "Create Reco & Phys Signals"
-      )
+      ),
+      "SignalTransformer", SignalTransformer::kVersion
     );
   });
 
   ////Fifth task - Hit construction
   manager.registerTask([]() {
-    return new JPetTaskLoader("phys.sig", "hits",
-      new HitFinder(
+    return new CachedTaskLoader("phys.sig", "hits",
+      new ParameterSweepTask(
         "HitFinder",
-        "Create hits from physical signals"
-      )
+        "Parameter sweep of HitFinder",
+        []() {
+          return new HitFinder(
+            "HitFinder",
+            "Create hits from physical signals"
+          );
+        }
+      ),
+      "HitFinder", HitFinder::kVersion, {"resultsForThresholda.txt"}
     );
   });
 
   ////Sixth task - unknown Event construction
   manager.registerTask([]() {
-    return new JPetTaskLoader("hits", "unk.evt",
-      new EventFinder(
+    return new CachedTaskLoader("hits", "unk.evt",
+      new ParameterSweepTask(
         "EventFinder",
-        "Create Events as group of Hits"
-      )
+        "Parameter sweep of EventFinder",
+        []() {
+          return new EventFinder(
+            "EventFinder",
+            "Create Events as group of Hits"
+          );
+        }
+      ),
+      "EventFinder", EventFinder::kVersion
     );
   });
 
   //Seventh task - Event Categorization
   manager.registerTask([]() {
-    return new JPetTaskLoader("unk.evt", "cat.evt",
+    return new CachedTaskLoader("unk.evt", "cat.evt",
       new EventCategorizer(
         "EventCategorizer",
         "Categorize Events"
-      )
+      ),
+      "EventCategorizer", EventCategorizer::kVersion
     );
   });
 
@@ -0,0 +1,205 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file FanOutTask.cpp
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <boost/filesystem.hpp>
+#include <JPetParamManager/JPetParamManager.h>
+#include <JPetReader/JPetReader.h>
+#include <JPetTreeHeader/JPetTreeHeader.h>
+#include <JPetWriter/JPetWriter.h>
+#include <TaskOptions.h>
+#include "FanOutTask.h"
+
+/// Thread executing one branch on the copies of the input objects
+class FanOutTask::BranchWorker
+{
+public:
+  BranchWorker(JPetTask* task, std::size_t capacity):
+    fTask(task),
+    fCapacity(capacity),
+    fThread(&BranchWorker::run, this)
+  {
+    /**/
+  }
+
+  /// Blocks while the queue is full. The worker takes the ownership of the object.
+  void push(TObject* object)
+  {
+    std::unique_lock<std::mutex> lock(fMutex);
+    fNotFull.wait(lock, [this]() {
+      return fQueue.size() < fCapacity;
+    });
+    fQueue.push_back(object);
+    fNotEmpty.notify_one();
+  }
+
+  /// Processes the remaining objects and stops the thread
+  void finish()
+  {
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fFinished = true;
+    }
+    fNotEmpty.notify_one();
+    fThread.join();
+  }
+
+private:
+  void run()
+  {
+    while (true) {
+      TObject* object = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(fMutex);
+        fNotEmpty.wait(lock, [this]() {
+          return !fQueue.empty() || fFinished;
+        });
+        if (fQueue.empty()) {
+          return;
+        }
+        object = fQueue.front();
+        fQueue.pop_front();
+        fNotFull.notify_one();
+      }
+      fTask->setEvent(object);
+      fTask->exec();
+      delete object;
+    }
+  }
+
+  JPetTask* fTask;
+  std::size_t fCapacity;
+  std::deque<TObject*> fQueue;
+  bool fFinished = false;
+  std::mutex fMutex;
+  std::condition_variable fNotEmpty;
+  std::condition_variable fNotFull;
+  /// declared last, so the thread starts when all the other members are ready
+  std::thread fThread;
+};
+
+FanOutTask::FanOutTask(const char* name, const char* description, const std::vector<Branch>& branches):
+  JPetTask(name, description),
+  fTaskName(name)
+{
+  for (const auto& branch : branches) {
+    BranchInstance instance;
+    instance.fTask.reset(branch.fTask);
+    instance.fOutFileType = branch.fOutFileType;
+    fBranches.push_back(std::move(instance));
+  }
+}
+
+FanOutTask::~FanOutTask() {}
+
+void FanOutTask::init(const JPetTaskInterface::Options& opts)
+{
+  /// by default every additional branch has its own thread
+  std::size_t threads = fBranches.empty() ? 0 : fBranches.size() - 1;
+  TaskOptions::read(opts, fTaskName + "_Threads", threads);
+  std::size_t queueSize = 1000;
+  TaskOptions::read(opts, fTaskName + "_QueueSize", queueSize);
+  queueSize = std::max<std::size_t>(1, queueSize);
+  /// the header of the input is repeated in the outputs of the branches, as JPetTaskIO does
+  if (fBranches.size() > 1) {
+    JPetReader reader;
+    if (reader.openFileAndLoadData(opts.at("inputFile").c_str())) {
+      fHeader.reset(reader.getHeaderClone());
+    }
+  }
+  for (std::size_t i = 0; i < fBranches.size(); i++) {
+    auto& branch = fBranches[i];
+    branch.fTask->setParamManager(fParamManager);
+    if (i == 0) {
+      branch.fTask->setStatistics(&getStatistics());
+      branch.fTask->setWriter(fWriter);
+    } else {
+      branch.fStatistics.reset(new JPetStatistics());
+      branch.fWriter.reset(new JPetWriter(getBranchFileName(opts, branch.fOutFileType).c_str()));
+      branch.fTask->setStatistics(branch.fStatistics.get());
+      branch.fTask->setWriter(branch.fWriter.get());
+    }
+    branch.fTask->init(opts);
+    if (i > 0 && i <= threads) {
+      branch.fWorker.reset(new BranchWorker(branch.fTask.get(), queueSize));
+    }
+  }
+}
+
+void FanOutTask::exec()
+{
+  for (std::size_t i = 1; i < fBranches.size(); i++) {
+    auto& branch = fBranches[i];
+    if (branch.fWorker) {
+      branch.fWorker->push(getEvent()->Clone());
+    } else {
+      branch.fTask->setEvent(getEvent());
+      branch.fTask->exec();
+    }
+  }
+  if (!fBranches.empty()) {
+    fBranches.front().fTask->setEvent(getEvent());
+    fBranches.front().fTask->exec();
+  }
+}
+
+void FanOutTask::terminate()
+{
+  for (std::size_t i = 0; i < fBranches.size(); i++) {
+    auto& branch = fBranches[i];
+    if (branch.fWorker) {
+      branch.fWorker->finish();
+      branch.fWorker.reset();
+    }
+    branch.fTask->terminate();
+    if (i > 0) {
+      /// the same content as written by JPetTaskIO, so the file can be the input of another stage
+      if (fHeader) {
+        branch.fWriter->writeHeader(fHeader.get());
+      }
+      branch.fWriter->writeObject(branch.fStatistics->getHistogramsTable(), "Stats");
+      fParamManager->saveParametersToFile(branch.fWriter.get());
+      branch.fWriter->closeFile();
+    }
+  }
+}
+
+void FanOutTask::setWriter(JPetWriter* writer)
+{
+  fWriter = writer;
+}
+
+void FanOutTask::setParamManager(JPetParamManager* paramManager)
+{
+  JPetTask::setParamManager(paramManager);
+  fParamManager = paramManager;
+}
+
+/// The same naming scheme as used by JPetTaskLoader:
+/// everything after the first dot of the file name is replaced by the file type.
+std::string FanOutTask::getBranchFileName(const JPetTaskInterface::Options& opts, const std::string& fileType) const
+{
+  auto inputFile = boost::filesystem::path(opts.at("inputFile"));
+  auto baseName = inputFile.filename().string();
+  auto pos = baseName.find(".");
+  if (pos != std::string::npos) {
+    baseName.erase(pos);
+  }
+  return (inputFile.parent_path() / (baseName + "." + fileType + ".root")).string();
+}
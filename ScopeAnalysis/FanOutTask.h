@@ -0,0 +1,86 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file FanOutTask.h
+ */
+
+#ifndef FANOUTTASK_H
+#define FANOUTTASK_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <JPetTask/JPetTask.h>
+#include <JPetStatistics/JPetStatistics.h>
+
+class JPetWriter;
+class JPetTreeHeader;
+
+#ifdef __CINT__
+//when cint is used instead of compiler, override word is not recognized
+//nevertheless it's needed for checking if the structure of project is correct
+#	define override
+#endif
+
+/**
+ * @brief Task passing every input object to several consumer tasks (branches),
+ * so an input file read by many tasks is read and decoded only once.
+ *
+ * The first branch is the main one: it uses the writer and the statistics of the loader,
+ * so its output is the output of the stage and the next tasks of the chain read it.
+ * Every other branch gets its own output file <input base name>.<outFileType>.root
+ * with its own histograms, and with the header and the parameters of the input,
+ * so it can be the input of another stage.
+ *
+ * The user option "<taskName>_Threads" is the number of threads, as for WindowBatchTask
+ * (see CommonTools); by default every additional branch has one. The first that many
+ * additional branches run in their own threads, receiving copies of the input objects
+ * through queues of at most "<taskName>_QueueSize" objects (default 1000). The other
+ * branches, and always the main one, run in the thread of the loader. init() and terminate() of all the branches are always
+ * called from the thread of the loader. ROOT::EnableThreadSafety() must be called
+ * in main(), before any task is created.
+ */
+class FanOutTask: public JPetTask
+{
+public:
+  struct Branch {
+    JPetTask* fTask;
+    std::string fOutFileType;
+  };
+
+  /// FanOutTask takes the ownership of the tasks of the branches
+  FanOutTask(const char* name, const char* description, const std::vector<Branch>& branches);
+  virtual ~FanOutTask();
+  virtual void init(const JPetTaskInterface::Options& opts) override;
+  virtual void exec() override;
+  virtual void terminate() override;
+  virtual void setWriter(JPetWriter* writer) override;
+  virtual void setParamManager(JPetParamManager* paramManager) override;
+
+protected:
+  class BranchWorker;
+  struct BranchInstance {
+    std::unique_ptr<JPetTask> fTask;
+    std::string fOutFileType;
+    std::unique_ptr<JPetStatistics> fStatistics;
+    std::unique_ptr<JPetWriter> fWriter;
+    std::unique_ptr<BranchWorker> fWorker;
+  };
+  std::string getBranchFileName(const JPetTaskInterface::Options& opts, const std::string& fileType) const;
+
+  std::string fTaskName;
+  std::vector<BranchInstance> fBranches;
+  std::unique_ptr<JPetTreeHeader> fHeader;
+  JPetWriter* fWriter = nullptr;
+  JPetParamManager* fParamManager = nullptr;
+};
+#endif /*  !FANOUTTASK_H */
@@ -0,0 +1,144 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file SDARecoSignalCalc.cpp
+ */
+
+#include <JPetWriter/JPetWriter.h>
+#include <JPetRecoSignalTools/JPetRecoSignalTools.h>
+#include "SDARecoSignalCalc.h"
+
+SDARecoSignalCalc::SDARecoSignalCalc(const char* name, const char* description):
+  JPetTask(name, description) {}
+
+SDARecoSignalCalc::~SDARecoSignalCalc() {}
+
+void SDARecoSignalCalc::init(const JPetTaskInterface::Options& opts)
+{
+  if (opts.count(fWaveformFileParamKey)) {
+    fWaveformReader.reset(new WaveformFile::Reader(opts.at(fWaveformFileParamKey)));
+    if (!fWaveformReader->isOpen()) {
+      ERROR("Cannot read the waveform file " + opts.at(fWaveformFileParamKey));
+      fWaveformReader.reset();
+    }
+  }
+  fCurrentEventNumber = 0;
+  fBadOffsets = 0;
+  fBadCharges = 0;
+  fBadAmplitudes = 0;
+  fMissingWaveforms = 0;
+  fMismatchedWaveforms = 0;
+}
+
+void SDARecoSignalCalc::exec()
+{
+  if (auto inputSignal = dynamic_cast<const JPetRecoSignal* const>(getEvent())) {
+    JPetRecoSignal signal = *inputSignal;
+    if (fWaveformReader) {
+      calculateFromWaveformFile(signal);
+    } else {
+      calculateWithTools(signal);
+    }
+    saveRecoSignal(signal);
+    fCurrentEventNumber++;
+  }
+}
+
+void SDARecoSignalCalc::calculateWithTools(JPetRecoSignal& signal)
+{
+  const double offset = JPetRecoSignalTools::calculateOffset(signal);
+  if (offset == JPetRecoSignalTools::ERRORS::badOffset) {
+    WARNING("Problem with calculating offset.");
+    fBadOffsets++;
+  }
+  signal.setOffset(offset);
+
+  /// charge and amplitude are calculated with respect to the offset set above
+  const double charge = JPetRecoSignalTools::calculateAreaFromStartingIndex(signal);
+  if (charge == JPetRecoSignalTools::ERRORS::badCharge) {
+    WARNING("Problem with calculating charge.");
+    fBadCharges++;
+  }
+  signal.setCharge(charge);
+
+  const double amplitude = JPetRecoSignalTools::calculateAmplitude(signal);
+  if (amplitude == JPetRecoSignalTools::ERRORS::badAmplitude) {
+    WARNING("Problem with calculating amplitude.");
+    fBadAmplitudes++;
+  }
+  signal.setAmplitude(amplitude);
+}
+
+void SDARecoSignalCalc::calculateFromWaveformFile(JPetRecoSignal& signal)
+{
+  WaveformFile::WaveformView waveform;
+  if (!fWaveformReader->next(waveform)) {
+    WARNING("No waveform left in the waveform file for the signal.");
+    fMissingWaveforms++;
+    setBadSignal(signal);
+    return;
+  }
+  if (waveform.fEvent != static_cast<std::uint64_t>(signal.getTimeWindowIndex())
+      || waveform.fPMID != signal.getPM().getID()) {
+    WARNING(Form("Waveform of event %llu and PM %d assigned to the signal of event %d and PM %d.",
+                 static_cast<unsigned long long>(waveform.fEvent), waveform.fPMID,
+                 int(signal.getTimeWindowIndex()), signal.getPM().getID()));
+    fMismatchedWaveforms++;
+    setBadSignal(signal);
+    return;
+  }
+  for (std::size_t i = 0; i < waveform.fSize; i++) {
+    signal.setShapePoint(shapePoint(waveform.getTime(i), waveform.getAmplitude(i)));
+  }
+  calculateWithTools(signal);
+}
+
+void SDARecoSignalCalc::setBadSignal(JPetRecoSignal& signal)
+{
+  fBadOffsets++;
+  fBadCharges++;
+  fBadAmplitudes++;
+  signal.setOffset(JPetRecoSignalTools::ERRORS::badOffset);
+  signal.setCharge(JPetRecoSignalTools::ERRORS::badCharge);
+  signal.setAmplitude(JPetRecoSignalTools::ERRORS::badAmplitude);
+}
+
+void SDARecoSignalCalc::terminate()
+{
+  if (fWaveformReader) {
+    WaveformFile::WaveformView waveform;
+    int extraWaveforms = 0;
+    while (fWaveformReader->next(waveform)) {
+      extraWaveforms++;
+    }
+    if (fMissingWaveforms > 0 || fMismatchedWaveforms > 0 || extraWaveforms > 0) {
+      ERROR(Form("The waveform file does not match the input: %d signals without waveform, "
+                 "%d signals with the waveform of another event or PM, %d waveforms without signal",
+                 fMissingWaveforms, fMismatchedWaveforms, extraWaveforms));
+    }
+    fWaveformReader.reset();
+  }
+  INFO(Form("Calculation of offsets, charges and amplitudes completed.\n%d signals were analyzed.\n"
+            "Bad offsets: %d, bad charges: %d, bad amplitudes: %d",
+            fCurrentEventNumber, fBadOffsets, fBadCharges, fBadAmplitudes));
+}
+
+void SDARecoSignalCalc::saveRecoSignal(const JPetRecoSignal& signal)
+{
+  assert(fWriter);
+  fWriter->write(signal);
+}
+
+void SDARecoSignalCalc::setWriter(JPetWriter* writer)
+{
+  fWriter = writer;
+}
@@ -0,0 +1,75 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file SDARecoSignalCalc.h
+ */
+
+#ifndef SDARECOSIGNALCALC_H
+#define SDARECOSIGNALCALC_H
+
+#include <memory>
+#include <JPetTask/JPetTask.h>
+#include <JPetRecoSignal/JPetRecoSignal.h>
+#include <WaveformFile.h>
+
+class JPetWriter;
+
+#ifdef __CINT__
+//when cint is used instead of compiler, override word is not recognized
+//nevertheless it's needed for checking if the structure of project is correct
+#	define override
+#endif
+
+/**
+ * @brief Task calculating offset, charge and amplitude of the signals from SDA in one pass.
+ *
+ * It replaces the chain SDARecoOffsetsCalc -> SDARecoChargeCalc -> SDARecoAmplitudeCalc
+ * and gives the same results: the quantities are calculated with JPetRecoSignalTools
+ * in the same order, so the charge and the amplitude use the offset set in the first step.
+ * Signals for which a quantity cannot be calculated are counted and written anyway,
+ * as in the separate tasks.
+ *
+ * With the user option "RecoSignalCalc_WaveformFile" set to a compact waveform file
+ * (see WaveformFile.h), written by ScopeReaderExample --fast-loader --compact, the samples
+ * of the i-th input signal are the i-th waveform of the file; the input signals carry only
+ * the photomultipliers and the events. The samples are added to the output signals for
+ * the next tasks. A waveform recorded for another event or photomultiplier than its signal
+ * is not used: the signal is counted as mismatched and written as a bad one.
+ */
+class SDARecoSignalCalc: public JPetTask
+{
+public:
+  SDARecoSignalCalc(const char* name, const char* description);
+  virtual ~SDARecoSignalCalc();
+  virtual void init(const JPetTaskInterface::Options& opts) override;
+  virtual void exec() override;
+  virtual void terminate() override;
+  virtual void setWriter(JPetWriter* writer) override;
+
+protected:
+  void saveRecoSignal(const JPetRecoSignal& signal);
+  void calculateWithTools(JPetRecoSignal& signal);
+  void calculateFromWaveformFile(JPetRecoSignal& signal);
+  void setBadSignal(JPetRecoSignal& signal);
+
+  const std::string fWaveformFileParamKey = "RecoSignalCalc_WaveformFile";
+  std::unique_ptr<WaveformFile::Reader> fWaveformReader;
+
+  JPetWriter* fWriter = nullptr;
+  int fCurrentEventNumber = 0;
+  int fBadOffsets = 0;
+  int fBadCharges = 0;
+  int fBadAmplitudes = 0;
+  int fMissingWaveforms = 0;
+  int fMismatchedWaveforms = 0;
+};
+#endif /*  !SDARECOSIGNALCALC_H */
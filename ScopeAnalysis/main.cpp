@@ -13,52 +13,51 @@
  *  @file main.cpp
  */
 
+#include <TROOT.h>
 #include <DBHandler/HeaderFiles/DBHandler.h>
 #include <JPetManager/JPetManager.h>
 #include <JPetTaskLoader/JPetTaskLoader.h>
-#include <modules/JPetRecoOffsetCalc/SDARecoOffsetsCalc.h>
-#include <modules/JPetRecoChargeCalc/SDARecoChargeCalc.h>
-#include <modules/JPetRecoAmplitudeCalc/SDARecoAmplitudeCalc.h>
 #include <modules/JPetRecoDrawAllCharges/SDARecoDrawAllCharges.h>
 #include <modules/JPetMakePhysSignal/SDAMakePhysSignals.h>
 #include <modules/JPetMatchHits/SDAMatchHits.h>
 #include <modules/JPetMatchLORs/SDAMatchLORs.h>
+#include "SDARecoSignalCalc.h"
+#include "FanOutTask.h"
 
 using namespace std;
+
 int main(int argc, char* argv[])
 {
+  // FanOutTask runs its branches in threads, so ROOT must be made thread-safe
+  // before any ROOT object exists
+  ROOT::EnableThreadSafety();
 	DB::SERVICES::DBHandler::createDBConnection("../DBConfig/configDB.cfg");
   JPetManager& manager = JPetManager::getManager();
   manager.parseCmdLine(argc, argv);
 
+  // offsets, charges and amplitudes calculated in one pass,
+  // equivalent to SDARecoOffsetsCalc -> SDARecoChargeCalc -> SDARecoAmplitudeCalc
   manager.registerTask([](){
-      return new JPetTaskLoader("reco.sig", "reco.sig.offsets",
-				new SDARecoOffsetsCalc("RecoSigOffsetsCalc",
-							"Calculate offsets for signals from SDA"));
-    });
-
-  manager.registerTask([](){
-      return new JPetTaskLoader("reco.sig.offsets", "reco.sig.offsets.charges",
-  				new SDARecoChargeCalc("RecoSigChargeCalc",
-  							"Calculate charges for signals from SDA"));
-    });
-
-  manager.registerTask([](){
-      return new JPetTaskLoader("reco.sig.offsets.charges", "reco.sig.offsets.charges.ampl",
-  				new SDARecoAmplitudeCalc("RecoSigAmplitudeCalc",
-						      "Calculate amplitides for signals from SDA"));
-    });
-  
-  manager.registerTask([](){
-      return new JPetTaskLoader("reco.sig.offsets.charges.ampl", "reco.sig.offsets.charges.ampl.draw",
-  				new SDARecoDrawAllCharges("RecoDrawAllCharges",
-							 "Draw the charge spaectra for each photomultiplier"));
+      return new JPetTaskLoader("reco.sig", "reco.sig.offsets.charges.ampl",
+				new SDARecoSignalCalc("RecoSignalCalc",
+						      "Calculate offsets, charges and amplitudes for signals from SDA"));
     });
   
+  // the reco signals are read once and passed both to SDAMakePhysSignals,
+  // whose output goes further down the chain, and to SDARecoDrawAllCharges,
+  // which writes reco.sig.offsets.charges.ampl.draw in its own thread
   manager.registerTask([](){
       return new JPetTaskLoader("reco.sig.offsets.charges.ampl", "phys.sig",
-  				new SDAMakePhysSignals("MakePhysSig",
-  						       "Transform reco signals to physical signals"));
+				new FanOutTask("RecoSigFanOut",
+					       "Make physical signals and draw the charge spectra in one pass",
+					       {
+						 {new SDAMakePhysSignals("MakePhysSig",
+									 "Transform reco signals to physical signals"),
+						  "phys.sig"},
+						 {new SDARecoDrawAllCharges("RecoDrawAllCharges",
+									    "Draw the charge spaectra for each photomultiplier"),
+						  "reco.sig.offsets.charges.ampl.draw"}
+					       }));
     });
 
     manager.registerTask([](){
@@ -0,0 +1,267 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file ScopeAsciiLoader.cpp
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <locale>
+#include <sstream>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <boost/filesystem.hpp>
+#include "ScopeAsciiLoader.h"
+
+namespace
+{
+const double kSecondsToPs = 1.e12;
+const double kVoltsToMV = 1.e3;
+
+/// Powers of ten exactly representable as double
+const double kPowersOf10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+const int kMaxExactPower = 22;
+/// Mantissas with at most this number of digits are exact as double
+const int kMaxExactDigits = 15;
+const int kMaxMantissaDigits = 19;
+
+inline bool isDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+inline bool isSeparator(char c)
+{
+  return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r';
+}
+
+/// Slow but exact conversion, independent of the global locale
+bool parseWithStream(const char* begin, const char* end, double& value)
+{
+  std::istringstream stream(std::string(begin, end));
+  stream.imbue(std::locale::classic());
+  stream >> value;
+  return !stream.fail();
+}
+
+/// Files are parsed in batches, so the memory used does not depend on the number of files
+const std::size_t kFilesPerThreadInBatch = 16;
+
+struct Batch {
+  std::size_t fStart = 0;
+  std::size_t fSize = 0;
+  std::vector<ScopeAsciiLoader::Waveform> fWaveforms;
+  std::vector<char> fOk;
+};
+
+void parseBatch(const std::vector<std::string>& fileNames, unsigned int nThreads, Batch& batch)
+{
+  std::atomic<std::size_t> next(0);
+  auto work = [&]() {
+    for (auto i = next++; i < batch.fSize; i = next++) {
+      batch.fWaveforms[i].clear();
+      batch.fOk[i] = ScopeAsciiLoader::loadFile(fileNames[batch.fStart + i], batch.fWaveforms[i]);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < nThreads; i++) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+}
+
+ScopeAsciiLoader::ScopeAsciiLoader(unsigned int nThreads):
+  fNThreads(nThreads)
+{
+  if (fNThreads == 0) {
+    fNThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+}
+
+void ScopeAsciiLoader::load(const std::vector<std::string>& fileNames, const Consumer& consumer) const
+{
+  const std::size_t batchSize = fNThreads * kFilesPerThreadInBatch;
+  Batch current, next;
+  current.fWaveforms.resize(batchSize);
+  current.fOk.resize(batchSize);
+  next.fWaveforms.resize(batchSize);
+  next.fOk.resize(batchSize);
+  current.fSize = std::min(batchSize, fileNames.size());
+  parseBatch(fileNames, fNThreads, current);
+  while (current.fSize > 0) {
+    /// the next batch is parsed while the current one is consumed
+    next.fStart = current.fStart + current.fSize;
+    next.fSize = std::min(batchSize, fileNames.size() - next.fStart);
+    std::thread producer;
+    if (next.fSize > 0) {
+      producer = std::thread(parseBatch, std::cref(fileNames), fNThreads, std::ref(next));
+    }
+    for (std::size_t i = 0; i < current.fSize; i++) {
+      auto index = current.fStart + i;
+      consumer(index, fileNames[index], current.fWaveforms[i], current.fOk[i]);
+    }
+    if (producer.joinable()) {
+      producer.join();
+    }
+    std::swap(current, next);
+  }
+}
+
+std::vector<std::string> ScopeAsciiLoader::listFiles(const std::string& directory)
+{
+  std::vector<std::string> files;
+  boost::system::error_code error;
+  for (boost::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+    if (boost::filesystem::is_regular_file(it->path())) {
+      files.push_back(it->path().string());
+    }
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+bool ScopeAsciiLoader::loadFile(const std::string& fileName, Waveform& waveform)
+{
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat status;
+  if (fstat(fd, &status) != 0) {
+    close(fd);
+    return false;
+  }
+  if (status.st_size == 0) {
+    close(fd);
+    return true;
+  }
+  const std::size_t size = status.st_size;
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    /// e.g. a file system which does not support mapping
+    std::ifstream input(fileName, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    if (!input.good() && !input.eof()) {
+      return false;
+    }
+    parse(content.data(), content.data() + content.size(), waveform);
+    return true;
+  }
+  madvise(data, size, MADV_SEQUENTIAL);
+  const char* begin = static_cast<const char*>(data);
+  parse(begin, begin + size, waveform);
+  munmap(data, size);
+  return true;
+}
+
+void ScopeAsciiLoader::parse(const char* begin, const char* end, Waveform& waveform)
+{
+  const char* line = begin;
+  while (line < end) {
+    const char* lineEnd = std::find(line, end, '\n');
+    const char* pos = line;
+    while (pos < lineEnd && isSeparator(*pos)) {
+      pos++;
+    }
+    double time = 0., amplitude = 0.;
+    const char* afterTime = parseDouble(pos, lineEnd, time);
+    if (afterTime != pos) {
+      pos = afterTime;
+      while (pos < lineEnd && isSeparator(*pos)) {
+        pos++;
+      }
+      if (parseDouble(pos, lineEnd, amplitude) != pos) {
+        waveform.push_back({time * kSecondsToPs, amplitude * kVoltsToMV});
+      }
+    }
+    line = lineEnd + 1;
+  }
+}
+
+const char* ScopeAsciiLoader::parseDouble(const char* begin, const char* end, double& value)
+{
+  const char* pos = begin;
+  bool negative = false;
+  if (pos < end && (*pos == '-' || *pos == '+')) {
+    negative = (*pos == '-');
+    pos++;
+  }
+  std::uint64_t mantissa = 0;
+  int digits = 0;
+  int exponent = 0;
+  bool anyDigit = false;
+  for (; pos < end && isDigit(*pos); pos++) {
+    anyDigit = true;
+    if (digits < kMaxMantissaDigits) {
+      mantissa = mantissa * 10 + (*pos - '0');
+      digits += (mantissa != 0);
+    } else {
+      exponent++;
+    }
+  }
+  if (pos < end && *pos == '.') {
+    pos++;
+    for (; pos < end && isDigit(*pos); pos++) {
+      anyDigit = true;
+      if (digits < kMaxMantissaDigits) {
+        mantissa = mantissa * 10 + (*pos - '0');
+        digits += (mantissa != 0);
+        exponent--;
+      }
+    }
+  }
+  if (!anyDigit) {
+    return begin;
+  }
+  if (pos < end && (*pos == 'e' || *pos == 'E')) {
+    const char* exponentPos = pos + 1;
+    bool negativeExponent = false;
+    if (exponentPos < end && (*exponentPos == '-' || *exponentPos == '+')) {
+      negativeExponent = (*exponentPos == '-');
+      exponentPos++;
+    }
+    if (exponentPos < end && isDigit(*exponentPos)) {
+      int explicitExponent = 0;
+      for (; exponentPos < end && isDigit(*exponentPos); exponentPos++) {
+        if (explicitExponent < 10000) {
+          explicitExponent = explicitExponent * 10 + (*exponentPos - '0');
+        }
+      }
+      exponent += negativeExponent ? -explicitExponent : explicitExponent;
+      pos = exponentPos;
+    }
+  }
+  if (digits <= kMaxExactDigits && exponent >= -kMaxExactPower && exponent <= kMaxExactPower) {
+    /// both the mantissa and the power of ten are exact, so a single rounding gives the correct result
+    double result = static_cast<double>(mantissa);
+    result = exponent < 0 ? result / kPowersOf10[-exponent] : result * kPowersOf10[exponent];
+    value = negative ? -result : result;
+    return pos;
+  }
+  if (!parseWithStream(begin, pos, value)) {
+    return begin;
+  }
+  return pos;
+}
@@ -0,0 +1,64 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file ScopeAsciiLoader.h
+ */
+
+#ifndef SCOPEASCIILOADER_H
+#define SCOPEASCIILOADER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Fast loader of the oscilloscope ASCII dumps.
+ *
+ * Every file is memory mapped and parsed with a locale-independent number parser.
+ * The header lines (any line which does not start with a number) are skipped,
+ * the remaining lines contain the time [s] and the amplitude [V] of the samples,
+ * separated by white spaces or a comma. The samples are converted to ps and mV,
+ * as done by the scope reader of the framework.
+ *
+ * The files are parsed in parallel by a pool of threads, but the waveforms
+ * are passed to the consumer in the order of the list of files.
+ */
+class ScopeAsciiLoader
+{
+public:
+  struct Sample {
+    double time; /// [ps]
+    double amplitude; /// [mV]
+  };
+  typedef std::vector<Sample> Waveform;
+  /// Called for every file in the order of the input list; ok is false if the file cannot be read
+  typedef std::function<void(std::size_t fileIndex, const std::string& fileName, const Waveform& waveform, bool ok)> Consumer;
+
+  /// nThreads = 0 means the number of hardware threads
+  explicit ScopeAsciiLoader(unsigned int nThreads = 0);
+
+  void load(const std::vector<std::string>& fileNames, const Consumer& consumer) const;
+
+  /// Returns the sorted list of the regular files in the directory
+  static std::vector<std::string> listFiles(const std::string& directory);
+  static bool loadFile(const std::string& fileName, Waveform& waveform);
+  /// Parses the content of a dump, appending the samples to the waveform
+  static void parse(const char* begin, const char* end, Waveform& waveform);
+  /// Parses a number starting at begin; on success sets value and returns the position after the number,
+  /// otherwise returns begin
+  static const char* parseDouble(const char* begin, const char* end, double& value);
+
+private:
+  unsigned int fNThreads;
+};
+#endif /*  !SCOPEASCIILOADER_H */
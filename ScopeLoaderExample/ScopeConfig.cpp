@@ -0,0 +1,153 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file ScopeConfig.cpp
+ */
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <JPetParamBank/JPetParamBank.h>
+#include "JPetLoggerInclude.h"
+#include "ScopeAsciiLoader.h"
+#include "ScopeConfig.h"
+
+namespace
+{
+bool isNumber(const std::string& token)
+{
+  return !token.empty() && token.find_first_not_of("0123456789") == std::string::npos;
+}
+
+/// Number after the name of the object, e.g. 3 for PM0003
+bool parseID(const std::string& token, const std::string& name, int& id)
+{
+  if (!boost::algorithm::starts_with(token, name) || !isNumber(token.substr(name.size()))) {
+    return false;
+  }
+  id = std::stoi(token.substr(name.size()));
+  return true;
+}
+}
+
+bool ScopeConfig::read(const std::string& fileName)
+{
+  std::ifstream file(fileName);
+  if (!file) {
+    ERROR("Cannot open the config file " + fileName);
+    return false;
+  }
+  fPMs.clear();
+  fScins.clear();
+  fDataDirectory.clear();
+  fPositions.clear();
+  std::string line;
+  while (std::getline(file, line)) {
+    auto comment = line.find("//");
+    if (comment != std::string::npos) {
+      line.erase(comment);
+    }
+    std::vector<std::string> tokens;
+    std::istringstream stream(line);
+    for (std::string token; stream >> token;) {
+      tokens.push_back(token);
+    }
+    if (tokens.empty()) {
+      continue;
+    }
+    int id = 0;
+    if (tokens.size() == 2 && parseID(tokens[0], "PM", id)) {
+      fPMs.push_back({id, tokens[1]});
+    } else if (tokens.size() == 1 && parseID(tokens[0], "SCINT", id)) {
+      fScins.push_back(id);
+    } else if (tokens.size() <= 3 && isNumber(tokens[0])
+               && (tokens.size() < 2 || isNumber(tokens[1])) && (tokens.size() < 3 || isNumber(tokens[2]))) {
+      int first = std::stoi(tokens[0]);
+      int last = (tokens.size() > 1) ? std::stoi(tokens[1]) : first;
+      int step = (tokens.size() > 2) ? std::stoi(tokens[2]) : 1;
+      if (step <= 0) {
+        ERROR("Wrong collimator positions: " + line);
+        return false;
+      }
+      for (int position = first; position <= last; position += step) {
+        fPositions.push_back(position);
+      }
+    } else if (tokens.size() == 1 && fDataDirectory.empty()) {
+      fDataDirectory = tokens[0];
+    } else {
+      ERROR("Wrong line in the config file " + fileName + ": " + line);
+      return false;
+    }
+  }
+  if (fPMs.empty() || fDataDirectory.empty() || fPositions.empty()) {
+    ERROR("No photomultipliers, data directory or collimator positions in " + fileName);
+    return false;
+  }
+  if (fScins.size() * 2 < fPMs.size()) {
+    ERROR("Every pair of photomultipliers needs a scintillator in " + fileName);
+    return false;
+  }
+  auto dataDirectory = boost::filesystem::path(fDataDirectory);
+  if (dataDirectory.is_relative()) {
+    fDataDirectory = (boost::filesystem::path(fileName).parent_path() / dataDirectory).string();
+  }
+  return true;
+}
+
+void ScopeConfig::fillParamBank(JPetParamBank& paramBank) const
+{
+  for (auto scinID : fScins) {
+    JPetScin scin(scinID);
+    paramBank.addScintillator(scin);
+  }
+  for (std::size_t i = 0; i < fPMs.size(); i++) {
+    JPetPM pm(fPMs[i].fID);
+    pm.setSide(i % 2 == 0 ? JPetPM::SideA : JPetPM::SideB);
+    pm.setScin(paramBank.getScintillator(fScins[i / 2]));
+    paramBank.addPM(pm);
+  }
+}
+
+std::vector<ScopeConfig::File> ScopeConfig::listFiles(int position, std::size_t& nSkipped) const
+{
+  auto directory = boost::filesystem::path(fDataDirectory) / std::to_string(position);
+  /// name after the prefix -> file of every photomultiplier
+  std::map<std::string, std::map<std::size_t, std::string>> events;
+  nSkipped = 0;
+  for (const auto& path : ScopeAsciiLoader::listFiles(directory.string())) {
+    auto name = boost::filesystem::path(path).filename().string();
+    /// the longest prefix wins, so C1 does not take the files of C10
+    std::size_t pm = fPMs.size();
+    for (std::size_t i = 0; i < fPMs.size(); i++) {
+      if (boost::algorithm::starts_with(name, fPMs[i].fPrefix)
+          && (pm == fPMs.size() || fPMs[i].fPrefix.size() > fPMs[pm].fPrefix.size())) {
+        pm = i;
+      }
+    }
+    if (pm == fPMs.size()) {
+      nSkipped++;
+      continue;
+    }
+    events[name.substr(fPMs[pm].fPrefix.size())][pm] = path;
+  }
+  std::vector<File> files;
+  std::size_t event = 0;
+  for (const auto& eventFiles : events) {
+    for (const auto& pmFile : eventFiles.second) {
+      files.push_back({pmFile.second, fPMs[pmFile.first].fID, event});
+    }
+    event++;
+  }
+  return files;
+}
@@ -0,0 +1,79 @@
+/**
+ *  @copyright Copyright 2017 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file ScopeConfig.h
+ */
+
+#ifndef SCOPECONFIG_H
+#define SCOPECONFIG_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class JPetParamBank;
+
+/**
+ * @brief Scope measurement described by a .cfg file (see README): the photomultipliers
+ * with the prefixes of their files, the scintillators, the data directory and
+ * the collimator positions.
+ *
+ * The photomultipliers are attached to the scintillators in pairs, in the order
+ * of the file: the first two (sides A and B) to the first scintillator and so on.
+ * The files of a collimator position are in <data directory>/<position>;
+ * the data directory is relative to the directory of the .cfg file.
+ */
+class ScopeConfig
+{
+public:
+  struct PM {
+    int fID;
+    std::string fPrefix;
+  };
+  /// Oscilloscope file with its photomultiplier and event
+  struct File {
+    std::string fName;
+    int fPMID;
+    std::size_t fEvent;
+  };
+
+  /// Reads the .cfg file; returns false with an error if it is incomplete
+  bool read(const std::string& fileName);
+  /// Fills the param bank with the photomultipliers and scintillators
+  void fillParamBank(JPetParamBank& paramBank) const;
+  /// Files of the collimator position, grouped into events: the files of all
+  /// the photomultipliers with the same name after the prefix form one event.
+  /// The events are numbered in the order of these names, the files of one event
+  /// are in the order of the photomultipliers. The files with an unknown prefix
+  /// are counted in nSkipped.
+  std::vector<File> listFiles(int position, std::size_t& nSkipped) const;
+
+  const std::vector<PM>& getPMs() const
+  {
+    return fPMs;
+  }
+  const std::vector<int>& getScins() const
+  {
+    return fScins;
+  }
+  const std::vector<int>& getPositions() const
+  {
+    return fPositions;
+  }
+
+private:
+  std::vector<PM> fPMs;
+  std::vector<int> fScins;
+  std::string fDataDirectory;
+  std::vector<int> fPositions;
+};
+#endif /*  !SCOPECONFIG_H */
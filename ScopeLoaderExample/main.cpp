@@ -13,13 +13,119 @@
  *  @file main.cpp
  */
 
+#include <memory>
 #include <TString.h>
 #include <DBHandler/HeaderFiles/DBHandler.h>
 #include <JPetManager/JPetManager.h>
+#include <JPetParamBank/JPetParamBank.h>
+#include <JPetRecoSignal/JPetRecoSignal.h>
+#include <JPetTreeHeader/JPetTreeHeader.h>
+#include <JPetWriter/JPetWriter.h>
+#include <WaveformFile.h>
+#include "ScopeAsciiLoader.h"
+#include "ScopeConfig.h"
 
 using namespace std;
+
+/// Converts the oscilloscope dumps of one collimator position into JPetRecoSignals
+/// assigned to the photomultipliers of the config, with the event number as the time
+/// window index, and writes them with the header and the param bank, so the file
+/// is the reco.sig input of ScopeAnalysis. In the compact mode the samples are written
+/// to <file base>.wfm (see WaveformFile.h) and the signals keep only the photomultiplier
+/// and the event; ScopeAnalysis must then read the samples with RecoSignalCalc_WaveformFile.
+int convertPosition(const ScopeConfig& config, int position, const string& outputPrefix,
+                    bool compact, const ScopeAsciiLoader& loader)
+{
+  size_t nSkipped = 0;
+  auto files = config.listFiles(position, nSkipped);
+  if (nSkipped > 0) {
+    WARNING(Form("%d files of position %d do not belong to any photomultiplier", int(nSkipped), position));
+  }
+  if (files.empty()) {
+    ERROR(Form("No oscilloscope files found for position %d", position));
+    return 1;
+  }
+  vector<string> fileNames;
+  for (const auto& file : files) {
+    fileNames.push_back(file.fName);
+  }
+  auto outputBase = outputPrefix + "_" + to_string(position);
+  JPetParamBank paramBank;
+  config.fillParamBank(paramBank);
+  JPetWriter writer((outputBase + ".reco.sig.root").c_str());
+  std::unique_ptr<WaveformFile::Writer> compactWriter;
+  if (compact) {
+    compactWriter.reset(new WaveformFile::Writer(outputBase + ".wfm"));
+    if (!compactWriter->isOpen()) {
+      ERROR("Cannot open the waveform file " + outputBase + ".wfm");
+      return 1;
+    }
+  }
+  vector<double> times, amplitudes;
+  int badFiles = 0;
+  loader.load(fileNames, [&](size_t fileIndex, const string & fileName, const ScopeAsciiLoader::Waveform & waveform, bool ok) {
+    if (!ok) {
+      WARNING("Cannot read " + fileName);
+      badFiles++;
+      return;
+    }
+    JPetRecoSignal signal;
+    signal.setPM(paramBank.getPM(files[fileIndex].fPMID));
+    signal.setTimeWindowIndex(files[fileIndex].fEvent);
+    if (compact) {
+      times.resize(waveform.size());
+      amplitudes.resize(waveform.size());
+      for (size_t i = 0; i < waveform.size(); i++) {
+        times[i] = waveform[i].time;
+        amplitudes[i] = waveform[i].amplitude;
+      }
+      compactWriter->add(files[fileIndex].fEvent, files[fileIndex].fPMID, times.data(), amplitudes.data(), waveform.size());
+    } else {
+      for (const auto& sample : waveform) {
+        signal.setShapePoint(shapePoint(sample.time, sample.amplitude));
+      }
+    }
+    writer.write(signal);
+  });
+  JPetTreeHeader header;
+  writer.writeHeader(&header);
+  writer.writeObject(&paramBank, "ParamBank");
+  writer.closeFile();
+  if (compact && !compactWriter->close()) {
+    return 1;
+  }
+  INFO(Form("Position %d: %d oscilloscope files converted, %d could not be read",
+            position, int(files.size()) - badFiles, badFiles));
+  return 0;
+}
+
+int runFastLoader(const string& configFile, const string& outputPrefix, bool compact, unsigned int nThreads)
+{
+  ScopeConfig config;
+  if (!config.read(configFile)) {
+    return 1;
+  }
+  ScopeAsciiLoader loader(nThreads);
+  int result = 0;
+  for (auto position : config.getPositions()) {
+    result |= convertPosition(config, position, outputPrefix, compact, loader);
+  }
+  return result;
+}
+
 int main(int argc, char* argv[])
 {
+  //Fast conversion, the samples optionally in a compact waveform file:
+  //ScopeReaderExample.x --fast-loader [--compact] <config file> <output prefix> [<number of threads>]
+  if (argc > 1 && string(argv[1]) == "--fast-loader") {
+    const bool compact = (argc > 2 && string(argv[2]) == "--compact");
+    const int first = compact ? 3 : 2;
+    if (argc < first + 2) {
+      cerr << "Usage: " << argv[0] << " --fast-loader [--compact] <config file> <output prefix> [<number of threads>]" << endl;
+      return 1;
+    }
+    return runFastLoader(argv[first], argv[first + 1], compact, (argc > first + 2) ? atoi(argv[first + 2]) : 0);
+  }
 	DB::SERVICES::DBHandler::createDBConnection("../DBConfig/configDB.cfg");
   JPetManager& manager = JPetManager::getManager();
   manager.parseCmdLine(argc, argv);